@@ -0,0 +1,8 @@
+#! /usr/bin/env python3
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/scratch/wifi_exp/ns3.35-wifi_exp-debug', 'build/scratch/subdir/ns3.35-subdir-debug', 'build/scratch/ns3.35-scratch-simulator-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
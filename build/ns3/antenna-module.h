@@ -0,0 +1,18 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_ANTENNA
+    
+
+// Module headers:
+#include "angles.h"
+#include "antenna-model.h"
+#include "cosine-antenna-model.h"
+#include "isotropic-antenna-model.h"
+#include "parabolic-antenna-model.h"
+#include "phased-array-model.h"
+#include "three-gpp-antenna-model.h"
+#include "uniform-planar-array.h"
+#endif
@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005,2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef DEFAULT_SIMULATOR_IMPL_H
+#define DEFAULT_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+#include "scheduler-trace.h"
+#include "event-profiler.h"
+
+#include "ptr.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::DefaultSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * The default single process simulator implementation.
+ */
+class DefaultSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  DefaultSimulatorImpl ();
+  /** Destructor. */
+  ~DefaultSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** Process the next event. */
+  void ProcessOneEvent (void);
+  /** Move events from a different context into the main event queue. */
+  void ProcessEventsWithContext (void);
+
+  /** Wrap an event with its execution context. */
+  struct EventWithContext
+  {
+    /** The event context. */
+    uint32_t context;
+    /** Event timestamp. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /**
+   * Slot of the queue of events from a different context.
+   *
+   * The queue is a bounded multiple producer, single consumer ring.
+   * A thread reserves the slot at m_eventsWithContextTail when its
+   * sequence equals that position, fills it and publishes it by setting
+   * the sequence to the position plus one.  The main thread takes the
+   * published slots in order and frees each for the next lap by setting
+   * its sequence to the position plus CONTEXT_QUEUE_SIZE.
+   */
+  struct EventSlot
+  {
+    /** Position the slot is free or published for, see above. */
+    std::atomic<uint64_t> sequence;
+    /** The event. */
+    EventWithContext event;
+  };
+  /** Slots in the ring, a power of two. */
+  static const uint64_t CONTEXT_QUEUE_SIZE = 1024;
+  /** The ring of events from a different context. */
+  std::unique_ptr<EventSlot[]> m_eventsWithContextRing;
+  /** Next ring position reserved by the other threads. */
+  std::atomic<uint64_t> m_eventsWithContextTail;
+  /** Next ring position taken by the main thread. */
+  uint64_t m_eventsWithContextHead;
+
+  /** Container type for the events from a different context. */
+  typedef std::vector<struct EventWithContext> EventsWithContext;
+  /** The events which did not fit in the ring. */
+  EventsWithContext m_eventsWithContext;
+  /** Events moved out of m_eventsWithContext, kept for its capacity. */
+  EventsWithContext m_eventsWithContextDrain;
+  /**
+   * Flag \c true if m_eventsWithContext holds events.  The other threads
+   * then append there too, to keep the order of their events, until the
+   * main thread takes them.
+   */
+  std::atomic<bool> m_eventsWithContextOverflow;
+  /** Mutex to control access to m_eventsWithContext. */
+  SystemMutex m_eventsWithContextMutex;
+
+  /**
+   * Record the operations on the event list to a file, see SchedulerTrace.
+   * \param [in] filename The file, empty to stop recording.
+   */
+  void SetTraceFile (std::string filename);
+  /** Records the operations on the event list, null if not recording. */
+  std::unique_ptr<SchedulerTraceWriter> m_trace;
+
+  /**
+   * Profile the CPU time of the events to a file, see EventProfiler.
+   * \param [in] filename The file, empty to stop profiling.
+   */
+  void SetProfileFile (std::string filename);
+  /** Times the events, null if not profiling. */
+  std::unique_ptr<EventProfiler> m_profiler;
+
+  /**
+   * Insert an event from a different context in the event queue.
+   * \param [in] event The event, relative to the current time.
+   */
+  void InsertEventWithContext (const EventWithContext &event);
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Flag calling for the end of the simulation. */
+  bool m_stop;
+  /** The event priority queue. */
+  Ptr<Scheduler> m_events;
+
+  /** Next event unique id. */
+  uint32_t m_uid;
+  /** Unique id of the current event. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current event. */
+  uint64_t m_currentTs;
+  /** Execution context of the current event. */
+  uint32_t m_currentContext;
+  /** The event count. */
+  uint64_t m_eventCount;
+  /**
+   * Number of events that have been inserted but not yet scheduled,
+   *  not counting the Destroy events; this is used for validation
+   */
+  int m_unscheduledEvents;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+};
+
+} // namespace ns3
+
+#endif /* DEFAULT_SIMULATOR_IMPL_H */
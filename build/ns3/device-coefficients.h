@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef DEVICE_COEFFICIENTS_H
+#define DEVICE_COEFFICIENTS_H
+
+#include <stdint.h>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief Registry of the fitted device and application coefficients used by
+ * PerformanceSimpleModel, AppPowerModel and TemperatureSimpleModel.
+ *
+ * The registry starts with the built-in calibrations. On first use it then loads
+ * the file named by the "DeviceCoefficientsFile" global value, if one is set.
+ * Rows from the file add devices and applications, or replace built-in ones.
+ * The file is CSV, blank lines and lines starting with '#' are skipped:
+ *
+ *   device,<name>,<idle W>,<power|energy>,<thermal A>,<thermal B>,<thermal C>,<thermal D>
+ *   app,<device>,<app>,<time A>,<time B>,<time C>,<time divisor>,<power A>,<power B>,<power C>
+ *
+ * For a data size d the execution time is max (0.1, A d^2 / 10^6 + B d / divisor + C).
+ * The power fit is A d^2 / 10^6 + B d / 1000 + C. It gives the power directly for
+ * "power" devices and the energy of one run for "energy" devices. An app row with
+ * an empty device gives the device independent power fit used by
+ * AppPowerModel::SetAppName.
+ *
+ * Lookups return an index that stays valid for the whole run.
+ */
+class DeviceCoefficients
+{
+public:
+  /**
+   * \brief Coefficients of one device
+   */
+  struct Device
+  {
+    double idlePowerW;            //!< Idle CPU power
+    bool powerFit;                //!< The application fit gives power rather than energy
+    double thermalA;              //!< TemperatureSimpleModel coefficient on the environment temperature
+    double thermalB;              //!< TemperatureSimpleModel coefficient on the previous temperature
+    double thermalC;              //!< TemperatureSimpleModel coefficient on the CPU power
+    double thermalD;              //!< TemperatureSimpleModel constant term
+  };
+
+  /**
+   * \brief Coefficients of one application on one device
+   */
+  struct Application
+  {
+    double timeA;                 //!< Execution time, quadratic term
+    double timeB;                 //!< Execution time, linear term
+    double timeC;                 //!< Execution time, constant term
+    double timeDivisor;           //!< Scale of the linear term of the execution time
+    double powerA;                //!< Power or energy, quadratic term
+    double powerB;                //!< Power or energy, linear term
+    double powerC;                //!< Power or energy, constant term
+    uint32_t device;              //!< Index of the device, NONE for the device independent fits
+  };
+
+  static const uint32_t NONE = UINT32_MAX; //!< Returned when a lookup finds nothing
+
+  /**
+   * \param device Device type
+   * \return Index of the device, NONE if it is unknown
+   */
+  static uint32_t FindDevice (const std::string &device);
+
+  /**
+   * \param device   Device type, empty for the device independent fits
+   * \param app      Application name
+   * \return Index of the application, NONE if it is unknown for this device
+   */
+  static uint32_t FindApplication (const std::string &device, const std::string &app);
+
+  static const Device &GetDevice (uint32_t idx);
+  static const Application &GetApplication (uint32_t idx);
+
+  /**
+   * \brief Add a device, or replace the coefficients of a known one
+   * \return Index of the device
+   */
+  static uint32_t AddDevice (const std::string &device, const Device &coefficients);
+
+  /**
+   * \brief Add an application, or replace the coefficients of a known one
+   *
+   * The device must already be registered, unless it is empty.
+   * \return Index of the application
+   */
+  static uint32_t AddApplication (const std::string &device, const std::string &app,
+                                  const Application &coefficients);
+
+  /**
+   * \brief Add the rows of a coefficient file, see the class description for the format
+   * \param path File to read, aborts if it cannot be read or is malformed
+   */
+  static void Load (const std::string &path);
+
+  /**
+   * \param app       Application index
+   * \param dataSize  Input data size
+   * \return Execution time in seconds
+   */
+  static double ExecTime (uint32_t app, double dataSize);
+
+  /**
+   * \param app       Application index
+   * \param dataSize  Input data size
+   * \return Output of the power fit, the power or the energy depending on the device
+   */
+  static double Energy (uint32_t app, double dataSize);
+
+  /**
+   * \param app       Application index
+   * \param dataSize  Input data size
+   * \param execTime  Execution time, as returned by ExecTime
+   * \return CPU power while the application runs
+   */
+  static double Power (uint32_t app, double dataSize, double execTime);
+
+  /**
+   * \brief Evaluate ExecTime and Power for many data sizes at once
+   * \param app       Application index
+   * \param n         Number of data sizes
+   * \param dataSize  Input data sizes
+   * \param execTime  Output execution times, may be null
+   * \param power     Output powers, may be null
+   */
+  static void EvalBatch (uint32_t app, uint32_t n, const double *dataSize,
+                         double *execTime, double *power);
+};
+
+} // namespace ns3
+
+#endif /* DEVICE_COEFFICIENTS_H */
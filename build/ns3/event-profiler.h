@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "event-impl.h"
+#include <stdint.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief CPU time of the events, by event type and context
+ *
+ * DefaultSimulatorImpl runs its events through Invoke() when its
+ * ProfileFile attribute is set, and calls Write() when destroyed.
+ *
+ * The event type is the dynamic type of the EventImpl, so the events
+ * made by one MakeEvent() instantiation, that is one signature of
+ * member or free function, add up together.  It is named after the
+ * function signature, e.g. `void (ns3::YansWifiPhy::*)(ns3::Ptr<ns3::Packet>)`,
+ * or after the EventImpl subclass for the other events.
+ *
+ * The file is in the folded stack format of flame graphs, one line per
+ * context and event type with the nanoseconds spent in the events:
+ *
+ *     node 3;void (ns3::YansWifiPhy::*)(ns3::Ptr<ns3::Packet>) 123456
+ *
+ * where the events without context are under `no context`.  Every
+ * simulator instance of the process appends its lines to the file,
+ * truncated by the first one, as the flame graph tools add up the
+ * lines of a stack.
+ */
+class EventProfiler
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] filename The file written by Write().
+   */
+  EventProfiler (const std::string &filename);
+
+  /**
+   * Run an event and add its CPU time to its type and context.
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+  /**
+   * Write the folded stacks to the file.
+   * \returns \c true if the file could be written.
+   */
+  bool Write (void);
+
+private:
+  /** Event type and context. */
+  struct Key
+  {
+    const std::type_info *type;  //!< Dynamic type of the EventImpl
+    uint32_t context;            //!< Context of the events
+
+    /**
+     * Equality operator.
+     * \param [in] other The other key.
+     * \returns \c true if both keys are equal.
+     */
+    bool operator == (const Key &other) const
+    {
+      return type == other.type && context == other.context;
+    }
+  };
+  /** Hash of a Key. */
+  struct KeyHash
+  {
+    /**
+     * Hash a key.
+     * \param [in] key The key.
+     * \returns The hash.
+     */
+    size_t operator () (const Key &key) const
+    {
+      return std::hash<const void *> () (key.type) ^ (key.context * 0x9e3779b9u);
+    }
+  };
+
+  /**
+   * Get the name of an event type.
+   * \param [in] type The dynamic type of the EventImpl.
+   * \returns The function signature bound by MakeEvent(), or the
+   *          demangled type name.
+   */
+  static std::string GetName (const std::type_info &type);
+
+  std::string m_filename;                             //!< The file
+  std::unordered_map<Key, uint64_t, KeyHash> m_time;  //!< Nanoseconds by type and context
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events go to one of three tiers, each storing `Scheduler::Event` by
+ * value in `std::vector`:
+ *  - Top: the far future events, unsorted, from `m_topStart` on.
+ *  - Rungs: up to MAX_RUNGS levels of buckets, each rung splitting one
+ *    bucket of the rung above in finer buckets.  Buckets are unsorted.
+ *  - Bottom: the earliest events, sorted in reverse chronological order
+ *    so that RemoveNext() pops the back of the vector.
+ *
+ * When the bottom runs out, the first non-empty bucket of the lowest
+ * rung is moved to the bottom and sorted, unless it holds more than
+ * the BucketThreshold attribute events, in which case it is spread over
+ * a new, finer rung instead.  When the rungs run out, the top becomes
+ * the first rung, with as many buckets as events.  Insert() places an
+ * event in the tier covering its timestamp, so only the bottom is ever
+ * sorted, and only a bucket at a time.  This suits the clustered
+ * timestamps of slot and backoff timers, which land in a handful of
+ * buckets and are sorted together.
+ *
+ * Buckets and the bottom keep their capacity when drained, so a
+ * simulation in steady state schedules without allocating.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Bucket index; sorted insertion in the bottom
+ * IsEmpty()    | Constant        | `std::vector::empty()`
+ * PeekNext()   | Constant        | `std::vector::back()`
+ * Remove()     | ~Constant       | Search within bucket or bottom
+ * RemoveNext() | ~Constant       | Bucket transfer and sort, amortized
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | MAX_RUNGS x (4 x 8 + 24) + 2 x 24 bytes<br/>+ 24 bytes per bucket | Rungs, top and bottom `std::vector`
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+  /** Maximum number of rungs. */
+  static const uint32_t MAX_RUNGS = 8;
+
+private:
+  /** Events of one bucket, or of the top or bottom. */
+  typedef std::vector<Scheduler::Event> Events;
+
+  /** One level of buckets of uniform width. */
+  struct Rung
+  {
+    uint64_t start;         /**< Timestamp of the start of bucket 0. */
+    uint64_t width;         /**< Time span of a bucket. */
+    uint64_t nBuckets;      /**< Buckets in use. */
+    uint64_t current;       /**< First bucket not moved out yet. */
+    std::vector<Events> buckets;  /**< Buckets, at least nBuckets. */
+
+    /**
+     * Get the start of the current bucket.
+     * \returns Timestamp of the start of the current bucket.
+     */
+    uint64_t CurrentStart (void) const
+    {
+      return start + current * width;
+    }
+  };
+
+  /**
+   * Spread events over a new rung.
+   * \param [in] start Timestamp of the start of the rung.
+   * \param [in] span Time span to cover, larger than the latest event minus start.
+   * \param [in,out] events The events, cleared.
+   * \returns Timestamp of the end of the rung.
+   */
+  uint64_t Spawn (uint64_t start, uint64_t span, Events &events);
+  /**
+   * Refill the bottom, if empty, from the rungs or the top.
+   *
+   * After any operation the bottom is empty only if the whole queue is.
+   */
+  void RefillBottom (void);
+  /**
+   * Insert an event in the bottom, keeping it sorted.
+   * \param [in] ev The event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+  /**
+   * Find the rung covering a timestamp below the top.
+   * \param [in] ts The timestamp.
+   * \returns The rung index, or m_nRungs if the timestamp belongs to the bottom.
+   */
+  uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Set the bucket threshold.
+   * \param [in] threshold Events above which a bucket is split in a new rung.
+   */
+  void SetThreshold (uint32_t threshold);
+
+  Events m_top;              /**< Events from m_topStart on, unsorted. */
+  uint64_t m_topStart;       /**< Start of the top. */
+  uint64_t m_topMin;         /**< Lower bound of the top timestamps. */
+  uint64_t m_topMax;         /**< Upper bound of the top timestamps. */
+  std::vector<Rung> m_rungs; /**< The rungs, MAX_RUNGS of them. */
+  uint32_t m_nRungs;         /**< Rungs in use, the last one is the finest. */
+  Events m_bottom;           /**< Earliest events, latest first. */
+  uint32_t m_threshold;      /**< Events above which a bucket is split. */
+  uint32_t m_bottomLimit;    /**< Bottom size above which it is spread over a rung. */
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,21 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_RELIABILITY
+    
+
+// Module headers:
+#include "app-power-model.h"
+#include "device-coefficients.h"
+#include "performance-model.h"
+#include "performance-simple-model.h"
+#include "power-model.h"
+#include "reliability-helper.h"
+#include "reliability-model.h"
+#include "reliability-tddb-model.h"
+#include "temperature-model.h"
+#include "temperature-simple-model.h"
+#include "util-power-model.h"
+#endif
@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef RELIABILITY_TDDB_MODEL_H
+#define RELIABILITY_TDDB_MODEL_H
+
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-value.h"
+#include "ns3/reliability-model.h"
+#include "ns3/temperature-model.h"
+#include <map>
+#include <utility>
+#include <vector>
+
+
+namespace ns3 {
+
+class ReliabilityTDDBModel : public ReliabilityModel
+{
+public:
+
+  static TypeId GetTypeId (void);
+  ReliabilityTDDBModel ();
+  virtual ~ReliabilityTDDBModel ();
+
+
+  /**
+   * \param  Pointer to temperature object attached to the device.
+   *
+   * Registers the Temperature Model to Power Model.
+   */
+  virtual void RegisterTemperatureModel (Ptr<TemperatureModel> temperatureModel);
+
+
+  // Setter & getters for state power consumption.
+  virtual double GetA (void) const;
+  virtual void SetA (double A);
+  virtual double GetB (void) const;
+  virtual void SetB (double B);
+  virtual double GetArea (void) const;
+  virtual void SetArea (double area);
+  void SetLazy (bool lazy);
+  bool GetLazy (void) const;
+
+  /**
+   * \returns Current reliability
+   */
+  virtual double GetReliability (void) const;
+
+  // Utility functions
+  virtual double g(double u , double v , double t_0 , double scale_p , double shape_p) const;
+  virtual double pdf_u(double x , double mean , double sigma) const;
+  virtual double pdf_v(double v , double offset , double mult , double degrees) const;
+  virtual double scale_par(double T , double V , double offset_a , double mult_a , double tau_a , double tauvolt_a) const;
+  virtual double shape_par(double T , double V , double mult_b , double tau_b , double offset_b , double multvolt_b) const; 
+  virtual double Chi_Square_Density(double x , double n) const;
+  virtual double Ln_Gamma_Function(double x) const;
+  /**
+   * \brief 
+   *
+   * \param cpupower, temperature.
+   *
+   * Updates reliability.
+   */
+  virtual void UpdateReliability ();
+
+  /**
+   * \returns Nodes of the Rc tables shared by the models with a TemperatureQuantum.
+   */
+  static size_t GetRcTableSize (void);
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * Fills the constant part of the double integral: the subdomain midpoints and the
+   * pdf_u * pdf_v * subdomain_area weight of every subdomain, row major in u.
+   */
+  void BuildWeights (void);
+
+  /**
+   * \param t_0 Time at which the integral is evaluated.
+   * \param scale_p Scale parameter.
+   * \param shape_p Shape parameter.
+   * \returns Integral of exp (-A * g) weighted by the joint pdf.
+   *
+   * g is separable, exp (r + f) = exp (L * u) * exp (L * shape * v), so only
+   * u_num_step + v_num_step exponentials are needed for g; the inner loop over v
+   * runs on contiguous arrays and evaluates exp (-A * g) with an inline, branch
+   * free exponential, so that it vectorizes.
+   */
+  double Integrate (double t_0, double scale_p, double shape_p) const;
+
+  /**
+   * \param L log (t_0 / scale) * shape.
+   * \param shape_p Shape parameter.
+   * \param node Rc and its first and second derivatives in L.
+   *
+   * For a given shape, the integral depends on t_0 and the scale through L only.
+   */
+  void Tabulate (double L, double shape_p, double *node) const;
+
+  /**
+   * \param t_0 Time at which the integral is evaluated.
+   * \returns Integral at the current temperature bin, interpolated between the
+   * nodes of its Rc table around L, computing the missing ones.
+   */
+  double InterpolateRc (double t_0);
+
+  /**
+   * \param t_0 Time at which the integral is evaluated.
+   * \returns InterpolateRc with a TemperatureQuantum, Integrate otherwise.
+   */
+  double EvaluateRc (double t_0);
+
+  /**
+   * \returns Damage of the current step, scale_parameter and shape_parameter being set.
+   */
+  double ComputeDamage (void);
+
+  /**
+   * \param now Time of the update.
+   *
+   * One reliability step from the current average temperature.
+   */
+  void Step (Time now);
+
+  /**
+   * Lazy mode: the step the update event would have run at m_nextUpdate, called by
+   * the temperature model once the temperature is brought to that time.
+   */
+  void Checkpoint (void);
+
+private:
+
+  double m_A;
+  double m_B;
+  double m_area;
+  double voltage;
+  //Scale-Shape Constants
+
+
+  double offset_a;
+  double mult_a;
+  double tau_a;
+  double tauvolt_a;
+  double mult_b;
+  double tau_b;
+  double offset_b;
+  double multvolt_b;
+
+  //Reliability Parameters
+
+  double pdf_v_offset;
+  double pdf_v_mult;
+  double pdf_v_degrees;
+  double pdf_u_mean;
+  double pdf_u_sigma;
+  double scale_parameter;
+  double shape_parameter;
+
+  //Double integral domain
+  double u_max;
+  double u_min;
+  double v_max;
+  double v_min;
+  double subdomain_step_u;
+  double subdomain_step_v;
+  int u_num_step;
+  int v_num_step;
+  double subdomain_area;
+
+  double A;
+  int LI_index;
+  double delta_LI;
+  double t_life;
+  double Rd;
+
+  std::vector<double> m_uMid;       // midpoint of each u subdomain
+  std::vector<double> m_vMid;       // midpoint of each v subdomain
+  std::vector<double> m_weights;    // joint pdf * subdomain area, u_num_step x v_num_step
+
+  // Integral of the previous step, reused as the next step's "prec" integral
+  // while the temperature (hence scale and shape) does not change.
+  double m_lastRc;
+  double m_lastScale;
+  double m_lastShape;
+  int m_lastIndex;
+
+  // Rc at the nodes k * RC_GRID_STEP of L, from node first on; Rc, dRc/dL and
+  // d2Rc/dL2 per node, Rc < 0 for nodes not computed yet.
+  struct RcTable
+  {
+    long long first;
+    std::vector<double> nodes;
+  };
+
+  // Temperature quantization step of the Rc tables, 0 to disable them.
+  double m_temperatureQuantum;
+  // Quantized temperature of the current step, in quanta.
+  long long m_temperatureBin;
+  // Rc tables shared by every model, keyed on (quantum, quantized temperature).
+  // The step is not part of the key: a lone model reuses the nodes of its earlier
+  // updates, and several steps fall between two nodes as L grows with log (t_0).
+  // The tables do not depend on the simulation; they are all cleared when their
+  // nodes reach MAX_RC_NODES.
+  static std::map<std::pair<double, long long>, RcTable> m_rcTables;
+  static size_t m_rcNodes;
+
+
+
+  Ptr<TemperatureModel> m_temperatureModel;
+
+  // This variable keeps track of the reliability of this model.
+  TracedValue<double> m_reliability;
+  EventId m_reliabilityUpdateEvent;            // energy update event
+  Time m_reliabilityUpdateInterval;
+  // State variables.
+  Time m_lastUpdateTime;          // time stamp of previous energy update
+  bool m_lazy;                    // update only when the reliability is read
+  Time m_nextUpdate;              // lazy mode: time of the next update
+
+};
+
+} // namespace ns3
+
+#endif /* RELIABILITY_TDDB_MODEL_H */
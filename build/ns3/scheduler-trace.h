@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SCHEDULER_TRACE_H
+#define SCHEDULER_TRACE_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::SchedulerTrace, ns3::SchedulerTraceWriter and
+ * ns3::SchedulerTraceReader declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief Scheduler operations of a simulation
+ *
+ * DefaultSimulatorImpl records the operations on its event list when
+ * its TraceFile attribute is set; utils/bench-scheduler-replay.cc
+ * replays them against each Scheduler implementation, to pick the
+ * best one for a workload from real runs.
+ *
+ * The file holds one segment per simulator instance, as a simulation
+ * which calls Simulator::Destroy starts a new instance and appends to
+ * the file.  A segment is the MAGIC string and a uint32_t VERSION,
+ * followed by the records: an Op byte, then LEB128 varints of the
+ * current time minus the one of the previous record, the event
+ * timestamp minus the current time, the zigzag encoded event uid minus
+ * the one of the previous record and the event context plus one
+ * (Simulator::NO_CONTEXT is 0).  A record takes about 8 bytes.
+ */
+class SchedulerTrace
+{
+public:
+  /** Operation on the event list. */
+  enum Op : uint8_t
+  {
+    INSERT = 0,       //!< Scheduler::Insert of a new event
+    REMOVE_NEXT = 1,  //!< Scheduler::RemoveNext, the event about to run
+    REMOVE = 2,       //!< Scheduler::Remove, from Simulator::Remove
+    CANCEL = 3,       //!< Simulator::Cancel, the event stays in the list
+    SEGMENT = 4       //!< Start of a new simulator instance, only returned by the reader
+  };
+
+  /** One operation. */
+  struct Record
+  {
+    Op op;                     //!< Operation
+    uint64_t now;              //!< Simulation time of the operation
+    Scheduler::EventKey key;   //!< Event of the operation
+  };
+
+  /** Start of a segment. */
+  static const char MAGIC[8];
+  /** Format version. */
+  static const uint32_t VERSION = 1;
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Writes the operations of a simulator instance, see SchedulerTrace
+ */
+class SchedulerTraceWriter
+{
+public:
+  /** Constructor. */
+  SchedulerTraceWriter ();
+  /** Destructor, closes the file. */
+  ~SchedulerTraceWriter ();
+
+  /**
+   * Open the file and start a segment.
+   *
+   * The first segment of the process truncates the file, the next
+   * ones are appended.
+   *
+   * \param [in] filename The file.
+   * \returns \c true if the file could be opened.
+   */
+  bool Open (const std::string &filename);
+  /**
+   * Record an operation.
+   * \param [in] op The operation.
+   * \param [in] now The current simulation time.
+   * \param [in] key The event.
+   */
+  void Write (SchedulerTrace::Op op, uint64_t now, const Scheduler::EventKey &key);
+  /** Flush and close the file. */
+  void Close (void);
+
+private:
+  /**
+   * Append a LEB128 varint to the buffer.
+   * \param [in] value The value.
+   */
+  void PutVarint (uint64_t value);
+  /** Write the buffer to the file. */
+  void Flush (void);
+
+  std::FILE *m_file;              //!< The file, null if closed
+  std::vector<uint8_t> m_buffer;  //!< Records not written yet
+  uint64_t m_lastNow;             //!< Current time of the previous record
+  uint32_t m_lastUid;             //!< Event uid of the previous record
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Reads the operations written by SchedulerTraceWriter
+ */
+class SchedulerTraceReader
+{
+public:
+  /** Constructor. */
+  SchedulerTraceReader ();
+  /** Destructor, closes the file. */
+  ~SchedulerTraceReader ();
+
+  /**
+   * Open a file.
+   * \param [in] filename The file.
+   * \returns \c true if the file could be opened and starts with a segment.
+   */
+  bool Open (const std::string &filename);
+  /**
+   * Read the next operation.
+   *
+   * The start of the segments after the first one is returned as a
+   * SchedulerTrace::SEGMENT record.
+   *
+   * \param [out] record The operation.
+   * \returns \c false at the end of the file or on a malformed record.
+   */
+  bool Read (SchedulerTrace::Record &record);
+
+private:
+  /**
+   * Read a LEB128 varint.
+   * \param [out] value The value.
+   * \returns \c false at the end of the file.
+   */
+  bool GetVarint (uint64_t &value);
+  /**
+   * Read the segment header, after its first byte.
+   * \returns \c true if the header is valid.
+   */
+  bool ReadHeader (void);
+
+  std::FILE *m_file;   //!< The file, null if closed
+  uint64_t m_lastNow;  //!< Current time of the previous record
+  uint32_t m_lastUid;  //!< Event uid of the previous record
+};
+
+} // namespace ns3
+
+#endif /* SCHEDULER_TRACE_H */
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TEMPERATURE_MODEL_H
+#define TEMPERATURE_MODEL_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+class TemperatureModel : public Object
+{
+public:
+
+  static TypeId GetTypeId (void);
+  TemperatureModel () ;
+  virtual ~TemperatureModel ();
+
+
+
+  /**
+   * Updates temperature
+   */
+  virtual void UpdateTemperature (double cpupower);
+
+  /**
+   * \param cpupower CPU power during the steps.
+   * \param steps Number of steps.
+   *
+   * Same as calling UpdateTemperature (cpupower) steps times.
+   */
+  virtual void UpdateTemperature (double cpupower, uint64_t steps);
+
+  /**
+   * \param t Time to bring the temperature to.
+   *
+   * Lazy mode: applies the temperature steps of the power model that fall before t
+   * and runs the checkpoints due at or before t, in time order. Call it before reading
+   * the temperature; without a lazy power model or checkpoint it does nothing.
+   */
+  void Update (Time t);
+
+  /**
+   * \param advance Applies the power model steps that fall before a given time.
+   *
+   * Set by a lazy power model that no longer steps the temperature periodically.
+   */
+  void SetAdvanceCallback (Callback<void, Time> advance);
+
+  /**
+   * \param t Time of the checkpoint.
+   * \param checkpoint Called by Update once the temperature is brought to t.
+   *
+   * Set by a lazy model reading the temperature at fixed times (e.g. reliability).
+   * The checkpoint sets the next one; a null callback removes it.
+   */
+  void SetCheckpoint (Time t, Callback<void> checkpoint);
+
+  /**
+   * \returns Current temperature.
+   */
+  virtual double GetTemperature (void) const;
+
+  /**
+   * \returns Moving average of temperature.
+   */
+  virtual double GetAvgTemperature (void) const;
+
+  virtual void SetDeviceType(std::string devicetype) = 0;
+  virtual void SetTenv(double Tenv) = 0;
+  
+private:
+  virtual void DoDispose (void);
+
+  Callback<void, Time> m_advance;   // lazy power model steps
+  Callback<void> m_checkpoint;      // lazy reader of the temperature
+  Time m_checkpointTime;            // time of the pending checkpoint
+};
+
+} // namespace ns3
+
+#endif /* TEMPERATURE_MODEL_H */
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-analytic-model.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace ns3 {
+
+    // 802.11b DSSS at 11Mbps, long preamble (seconds)
+    static const double WIFI_PHY_RATE = 11e6;
+    static const double WIFI_PREAMBLE = 192e-6;
+    static const double WIFI_SIFS = 10e-6;
+    static const double WIFI_DIFS = 50e-6;
+    static const double WIFI_MEAN_BACKOFF = 15.5 * 20e-6;   // CWmin 31, 20us slots
+    static const double WIFI_HEADERS = 76;                  // TCP + IP + LLC + MAC header and FCS (bytes)
+    static const double WIFI_ACK = 14;                      // MAC ACK (bytes)
+
+    // CSMA channel of Experiment::Ethernet
+    static const double CSMA_RATE = 100e6;
+    static const double CSMA_HEADERS = 78;                  // TCP + IP + Ethernet header, FCS, preamble, IFG (bytes)
+
+    FLAnalyticModel::FLAnalyticModel(bool bWifi) :
+            m_bWifi(bWifi),
+            m_connectTime(bWifi ? 5e-3 : 1e-4),
+            m_contention(bWifi ? 0.01 : 0.0),
+            m_commScale(1.0),
+            m_lossPerMeter(0.0) {
+    }
+
+    double FLAnalyticModel::MediumTime(int nInRound, double modelBytes, int maxPacketSize) const {
+        double nPackets = std::ceil(modelBytes / maxPacketSize);
+        double data;
+        double ack;
+        if (m_bWifi) {
+            double frame = WIFI_DIFS + WIFI_MEAN_BACKOFF + WIFI_PREAMBLE + WIFI_SIFS + WIFI_PREAMBLE +
+                           WIFI_ACK * 8 / WIFI_PHY_RATE;
+            data = frame + (maxPacketSize + WIFI_HEADERS) * 8 / WIFI_PHY_RATE;
+            ack = frame + WIFI_HEADERS * 8 / WIFI_PHY_RATE;
+        } else {
+            data = (maxPacketSize + CSMA_HEADERS) * 8 / CSMA_RATE;
+            ack = CSMA_HEADERS * 8 / CSMA_RATE;
+        }
+
+        // Delayed ACK, one TCP ACK every second segment
+        double perClient = nPackets * (data + 0.5 * ack);
+        return nInRound * perClient * (1 + m_contention * (nInRound - 1));
+    }
+
+    FLAnalyticModel::Estimate
+    FLAnalyticModel::Predict(double radius, int nInRound, double serverRate, double clientRate, double modelBytes,
+                             double updateBytes, int maxPacketSize, double computationTime) const {
+        double scale = m_commScale * (1 + (m_bWifi ? m_lossPerMeter * radius : 0.0));
+
+        Estimate e;
+        e.downlink = m_connectTime + std::max(modelBytes * 8 / serverRate,
+                                              MediumTime(nInRound, modelBytes, maxPacketSize)) * scale;
+        e.computation = computationTime;
+        e.uplink = std::max(updateBytes * 8 / clientRate, MediumTime(nInRound, updateBytes, maxPacketSize)) * scale;
+        return e;
+    }
+
+    void FLAnalyticModel::AddSample(const Estimate &predicted, double radius, double measured) {
+        Sample s;
+        s.radius = radius;
+        s.comm = (predicted.downlink - m_connectTime + predicted.uplink) /
+                 (m_commScale * (1 + (m_bWifi ? m_lossPerMeter * radius : 0.0)));
+        s.measured = measured - m_connectTime - predicted.computation;
+        m_samples.push_back(s);
+    }
+
+    bool FLAnalyticModel::Fit() {
+        // measured = a * comm + b * comm * radius
+        double s11 = 0, s12 = 0, s22 = 0, t1 = 0, t2 = 0;
+        for (auto &s: m_samples) {
+            double x1 = s.comm;
+            double x2 = m_bWifi ? s.comm * s.radius : 0.0;
+            s11 += x1 * x1;
+            s12 += x1 * x2;
+            s22 += x2 * x2;
+            t1 += x1 * s.measured;
+            t2 += x2 * s.measured;
+        }
+        if (s11 <= 0) {
+            return false;
+        }
+
+        double a = t1 / s11;
+        double b = 0;
+        double det = s11 * s22 - s12 * s12;
+        if (det > 1e-12 * s11 * s22) {
+            a = (t1 * s22 - t2 * s12) / det;
+            b = (s11 * t2 - s12 * t1) / det;
+        }
+        if (a <= 0) {
+            return false;
+        }
+
+        m_commScale = a;
+        m_lossPerMeter = b / a;
+        NS_LOG_UNCOND("CALIBRATION: samples=" << m_samples.size() << " CommScale=" << m_commScale
+                                              << " LossPerMeter=" << m_lossPerMeter);
+        return true;
+    }
+
+    bool FLAnalyticModel::Load(const std::string &fileName) {
+        std::ifstream in(fileName);
+        std::string key;
+        double value;
+        bool found = false;
+        while (in >> key >> value) {
+            if (key == "CommScale") {
+                m_commScale = value;
+                found = true;
+            } else if (key == "LossPerMeter") {
+                m_lossPerMeter = value;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    bool FLAnalyticModel::Save(const std::string &fileName) const {
+        std::ofstream out(fileName);
+        out << "CommScale " << m_commScale << std::endl;
+        out << "LossPerMeter " << m_lossPerMeter << std::endl;
+        return out.good();
+    }
+
+    double FLAnalyticModel::GetCommScale() const {
+        return m_commScale;
+    }
+
+    double FLAnalyticModel::GetLossPerMeter() const {
+        return m_lossPerMeter;
+    }
+}
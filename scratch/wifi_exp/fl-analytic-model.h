@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_ANALYTIC_MODEL_H
+#define FL_ANALYTIC_MODEL_H
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-experiment
+    * \brief Closed form estimate of the downlink, computation and uplink time of a sync round
+    *
+    * Each transfer takes the longer of the application pacing time (bytes / DataRate) and
+    * the time the shared medium needs to carry the packets of every client in round.
+    * The medium time of one packet follows 802.11b DSSS (long preamble, DIFS, mean backoff,
+    * SIFS and ACK) for wifi and the frame time on a 100Mbps CSMA channel for ethernet,
+    * inflated by a per-client contention factor. The communication time is then scaled
+    * by CommScale * (1 + LossPerMeter * radius), both fitted against packet-level runs.
+    */
+    class FLAnalyticModel {
+    public:
+        /**
+         * \brief Estimated phases of one client's round, in seconds
+         */
+        struct Estimate {
+            double downlink;
+            double computation;
+            double uplink;
+        };
+
+        /**
+        * \brief Constructs the model with uncalibrated defaults
+        * \param bWifi  True for the wifi network, false for ethernet
+        */
+        FLAnalyticModel(bool bWifi);
+
+        /**
+        * \brief Predict one client's round
+        * \param radius          Distance of the client from the server
+        * \param nInRound        Number of clients sharing the medium
+        * \param serverRate      Server application data rate (bps)
+        * \param clientRate      Client application data rate (bps)
+        * \param modelBytes      Size of model, sent by the server
+        * \param updateBytes     Size of the encoded update, sent by the client
+        * \param maxPacketSize   Max packet size
+        * \param computationTime Local training time
+        * \return                Estimate
+        */
+        Estimate Predict(double radius, int nInRound, double serverRate, double clientRate, double modelBytes,
+                         double updateBytes, int maxPacketSize, double computationTime) const;
+
+        /**
+        * \brief Record a packet-level measurement for calibration
+        * \param predicted  Estimate made with the current parameters
+        * \param radius     Distance of the client from the server
+        * \param measured   Measured round time, from client start to end of uplink
+        */
+        void AddSample(const Estimate &predicted, double radius, double measured);
+
+        /**
+        * \brief Least squares fit of CommScale and LossPerMeter over the recorded samples
+        * \return False if the samples do not determine the parameters
+        */
+        bool Fit();
+
+        /**
+        * \brief Load calibrated parameters
+        * \param fileName  File written by Save
+        * \return          False if the file could not be read
+        */
+        bool Load(const std::string &fileName);
+
+        /**
+        * \brief Save calibrated parameters
+        * \param fileName  File name
+        * \return          False if the file could not be written
+        */
+        bool Save(const std::string &fileName) const;
+
+        double GetCommScale() const;
+        double GetLossPerMeter() const;
+
+    private:
+        /**
+        * \brief Medium time of one transfer shared by nInRound clients, without calibration scaling
+        */
+        double MediumTime(int nInRound, double modelBytes, int maxPacketSize) const;
+
+        /**
+         * \brief Calibration sample
+         */
+        struct Sample {
+            double radius;     //!< Distance of the client from the server
+            double comm;       //!< Predicted communication time, unscaled
+            double measured;   //!< Measured communication time
+        };
+
+        bool m_bWifi;                  //!< Wifi or ethernet medium
+        double m_connectTime;          //!< Client start to connection established
+        double m_contention;           //!< Medium time overhead per additional client in round
+        double m_commScale;            //!< Calibrated scaling of the communication time
+        double m_lossPerMeter;         //!< Calibrated retransmission overhead per meter (wifi)
+        std::vector<Sample> m_samples; //!< Calibration samples
+    };
+}
+
+#endif
@@ -23,6 +23,9 @@
 #include "ns3/internet-module.h"
 #include "fl-energy.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3 {
     NS_LOG_COMPONENT_DEFINE ("ClientApplication");
     NS_OBJECT_ENSURE_REGISTERED (ClientApplication);
@@ -37,7 +40,8 @@ namespace ns3 {
 
               m_bytesModel(0),
               m_dataRate(0),
-
+              m_bPacing(true),
+              m_pacingBurst(0),
 
               m_bytesModelReceived(0),
               m_bytesModelToReceive(0),
@@ -46,11 +50,19 @@ namespace ns3 {
 
 
 
-              m_bytesModelToSend(0),
               m_bytesSent(0),
-
-              m_sendEvent(),
-              m_model() {
+              m_bytesUpdate(0),
+
+              m_transfer(),
+              m_model(),
+              m_computationTime(0),
+              m_bOnline(true),
+              m_churn(nullptr),
+              m_churnId(0),
+              m_bResume(false),
+              m_churnTime(0),
+              m_bBroadcast(false),
+              m_bExpectModel(true) {
 
     }
 
@@ -65,6 +77,22 @@ namespace ns3 {
                               MakeDataRateAccessor(&ClientApplication::m_dataRate),
                               MakeDataRateChecker())
 
+                .AddAttribute("Pacing",
+                              "Pace the model transfer at DataRate, otherwise only the "
+                              "TCP send buffer limits it",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(true),
+                              MakeBooleanAccessor(&ClientApplication::m_bPacing),
+                              MakeBooleanChecker())
+
+                .AddAttribute("PacingBurst",
+                              "Bytes that can be written at once when pacing, "
+                              "0 for ModelTransfer::BURST_PACKETS MaxPacketSize packets",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&ClientApplication::m_pacingBurst),
+                              MakeUintegerChecker<uint32_t>())
+
                 .AddAttribute("MaxPacketSize",
                               "MaxPacketSize to send to client",
                               TypeId::ATTR_SGC,
@@ -105,6 +133,20 @@ namespace ns3 {
                               TypeId::ATTR_SGC,
                               TimeValue(),
                               MakeTimeAccessor(&ClientApplication::m_timeEndReceivingModelFromServer),
+                              MakeTimeChecker())
+
+                .AddAttribute("Broadcast",
+                              "Receive the model from the server broadcast instead of the connection",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(false),
+                              MakeBooleanAccessor(&ClientApplication::m_bBroadcast),
+                              MakeBooleanChecker())
+
+                .AddAttribute("BroadcastNackTimeout",
+                              "Time without broadcast chunks before asking for the missing ones",
+                              TypeId::ATTR_SGC,
+                              TimeValue(MilliSeconds(200)),
+                              MakeTimeAccessor(&ClientApplication::m_nackTimeout),
                               MakeTimeChecker());
         return tid;
     }
@@ -117,48 +159,15 @@ namespace ns3 {
         NS_LOG_UNCOND("Error Close ...");
     }
 
-    void ClientApplication::HandleReadyToSend(Ptr <Socket> sock, uint32_t available) {
-        m_socket->SetSendCallback(MakeNullCallback < void, Ptr < Socket > , uint32_t > ());
-        Send(sock);
-    }
-
-    void ClientApplication::Send(Ptr <Socket> socket) {
-        //If nothing to  send, return
-        if (m_bytesModelToSend == 0) {
-            return;
-        }
-
-        auto available = m_socket->GetTxAvailable();
-
-        if (available) {
-
-            auto bytes = std::min(std::min(m_bytesModelToSend, available), m_packetSize);
-
-            auto bytesSent = socket->Send(Create<Packet>(bytes));
-
-            if (bytesSent == -1) {
-                return;
+    void ClientApplication::ModelSent(Ptr <Socket> socket, uint32_t bytes) {
+        m_bytesSent += bytes;
+        if (m_transfer.GetRemaining() == 0) {
+            m_bytesModelToReceive = m_bytesModel;
+            // Without resume the client only takes part once, later changes do not matter
+            if (!m_bResume) {
+                m_churnEvent.Cancel();
             }
-
-
-            m_bytesSent += bytesSent;
-            m_bytesModelToSend -= bytesSent;
-
-
-            if (m_bytesModelToSend) {
-
-                Time nextTime(Seconds((bytesSent * 8) /
-                                      static_cast<double>(m_dataRate.GetBitRate()))); // Time till next packet
-
-                m_sendEvent = Simulator::Schedule(nextTime,
-                                                  &ClientApplication::Send, this, socket);
-            } else {
-                m_bytesModelToReceive = m_bytesModel;
-            }
-        } else {
-            socket->SetSendCallback(MakeCallback(&ClientApplication::HandleReadyToSend, this));
         }
-
     }
 
     void ClientApplication::ConnectionSucceeded(Ptr <Socket> socket) {
@@ -167,7 +176,7 @@ namespace ns3 {
         socket->SetRecvCallback(MakeCallback(&ClientApplication::HandleRead, this));
 
         m_bytesModelToReceive = m_bytesModel;
-        m_bytesModelToSend = 0;
+        m_transfer.Cancel();
 
         NS_LOG_UNCOND("Client " << (socket->GetNode()->GetId() + 1) << " " << m_bytesModelToReceive);
     }
@@ -197,23 +206,37 @@ namespace ns3 {
 
 
 
-                //Todo[] Add a meaningful delay
-                auto energy = FLEnergy();
-                energy.SetDeviceType("400");
-                energy.SetLearningModel("CIFAR-10");
-                energy.SetEpochs(5.0);
-                Simulator::Schedule(Seconds(energy.CalcComputationTime()), &ClientApplication::StartWriting, this);
+                StartTraining();
 
             }
 
         }
     }
 
-    void ClientApplication::StartWriting() {
+    void ClientApplication::ModelBroadcastReceived() {
+        m_timeEndReceivingModelFromServer = Simulator::Now();
+        m_bytesModelReceived += m_bytesModel;
+        m_bytesModelToReceive = 0;
+
+        NS_LOG_UNCOND("Client " << (GetNode()->GetId() + 1) << " " << "recv full model (broadcast)");
+
+        StartTraining();
+    }
+
+    void ClientApplication::StartTraining() {
+        if (!m_modelReceived.IsNull()) {
+            m_modelReceived();
+            return;
+        }
 
-        m_bytesModelToSend = m_bytesModel;
+        //Todo[] Add a meaningful delay
+        m_computeEvent = Simulator::Schedule(Seconds(m_computationTime),
+                                             &ClientApplication::StartWriting, this);
+    }
+
+    void ClientApplication::StartWriting() {
 
-        Send(m_socket);
+        m_transfer.Start(m_bytesUpdate ? m_bytesUpdate : m_bytesModel);
     }
 
     void ClientApplication::ConnectionFailed(Ptr <Socket> socket) {
@@ -233,6 +256,129 @@ namespace ns3 {
         m_dataRate = dataRate;
     }
 
+    void
+    ClientApplication::SetEnergyProfile(uint32_t profile) {
+        m_computationTime = FLEnergy::GetProfile(profile).computationTime;
+    }
+
+    void
+    ClientApplication::SetComputationTime(double seconds) {
+        m_computationTime = seconds;
+    }
+
+    void
+    ClientApplication::SetUpdateBytes(uint32_t bytes) {
+        m_bytesUpdate = bytes;
+    }
+
+    void
+    ClientApplication::SetModelCallback(Callback<void> modelReceived) {
+        m_modelReceived = modelReceived;
+    }
+
+    void
+    ClientApplication::Upload() {
+        StartWriting();
+    }
+
+    void
+    ClientApplication::SetChurn(ChurnModel *churn, uint32_t id, Time offset, bool resume) {
+        m_churn = churn;
+        m_churnId = id;
+        m_churnOffset = offset;
+        m_bResume = resume;
+        m_churnTime = offset.GetSeconds() + Simulator::Now().GetSeconds();
+        ScheduleChurn();
+    }
+
+    void
+    ClientApplication::ScheduleChurn() {
+        m_churnEvent.Cancel();
+        if (!m_churn || (!m_bOnline && !m_bResume)) {
+            return;
+        }
+
+        // Changes are looked up from the time of the previous one, so rounding of the
+        // simulation time can not bring the same change back
+        double next = m_churn->NextChange(m_churnId, m_churnTime);
+        if (std::isinf(next)) {
+            return;
+        }
+        double now = m_churnOffset.GetSeconds() + Simulator::Now().GetSeconds();
+        m_churnTime = next;
+        m_churnEvent = Simulator::Schedule(Seconds(std::max(0.0, next - now)),
+                                           &ClientApplication::ChurnTransition, this);
+    }
+
+    void
+    ClientApplication::ChurnTransition() {
+        bool available = m_churn->IsAvailable(m_churnId, m_churnTime);
+        if (!available && m_bOnline) {
+            Disconnect();
+        } else if (available && !m_bOnline && m_bResume) {
+            Reconnect();
+        }
+        ScheduleChurn();
+    }
+
+    void
+    ClientApplication::Disconnect() {
+        if (!m_bOnline) {
+            return;
+        }
+        m_bOnline = false;
+
+        NS_LOG_UNCOND("Client " << (GetNode()->GetId() + 1) << " offline");
+        m_transfer.Cancel();
+        m_computeEvent.Cancel();
+        m_receiver.SetEnabled(false);
+        m_socket->SetRecvCallback(MakeNullCallback < void, Ptr < Socket > > ());
+        m_socket->Close();
+    }
+
+    void
+    ClientApplication::Reconnect() {
+        if (m_bOnline) {
+            return;
+        }
+        m_bOnline = true;
+
+        NS_LOG_UNCOND("Client " << (GetNode()->GetId() + 1) << " online");
+        Ptr <Socket> old = m_socket;
+        m_socket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+        UintegerValue value;
+        old->GetAttribute("ConnCount", value);
+        m_socket->SetAttribute("ConnCount", value);
+        old->GetAttribute("DataRetries", value);
+        m_socket->SetAttribute("DataRetries", value);
+
+        // A client back within the round was dropped by the server, it waits for the next ExpectModel
+        ResetRound();
+        Connect();
+    }
+
+    bool
+    ClientApplication::IsOnline() const {
+        return m_bOnline;
+    }
+
+    void
+    ClientApplication::ExpectModel(bool expect) {
+        m_bExpectModel = expect;
+        m_receiver.SetEnabled(expect && m_bOnline);
+    }
+
+    void
+    ClientApplication::ResetRound() {
+        m_transfer.Cancel();
+
+        m_bytesModelReceived = 0;
+        m_bytesModelToReceive = m_bytesModel;
+        m_bytesSent = 0;
+        m_timeBeginReceivingModelFromServer = Simulator::Now();
+        m_timeEndReceivingModelFromServer = Time();
+    }
+
     void
     ClientApplication::StartApplication(void) {
 
@@ -243,6 +389,22 @@ namespace ns3 {
 
         m_model.SetApplication("kNN", DoubleValue(m_packetSize));
 
+        if (m_bBroadcast) {
+            m_receiver.Setup(GetNode(), InetSocketAddress::ConvertFrom(m_peer).GetIpv4(), m_bytesModel,
+                             m_packetSize, m_nackTimeout,
+                             MakeCallback(&ClientApplication::ModelBroadcastReceived, this));
+            m_receiver.SetEnabled(m_bExpectModel && m_bOnline);
+        }
+
+        if (m_bOnline) {
+            Connect();
+        }
+    }
+
+    void
+    ClientApplication::Connect() {
+        m_transfer.Setup(m_socket, m_dataRate, ModelTransfer::GetBurst(m_pacingBurst, m_packetSize), m_bPacing,
+                         MakeCallback(&ClientApplication::ModelSent, this));
 
         m_socket->SetCloseCallbacks(
                 MakeCallback(&ClientApplication::NormalClose, this),
@@ -265,9 +427,10 @@ namespace ns3 {
     ClientApplication::StopApplication(void) {
 
 
-        if (m_sendEvent.IsRunning()) {
-            Simulator::Cancel(m_sendEvent);
-        }
+        m_transfer.Cancel();
+        m_computeEvent.Cancel();
+        m_churnEvent.Cancel();
+        m_receiver.SetEnabled(false);
 
         if (m_socket) {
             //m_socket->Close ();
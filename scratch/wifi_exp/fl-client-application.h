@@ -28,6 +28,9 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/seq-ts-size-header.h"
 #include "ns3/performance-simple-model.h"
+#include "fl-model-transfer.h"
+#include "fl-model-broadcast.h"
+#include "fl-client-churn.h"
 
 namespace ns3
 {
@@ -59,11 +62,98 @@ namespace ns3
     void Setup (Ptr <Socket> socket, Address address, uint32_t packetSize, uint32_t nBytesModel,
                 DataRate dataRate);
 
+    /**
+    * \brief Re-arm the per-round state (byte counters, timestamps) so an
+    * already connected client can take part in another round.
+    * Used by the persistent network, where the socket outlives the round.
+    */
+    void ResetRound ();
+
+    /**
+    * \brief Set the energy profile used for the computation delay
+    * \param profile  Index returned by FLEnergy::ResolveProfile
+    */
+    void SetEnergyProfile (uint32_t profile);
+
+    /**
+    * \brief Set the computation delay, overriding the one of the energy profile
+    * \param seconds  Local training time
+    */
+    void SetComputationTime (double seconds);
+
+    /**
+    * \brief Set the size of the encoded update uploaded each round
+    * \param bytes  Bytes uploaded, 0 for the model size
+    */
+    void SetUpdateBytes (uint32_t bytes);
+
+    /**
+    * \brief Drive the connection of the client from a churn model
+    * The client disconnects, dropping any transfer or training in progress, when the model
+    * makes it unavailable and, if resume is set, reconnects when it is available again.
+    * \param churn   Churn model, null to stop following one
+    * \param id      Client id in the model
+    * \param offset  Experiment time of simulation time 0
+    * \param resume  Reconnect after a disconnection, otherwise the client stays offline
+    */
+    void SetChurn (ChurnModel *churn, uint32_t id, Time offset, bool resume);
+
+    /**
+    * \brief Close the connection, dropping the model transfer and training in progress
+    */
+    void Disconnect ();
+
+    /**
+    * \brief Open a new connection to the server after Disconnect
+    */
+    void Reconnect ();
+
+    /**
+    * \brief Get if the client is connected (or connecting)
+    * \return False after Disconnect
+    */
+    bool IsOnline () const;
+
+    /**
+    * \brief Set if the client takes part in the next model broadcast
+    * Clients outside the round ignore the broadcast. Only used with the Broadcast attribute.
+    * \param expect  True if the client is in round
+    */
+    void ExpectModel (bool expect);
+
+    /**
+    * \brief Hand the model, once received, to a callback instead of training on it
+    * The owner of the callback calls Upload when its update is ready. Used by the edge
+    * aggregators of the hierarchical topology, whose update is the aggregate of their clients.
+    * \param modelReceived  Called once the whole model arrived
+    */
+    void SetModelCallback (Callback<void> modelReceived);
+
+    /**
+    * \brief Send the update to the server, see SetModelCallback
+    */
+    void Upload ();
+
    private:
     // inherited from Application base class.
     virtual void StartApplication (void);  //Called when application starts
     virtual void StopApplication (void);   //Called at the end of simulation
 
+    /**
+     * \brief Set the callbacks of m_socket and connect it to the server
+     */
+    void Connect ();
+
+    /**
+     * \brief Schedule the next availability change of the churn model
+     */
+    void ScheduleChurn ();
+
+    /**
+     * \brief Apply the availability change scheduled by ScheduleChurn
+     */
+    void ChurnTransition ();
+
     /**
      * \brief Begins the process of sending the model to the server
      */
@@ -102,19 +192,21 @@ namespace ns3
     void HandleRead (Ptr <Socket> socket);
 
     /**
-     * \brief Sends a packet from client to server (remote host), continues
-     *        to send packets until there are no remaining bytes to be sent.
-     * \param socket Connected socket in which to send bytes.
+     * \brief Called by the model transfer after every write to the server
+     * \param socket Connected socket
+     * \param bytes  Number of bytes written
+     */
+    void ModelSent (Ptr <Socket> socket, uint32_t bytes);
+
+    /**
+     * \brief Called by the broadcast receiver once the whole model arrived, starts training
      */
-    void Send (Ptr <Socket> socket);
+    void ModelBroadcastReceived ();
 
     /**
-     * \brief Callback used to schedule a send when TxAvailable becomes
-     *        positive
-     * \param sock       Socket that is ready to send
-     * \param available  TxAvailable
+     * \brief Starts the local training on the model received, or hands it to the model callback
      */
-    void HandleReadyToSend (Ptr <Socket> sock, uint32_t available);
+    void StartTraining ();
 
     //Set by Setup
     Ptr <Socket> m_socket;                    //!< Socket to associate with client
@@ -122,16 +214,34 @@ namespace ns3
     uint32_t m_packetSize;                    //!< Max packet size for communication from client to server
     uint32_t m_bytesModel;                    //!< Size of model that will be sent between the client and server
     DataRate m_dataRate;                      //!< Rate which data is transmitted from client to server
+    bool m_bPacing;                           //!< Pace the model transfer at m_dataRate
+    uint32_t m_pacingBurst;                   //!< Token bucket depth of the pacing, 0 for the default
 
     uint32_t m_bytesModelReceived;            //!< Number of bytes of model received
     uint32_t m_bytesModelToReceive;           //!< Number of bytes of model left to receive
     Time m_timeBeginReceivingModelFromServer; //!< Set time when receiving model from server
     Time m_timeEndReceivingModelFromServer;   //!< Set time when last message received by server
 
-    uint32_t m_bytesModelToSend;              //!< Number of bytes left to send to server
     uint32_t m_bytesSent;                     //!< Number of bytes sent to server
+    uint32_t m_bytesUpdate;                   //!< Size of the encoded update, 0 for the model size
 
-    EventId m_sendEvent;                      //!< Send event handle used to cancel a pending event
+    ModelTransfer m_transfer;                 //!< Sends the model to the server
     PerformanceSimpleModel m_model;           //!< Performance model used to calculate computational delay.
+    double m_computationTime;                 //!< Computation delay (local training time)
+    EventId m_computeEvent;                   //!< End of the local training
+
+    bool m_bOnline;                           //!< Connected or connecting
+    ChurnModel *m_churn;                      //!< Availability of the client, null if always available
+    uint32_t m_churnId;                       //!< Client id in the churn model
+    Time m_churnOffset;                       //!< Experiment time of simulation time 0
+    bool m_bResume;                           //!< Reconnect when available again
+    double m_churnTime;                       //!< Experiment time of the scheduled change
+    EventId m_churnEvent;                     //!< Next availability change
+
+    bool m_bBroadcast;                        //!< Receive the model from the server broadcast
+    Time m_nackTimeout;                       //!< Time without broadcast chunks before NACKing
+    bool m_bExpectModel;                      //!< In round, takes part in the broadcast
+    ModelBroadcastReceiver m_receiver;        //!< Receives the broadcast model
+    Callback<void> m_modelReceived;           //!< Takes the model instead of the local training, may be null
   };
 }
\ No newline at end of file
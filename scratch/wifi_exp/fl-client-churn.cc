@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-client-churn.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+    // Stream numbers of the random variables, fixed so that RngSeed and RngRun reproduce a run
+    static const int64_t CHURN_ON_STREAM = 1010;
+    static const int64_t CHURN_OFF_STREAM = 1011;
+    static const int64_t CHURN_INITIAL_STREAM = 1012;
+
+    static const uint32_t TRACE_VERSION = 1;
+
+    std::unique_ptr<ChurnModel> ChurnModel::Create(const std::string &spec, uint32_t numClients) {
+        size_t colon = spec.find(':');
+        std::string kind = spec.substr(0, colon);
+        std::string params = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+        if (kind.compare("markov") == 0) {
+            double meanOn = 600, meanOff = 300;
+            std::stringstream ss(params);
+            for (std::string item; std::getline(ss, item, ',');) {
+                size_t eq = item.find('=');
+                if (eq == std::string::npos) {
+                    return nullptr;
+                }
+                std::string key = item.substr(0, eq);
+                double value = std::atof(item.substr(eq + 1).c_str());
+                if (key.compare("on") == 0) {
+                    meanOn = value;
+                } else if (key.compare("off") == 0) {
+                    meanOff = value;
+                } else {
+                    return nullptr;
+                }
+            }
+            if (meanOn <= 0 || meanOff <= 0) {
+                return nullptr;
+            }
+            return std::unique_ptr<ChurnModel>(new MarkovChurnModel(numClients, meanOn, meanOff));
+        }
+        if (kind.compare("trace") == 0 && !params.empty()) {
+            std::unique_ptr<AvailabilityTrace> trace(new AvailabilityTrace());
+            if (!trace->Open(params)) {
+                return nullptr;
+            }
+            return std::move(trace);
+        }
+        return nullptr;
+    }
+
+    double ChurnModel::EarliestChange(uint32_t numClients, double t) {
+        double next = std::numeric_limits<double>::infinity();
+        for (uint32_t id = 0; id < numClients; id++) {
+            next = std::min(next, NextChange(id, t));
+        }
+        return next;
+    }
+
+    MarkovChurnModel::MarkovChurnModel(uint32_t numClients, double meanOn, double meanOff) :
+            m_available(numClients),
+            m_change(numClients) {
+        m_on = CreateObject<ExponentialRandomVariable>();
+        m_on->SetAttribute("Mean", DoubleValue(meanOn));
+        m_on->SetAttribute("Bound", DoubleValue(0.0));
+        m_on->SetStream(CHURN_ON_STREAM);
+
+        m_off = CreateObject<ExponentialRandomVariable>();
+        m_off->SetAttribute("Mean", DoubleValue(meanOff));
+        m_off->SetAttribute("Bound", DoubleValue(0.0));
+        m_off->SetStream(CHURN_OFF_STREAM);
+
+        Ptr<UniformRandomVariable> initial = CreateObject<UniformRandomVariable>();
+        initial->SetStream(CHURN_INITIAL_STREAM);
+
+        // Stationary start; holding times are memoryless, so the residual time is a fresh draw
+        double pOn = meanOn / (meanOn + meanOff);
+        for (uint32_t id = 0; id < numClients; id++) {
+            m_available[id] = initial->GetValue() < pOn;
+            m_change[id] = m_available[id] ? m_on->GetValue() : m_off->GetValue();
+        }
+    }
+
+    void MarkovChurnModel::Advance(uint32_t id, double t) {
+        while (m_change[id] <= t) {
+            m_available[id] = !m_available[id];
+            m_change[id] += m_available[id] ? m_on->GetValue() : m_off->GetValue();
+        }
+    }
+
+    bool MarkovChurnModel::IsAvailable(uint32_t id, double t) {
+        if (id >= m_available.size()) {
+            return true;
+        }
+        Advance(id, t);
+        return m_available[id];
+    }
+
+    double MarkovChurnModel::NextChange(uint32_t id, double t) {
+        if (id >= m_available.size()) {
+            return std::numeric_limits<double>::infinity();
+        }
+        Advance(id, t);
+        return m_change[id];
+    }
+
+    AvailabilityTrace::AvailabilityTrace() :
+            m_fd(-1),
+            m_map(MAP_FAILED),
+            m_size(0),
+            m_numClients(0),
+            m_index(nullptr),
+            m_initial(nullptr),
+            m_flips(nullptr) {
+    }
+
+    AvailabilityTrace::~AvailabilityTrace() {
+        if (m_map != MAP_FAILED) {
+            munmap(m_map, m_size);
+        }
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    bool AvailabilityTrace::Open(const std::string &path) {
+        m_fd = open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (m_fd < 0 || fstat(m_fd, &st) != 0 || (size_t) st.st_size < sizeof(Header)) {
+            NS_LOG_UNCOND("Could not open availability trace " << path);
+            return false;
+        }
+
+        m_size = st.st_size;
+        m_map = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (m_map == MAP_FAILED) {
+            NS_LOG_UNCOND("Could not map availability trace " << path);
+            return false;
+        }
+
+        const uint8_t *base = static_cast<const uint8_t *>(m_map);
+        const Header *header = reinterpret_cast<const Header *>(base);
+        if (memcmp(header->magic, "FLAV", 4) != 0 || header->version != TRACE_VERSION) {
+            NS_LOG_UNCOND("Not an availability trace " << path);
+            return false;
+        }
+
+        uint64_t n = header->numClients;
+        size_t indexBytes = (n + 1) * sizeof(uint64_t);
+        size_t initialBytes = (n + 7) & ~(uint64_t) 7;
+        // numFlips is checked first so that its byte count cannot overflow
+        if (header->numFlips > m_size / sizeof(double) ||
+            m_size != sizeof(Header) + indexBytes + initialBytes + header->numFlips * sizeof(double)) {
+            NS_LOG_UNCOND("Truncated availability trace " << path);
+            return false;
+        }
+
+        // The flips of each client are read between consecutive offsets
+        const uint64_t *index = reinterpret_cast<const uint64_t *>(base + sizeof(Header));
+        bool valid = index[0] == 0 && index[n] == header->numFlips;
+        for (uint64_t id = 0; valid && id < n; id++) {
+            valid = index[id] <= index[id + 1];
+        }
+        if (!valid) {
+            NS_LOG_UNCOND("Corrupt availability trace " << path);
+            return false;
+        }
+
+        m_numClients = n;
+        m_index = index;
+        m_initial = base + sizeof(Header) + indexBytes;
+        m_flips = reinterpret_cast<const double *>(base + sizeof(Header) + indexBytes + initialBytes);
+        return true;
+    }
+
+    uint32_t AvailabilityTrace::GetNumClients() const {
+        return m_numClients;
+    }
+
+    bool AvailabilityTrace::IsAvailable(uint32_t id, double t) {
+        if (id >= m_numClients) {
+            return true;
+        }
+        const double *begin = m_flips + m_index[id];
+        const double *end = m_flips + m_index[id + 1];
+        // Each flip at or before t toggles the initial state
+        size_t flips = std::upper_bound(begin, end, t) - begin;
+        return (m_initial[id] != 0) ^ (flips & 1);
+    }
+
+    double AvailabilityTrace::NextChange(uint32_t id, double t) {
+        if (id >= m_numClients) {
+            return std::numeric_limits<double>::infinity();
+        }
+        const double *begin = m_flips + m_index[id];
+        const double *end = m_flips + m_index[id + 1];
+        const double *next = std::upper_bound(begin, end, t);
+        return next == end ? std::numeric_limits<double>::infinity() : *next;
+    }
+
+    bool AvailabilityTrace::Convert(const std::string &csv, const std::string &out, double minBattery) {
+        std::ifstream in(csv);
+        if (!in) {
+            NS_LOG_UNCOND("Could not open " << csv);
+            return false;
+        }
+
+        // <client, time, available>
+        std::vector<std::tuple<uint32_t, double, bool> > samples;
+        uint32_t numClients = 0;
+        int lineNo = 0;
+        for (std::string line; std::getline(in, line);) {
+            lineNo++;
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            std::vector<double> fields;
+            std::stringstream ss(line);
+            for (std::string field; std::getline(ss, field, ',');) {
+                fields.push_back(std::atof(field.c_str()));
+            }
+
+            bool available;
+            if (fields.size() == 3) {
+                available = fields[2] != 0;
+            } else if (fields.size() == 5) {
+                available = fields[4] != 0 && (fields[3] != 0 || fields[2] >= minBattery);
+            } else {
+                NS_LOG_UNCOND("Invalid availability sample at " << csv << ":" << lineNo);
+                return false;
+            }
+
+            if (fields[0] < 0 || fields[0] >= std::numeric_limits<uint32_t>::max()) {
+                NS_LOG_UNCOND("Invalid client id at " << csv << ":" << lineNo);
+                return false;
+            }
+            uint32_t id = (uint32_t) fields[0];
+            samples.emplace_back(id, fields[1], available);
+            numClients = std::max(numClients, id + 1);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        std::vector<uint64_t> index(numClients + 1, 0);
+        std::vector<uint8_t> initial((numClients + 7) & ~7u, 1);
+        std::vector<double> flips;
+        size_t s = 0;
+        for (uint32_t id = 0; id < numClients; id++) {
+            index[id] = flips.size();
+            bool state = true;
+            for (; s < samples.size() && std::get<0>(samples[s]) == id; s++) {
+                if (std::get<2>(samples[s]) != state) {
+                    state = !state;
+                    flips.push_back(std::get<1>(samples[s]));
+                }
+            }
+        }
+        index[numClients] = flips.size();
+
+        Header header;
+        memcpy(header.magic, "FLAV", 4);
+        header.version = TRACE_VERSION;
+        header.numClients = numClients;
+        header.reserved = 0;
+        header.numFlips = flips.size();
+
+        FILE *fp = fopen(out.c_str(), "wb");
+        if (!fp) {
+            NS_LOG_UNCOND("Could not open " << out);
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+                  fwrite(index.data(), sizeof(uint64_t), index.size(), fp) == index.size() &&
+                  fwrite(initial.data(), 1, initial.size(), fp) == initial.size() &&
+                  fwrite(flips.data(), sizeof(double), flips.size(), fp) == flips.size();
+        ok = (fclose(fp) == 0) && ok;
+        return ok;
+    }
+}
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_CLIENT_CHURN_H
+#define FL_CLIENT_CHURN_H
+
+#include "ns3/random-variable-stream.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-client
+    * \brief Tells when each client is available (powered, connected and willing to train)
+    *
+    * Times are experiment seconds, continuous across rounds. Queries for a client are
+    * expected at non-decreasing times; models may answer earlier times approximately.
+    */
+    class ChurnModel {
+    public:
+        virtual ~ChurnModel() {}
+
+        /**
+        * \brief Get if a client is available
+        * \param id  Client id
+        * \param t   Experiment time (s)
+        * \return True if available at t
+        */
+        virtual bool IsAvailable(uint32_t id, double t) = 0;
+
+        /**
+        * \brief Get when the availability of a client changes next
+        * \param id  Client id
+        * \param t   Experiment time (s)
+        * \return First change strictly after t, infinity if there is none
+        */
+        virtual double NextChange(uint32_t id, double t) = 0;
+
+        /**
+        * \brief Get when the availability of any client changes next
+        * \param numClients  Number of clients, ids 0 .. numClients - 1
+        * \param t           Experiment time (s)
+        * \return First change strictly after t, infinity if there is none
+        */
+        double EarliestChange(uint32_t numClients, double t);
+
+        /**
+        * \brief Create a churn model
+        * \param spec        "markov[:on=<mean s>,off=<mean s>]" or "trace:<file>" (see AvailabilityTrace)
+        * \param numClients  Number of clients
+        * \return The model, null if the specification is invalid or the trace can not be opened
+        */
+        static std::unique_ptr<ChurnModel> Create(const std::string &spec, uint32_t numClients);
+    };
+
+    /**
+    * \ingroup fl-client
+    * \brief Two state on/off Markov model with exponential holding times
+    *
+    * Each client starts in the stationary distribution and its next change is drawn when
+    * the previous one is passed. The state is kept as parallel arrays, so the model costs
+    * a few bytes per client. The draws follow RngSeed and RngRun.
+    */
+    class MarkovChurnModel : public ChurnModel {
+    public:
+        /**
+        * \param numClients  Number of clients
+        * \param meanOn      Mean time available (s)
+        * \param meanOff     Mean time unavailable (s)
+        */
+        MarkovChurnModel(uint32_t numClients, double meanOn, double meanOff);
+
+        bool IsAvailable(uint32_t id, double t) override;
+        double NextChange(uint32_t id, double t) override;
+
+    private:
+        /**
+        * \brief Step the client's chain until its next change is after t
+        */
+        void Advance(uint32_t id, double t);
+
+        Ptr<ExponentialRandomVariable> m_on;    //!< Holding time when available
+        Ptr<ExponentialRandomVariable> m_off;   //!< Holding time when unavailable
+        std::vector<uint8_t> m_available;       //!< Current state of each client
+        std::vector<double> m_change;           //!< Time the current state ends
+    };
+
+    /**
+    * \ingroup fl-client
+    * \brief Memory-mapped, time-indexed availability trace
+    *
+    * The file holds, for every client, the sorted times at which its availability flips.
+    * It is mapped read-only and each query is a binary search within the client's slice,
+    * so only the pages of the clients that are looked up are read from disk. Clients past
+    * the end of the trace are always available. Layout (little endian):
+    *
+    *   Header                      magic "FLAV", version, number of clients, number of flips
+    *   uint64_t index[n + 1]       first flip of each client, index[n] is the number of flips
+    *   uint8_t  initial[n]         availability before the first flip, padded to 8 bytes
+    *   double   flips[]            flip times (s), grouped by client and sorted
+    *
+    * Convert builds the file from a CSV trace of device state samples.
+    */
+    class AvailabilityTrace : public ChurnModel {
+    public:
+        /**
+        * \brief File header
+        */
+        struct Header {
+            char magic[4];          //!< "FLAV"
+            uint32_t version;       //!< Format version, 1
+            uint32_t numClients;    //!< Number of clients
+            uint32_t reserved;      //!< Zero
+            uint64_t numFlips;      //!< Number of flips of all clients
+        };
+
+        AvailabilityTrace();
+        ~AvailabilityTrace();
+
+        /**
+        * \brief Map a trace
+        * \param path  Trace file
+        * \return False if it can not be opened or is malformed
+        */
+        bool Open(const std::string &path);
+
+        /**
+        * \brief Get number of clients of the trace
+        * \return Number of clients
+        */
+        uint32_t GetNumClients() const;
+
+        bool IsAvailable(uint32_t id, double t) override;
+        double NextChange(uint32_t id, double t) override;
+
+        /**
+        * \brief Build a trace from a CSV file
+        *
+        * Lines are "client,time,available" or "client,time,battery,charging,wifi", blank
+        * lines and lines starting with '#' are skipped. With device state samples a client
+        * is available when Wi-Fi is connected and it is charging or its battery (%) is at
+        * least minBattery. A client is available until its first sample.
+        * \param csv         Input file
+        * \param out         Output trace
+        * \param minBattery  Lowest battery level at which a client trains on battery (%)
+        * \return False if the input can not be read, has a negative client id, or the output can not be written
+        */
+        static bool Convert(const std::string &csv, const std::string &out, double minBattery);
+
+    private:
+        int m_fd;                       //!< Mapped file
+        void *m_map;                    //!< Mapping
+        size_t m_size;                  //!< Mapping size
+        uint32_t m_numClients;          //!< Number of clients
+        const uint64_t *m_index;        //!< First flip of each client
+        const uint8_t *m_initial;       //!< Availability before the first flip
+        const double *m_flips;          //!< Flip times
+    };
+}
+
+#endif
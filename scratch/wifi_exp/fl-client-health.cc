@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-client-health.h"
+#include "ns3/boolean.h"
+#include "ns3/object-factory.h"
+#include "ns3/device-coefficients.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+    // Temperature step of AppPowerModel (seconds)
+    static const double TEMPERATURE_TICK = 0.01;
+
+    ClientHealth::ClientHealth(const std::string &deviceType, double ambient, double throttleTemperature,
+                               double throttleSlope) :
+            m_throttleTemperature(throttleTemperature),
+            m_throttleSlope(throttleSlope),
+            m_power(0),
+            m_lastReliability(1.0),
+            m_clock(0),
+            m_nextTick(Seconds(TEMPERATURE_TICK)) {
+        uint32_t device = DeviceCoefficients::FindDevice(deviceType);
+        if (device == DeviceCoefficients::NONE) {
+            NS_FATAL_ERROR("ClientHealth:Undefined device type: " << deviceType);
+        }
+        m_idlePowerW = DeviceCoefficients::GetDevice(device).idlePowerW;
+
+        m_temperature = CreateObject<TemperatureSimpleModel>();
+        m_temperature->SetTenv(ambient);
+        m_temperature->SetDeviceType(deviceType);
+        m_temperature->SetAdvanceCallback(MakeCallback(&ClientHealth::Advance, this));
+
+        // Lazy, so it schedules nothing and only moves when the temperature model is brought forward
+        m_reliability = CreateObjectWithAttributes<ReliabilityTDDBModel>("Lazy", BooleanValue(true));
+        m_reliability->RegisterTemperatureModel(m_temperature);
+        // GetReliability would bring the stack to the simulator time, follow the trace instead
+        m_reliability->TraceConnectWithoutContext("Reliability",
+                                                  MakeCallback(&ClientHealth::ReliabilityChanged, this));
+    }
+
+    ClientHealth::~ClientHealth() {
+        m_reliability->Dispose();
+        m_temperature->Dispose();
+    }
+
+    void ClientHealth::Run(double busy, double busyPower, double idle) {
+        m_power = busyPower;
+        m_clock += Seconds(busy);
+        m_temperature->Update(m_clock);
+
+        m_power = m_idlePowerW;
+        m_clock += Seconds(idle);
+        m_temperature->Update(m_clock);
+    }
+
+    void ClientHealth::Advance(Time t) {
+        if (t <= m_nextTick) {
+            return;
+        }
+        int64_t interval = Seconds(TEMPERATURE_TICK).GetTimeStep();
+        int64_t steps = ((t - m_nextTick).GetTimeStep() + interval - 1) / interval;
+        m_temperature->UpdateTemperature(m_power, steps);
+        m_nextTick += TimeStep(steps * interval);
+    }
+
+    void ClientHealth::ReliabilityChanged(double oldValue, double newValue) {
+        m_lastReliability = newValue;
+    }
+
+    double ClientHealth::GetSlowdown() const {
+        double throttle = 1.0 + m_throttleSlope * std::max(0.0, GetTemperature() - m_throttleTemperature);
+        return throttle / std::max(m_lastReliability, 1e-3);
+    }
+
+    double ClientHealth::GetTemperature() const {
+        return m_temperature->GetTemperature();
+    }
+
+    double ClientHealth::GetReliability() const {
+        return m_lastReliability;
+    }
+
+    bool ClientHealth::IsHealthy(double minReliability) const {
+        return GetTemperature() <= m_throttleTemperature && m_lastReliability >= minReliability;
+    }
+}
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_CLIENT_HEALTH_H
+#define FL_CLIENT_HEALTH_H
+
+#include "ns3/nstime.h"
+#include "ns3/temperature-simple-model.h"
+#include "ns3/reliability-tddb-model.h"
+
+#include <string>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-client-session
+    * \brief Temperature and reliability of one client device across rounds
+    *
+    * Owns a TemperatureSimpleModel and a ReliabilityTDDBModel in lazy mode, driven by
+    * the client's own clock rather than the simulator's: every engine (packet, persistent
+    * or analytic) reports each round as a busy period at the training power followed by
+    * an idle period. The temperature steps every 10 ms as with AppPowerModel and the
+    * reliability every 30 s, batched by TemperatureModel::Update.
+    *
+    * Above the throttle temperature the training time grows by ThrottleSlope per degree,
+    * and it is further divided by the reliability (a worn device needs retries).
+    */
+    class ClientHealth {
+    public:
+        /**
+        * \brief Construct the stack
+        * \param deviceType           Device type known to DeviceCoefficients, gives the thermal
+        *                             coefficients and the idle power
+        * \param ambient              Ambient temperature (C)
+        * \param throttleTemperature  Temperature above which training slows down (C)
+        * \param throttleSlope        Fraction of training time added per degree above it
+        */
+        ClientHealth(const std::string &deviceType, double ambient, double throttleTemperature,
+                     double throttleSlope);
+
+        ~ClientHealth();
+
+        /**
+        * \brief Advance the stack over one round
+        * \param busy       Seconds spent training
+        * \param busyPower  Power while training (W)
+        * \param idle       Seconds spent idle after training
+        */
+        void Run(double busy, double busyPower, double idle);
+
+        /**
+        * \brief Get the factor applied to the training time
+        * \return 1 for a cool, new device, larger otherwise
+        */
+        double GetSlowdown() const;
+
+        /**
+        * \brief Get the current temperature
+        * \return Temperature (C)
+        */
+        double GetTemperature() const;
+
+        /**
+        * \brief Get the current reliability
+        * \return Reliability, 1 for a new device
+        */
+        double GetReliability() const;
+
+        /**
+        * \brief Get if the client is throttled or worn
+        * \param minReliability  Reliability below which the client is considered worn
+        * \return True if neither
+        */
+        bool IsHealthy(double minReliability) const;
+
+    private:
+        /**
+        * \brief Advance callback of the temperature model, applies the ticks before t
+        */
+        void Advance(Time t);
+
+        /**
+        * \brief Reliability trace sink
+        */
+        void ReliabilityChanged(double oldValue, double newValue);
+
+        Ptr<TemperatureSimpleModel> m_temperature;   //!< Temperature model
+        Ptr<ReliabilityTDDBModel> m_reliability;     //!< Reliability model, updated at the checkpoints
+        double m_idlePowerW;                         //!< Power while idle
+        double m_throttleTemperature;                //!< Temperature above which training slows down
+        double m_throttleSlope;                      //!< Slowdown per degree above the throttle temperature
+        double m_power;                              //!< Power of the period being applied
+        double m_lastReliability;                    //!< Reliability after the last update
+        Time m_clock;                                //!< Client time covered so far
+        Time m_nextTick;                             //!< Time of the next temperature step
+    };
+}
+
+#endif
@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-client-profile.h"
+#include "ns3/data-rate.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace ns3 {
+
+    // Stream numbers of the random variables, fixed so that RngSeed and RngRun reproduce a run
+    static const int64_t RATE_STREAM = 1000;
+    static const int64_t COMPUTE_STREAM = 1001;
+    static const int64_t AVAILABILITY_STREAM = 1002;
+    static const int64_t PARTICIPATION_STREAM = 1003;
+
+    static const char *wifi_strings[] =
+            {
+                    "75kbps",
+                    "125kbps",
+                    "150kbps",
+                    "160kbps",
+                    "175kbps",
+                    "200kbps",
+            };
+
+    static const char *ethernet_strings[] =
+            {
+                    "80kbps",
+                    "160kbps",
+                    "320kbps",
+                    "640kbps",
+                    "1024kbps",
+                    "2048kbps",
+            };
+
+    void ClientProfiles::Resize(uint32_t n) {
+        dataRate.resize(n);
+        computeScale.resize(n, 1.0f);
+        availability.resize(n, 1.0f);
+    }
+
+    uint32_t ClientProfiles::GetN() const {
+        return dataRate.size();
+    }
+
+    void ClientProfiles::DrawParticipation(std::map<int, std::shared_ptr<ClientSession> > &clients) {
+        if (!m_participation) {
+            m_participation = CreateObject<UniformRandomVariable>();
+            m_participation->SetStream(PARTICIPATION_STREAM);
+        }
+
+        for (auto &itr: clients) {
+            double p = (uint32_t) itr.first < GetN() ? availability[itr.first] : 1.0;
+            // Always draw, so that the sequence does not depend on the availabilities
+            itr.second->SetInRound(m_participation->GetValue() < p);
+        }
+    }
+
+    /**
+    * \brief The six historical rates in turn
+    */
+    class CycleProfileGenerator : public ClientProfileGenerator {
+    public:
+        explicit CycleProfileGenerator(bool bWifi) :
+                m_strings(bWifi ? wifi_strings : ethernet_strings) {
+        }
+
+        bool Generate(uint32_t n, ClientProfiles &profiles) override {
+            profiles.Resize(n);
+            for (uint32_t id = 0; id < n; id++) {
+                // Client id uses the rate of node id + 1, as the network builders always did
+                profiles.dataRate[id] = DataRate(m_strings[(id + 1) % 6]).GetBitRate();
+                profiles.computeScale[id] = 1.0f;
+                profiles.availability[id] = 1.0f;
+            }
+            return true;
+        }
+
+    private:
+        const char **m_strings;   //!< Rate table of the network type
+    };
+
+    /**
+    * \brief Log-normal rates and compute scales, uniform availability
+    */
+    class RandomProfileGenerator : public ClientProfileGenerator {
+    public:
+        RandomProfileGenerator() :
+                m_rate(160000),
+                m_rateSigma(0.5),
+                m_computeSigma(0.3),
+                m_availability(1.0) {
+        }
+
+        bool Parse(const std::string &params) {
+            std::stringstream ss(params);
+            for (std::string item; std::getline(ss, item, ',');) {
+                size_t eq = item.find('=');
+                if (eq == std::string::npos) {
+                    return false;
+                }
+                std::string key = item.substr(0, eq);
+                std::istringstream value(item.substr(eq + 1));
+                if (key.compare("rate") == 0) {
+                    DataRate rate;
+                    value >> rate;
+                    m_rate = rate.GetBitRate();
+                } else if (key.compare("rateSigma") == 0) {
+                    value >> m_rateSigma;
+                } else if (key.compare("computeSigma") == 0) {
+                    value >> m_computeSigma;
+                } else if (key.compare("availability") == 0) {
+                    value >> m_availability;
+                } else {
+                    return false;
+                }
+                if (value.fail()) {
+                    return false;
+                }
+            }
+            return m_rate > 0 && m_rateSigma >= 0 && m_computeSigma >= 0 &&
+                   m_availability >= 0 && m_availability <= 1;
+        }
+
+        bool Generate(uint32_t n, ClientProfiles &profiles) override {
+            Ptr<LogNormalRandomVariable> rate = CreateObject<LogNormalRandomVariable>();
+            rate->SetAttribute("Mu", DoubleValue(std::log((double) m_rate)));
+            rate->SetAttribute("Sigma", DoubleValue(m_rateSigma));
+            rate->SetStream(RATE_STREAM);
+
+            Ptr<LogNormalRandomVariable> compute = CreateObject<LogNormalRandomVariable>();
+            compute->SetAttribute("Mu", DoubleValue(0.0));
+            compute->SetAttribute("Sigma", DoubleValue(m_computeSigma));
+            compute->SetStream(COMPUTE_STREAM);
+
+            Ptr<UniformRandomVariable> availability = CreateObject<UniformRandomVariable>();
+            availability->SetAttribute("Min", DoubleValue(m_availability));
+            availability->SetAttribute("Max", DoubleValue(1.0));
+            availability->SetStream(AVAILABILITY_STREAM);
+
+            profiles.Resize(n);
+            for (uint32_t id = 0; id < n; id++) {
+                // At least 1 kbps, a lower rate would not finish a round
+                profiles.dataRate[id] = std::max<uint64_t>(1000, (uint64_t) rate->GetValue());
+            }
+            for (uint32_t id = 0; id < n; id++) {
+                profiles.computeScale[id] = compute->GetValue();
+            }
+            for (uint32_t id = 0; id < n; id++) {
+                profiles.availability[id] = availability->GetValue();
+            }
+            return true;
+        }
+
+    private:
+        uint64_t m_rate;          //!< Median data rate (bps)
+        double m_rateSigma;       //!< Sigma of the log of the data rate
+        double m_computeSigma;    //!< Sigma of the log of the compute scale
+        double m_availability;    //!< Lowest availability
+    };
+
+    /**
+    * \brief Per-client values read from a file
+    */
+    class TraceProfileGenerator : public ClientProfileGenerator {
+    public:
+        explicit TraceProfileGenerator(const std::string &path) :
+                m_path(path) {
+        }
+
+        bool Generate(uint32_t n, ClientProfiles &profiles) override {
+            std::ifstream in(m_path);
+            if (!in) {
+                NS_LOG_UNCOND("Could not open client profile trace " << m_path);
+                return false;
+            }
+
+            ClientProfiles trace;
+            int lineNo = 0;
+            for (std::string line; std::getline(in, line);) {
+                lineNo++;
+                if (line.empty() || line[0] == '#') {
+                    continue;
+                }
+
+                std::stringstream ss(line);
+                std::string rateField, computeField, availabilityField;
+                std::getline(ss, rateField, ',');
+                std::getline(ss, computeField, ',');
+                std::getline(ss, availabilityField, ',');
+
+                std::istringstream rateStream(rateField);
+                DataRate rate;
+                rateStream >> rate;
+                double compute = computeField.empty() ? 1.0 : std::atof(computeField.c_str());
+                double availability = availabilityField.empty() ? 1.0 : std::atof(availabilityField.c_str());
+                if (rateStream.fail() || rate.GetBitRate() == 0 || compute <= 0 ||
+                    availability < 0 || availability > 1) {
+                    NS_LOG_UNCOND("Invalid client profile at " << m_path << ":" << lineNo);
+                    return false;
+                }
+
+                trace.dataRate.push_back(rate.GetBitRate());
+                trace.computeScale.push_back(compute);
+                trace.availability.push_back(availability);
+            }
+
+            if (trace.GetN() == 0) {
+                NS_LOG_UNCOND("Client profile trace " << m_path << " is empty");
+                return false;
+            }
+
+            profiles.Resize(n);
+            for (uint32_t id = 0; id < n; id++) {
+                uint32_t row = id % trace.GetN();
+                profiles.dataRate[id] = trace.dataRate[row];
+                profiles.computeScale[id] = trace.computeScale[row];
+                profiles.availability[id] = trace.availability[row];
+            }
+            return true;
+        }
+
+    private:
+        std::string m_path;   //!< Trace file
+    };
+
+    std::unique_ptr<ClientProfileGenerator> ClientProfileGenerator::Create(const std::string &spec, bool bWifi) {
+        size_t colon = spec.find(':');
+        std::string kind = spec.substr(0, colon);
+        std::string params = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+        if (kind.compare("cycle") == 0) {
+            return std::unique_ptr<ClientProfileGenerator>(new CycleProfileGenerator(bWifi));
+        }
+        if (kind.compare("random") == 0) {
+            std::unique_ptr<RandomProfileGenerator> generator(new RandomProfileGenerator());
+            if (!generator->Parse(params)) {
+                return nullptr;
+            }
+            return std::move(generator);
+        }
+        if (kind.compare("trace") == 0 && !params.empty()) {
+            return std::unique_ptr<ClientProfileGenerator>(new TraceProfileGenerator(params));
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_CLIENT_PROFILE_H
+#define FL_CLIENT_PROFILE_H
+
+#include "ns3/random-variable-stream.h"
+#include "fl-client-session.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-client-session
+    * \brief Link rate, compute speed and availability of every client
+    *
+    * Stored as parallel arrays indexed by client id so that fleets of many thousand
+    * clients stay compact and are walked with contiguous loops.
+    */
+    class ClientProfiles {
+    public:
+        /**
+        * \brief Resize every array
+        * \param n  Number of clients
+        */
+        void Resize(uint32_t n);
+
+        /**
+        * \brief Get number of clients
+        * \return Number of clients
+        */
+        uint32_t GetN() const;
+
+        /**
+        * \brief Put each client in the round with its availability as probability
+        * Used when no flsim selects the clients. The draws come from a stream seeded by
+        * RngSeedManager, so a run is reproduced by its RngSeed and RngRun.
+        * \param clients  map of <client, client sessions>
+        */
+        void DrawParticipation(std::map<int, std::shared_ptr<ClientSession> > &clients);
+
+        std::vector<uint64_t> dataRate;       //!< Uplink application data rate (bps)
+        std::vector<float> computeScale;      //!< Factor applied to the computation time of the energy profile
+        std::vector<float> availability;      //!< Probability of being available for a round
+
+    private:
+        Ptr<UniformRandomVariable> m_participation;   //!< Stream of the participation draws
+    };
+
+    /**
+    * \ingroup fl-client-session
+    * \brief Fills ClientProfiles for a fleet of clients
+    *
+    * Generators are built from a specification "<kind>[:<parameters>]":
+    *  - "cycle": the six historical rates in turn, full speed and always available.
+    *  - "random[:key=value,...]": log-normal rates and compute scales and uniform availability.
+    *    The keys are rate (median, e.g. 160kbps), rateSigma, computeSigma (sigma of the log of
+    *    the compute scale, median 1) and availability (lower bound, upper bound 1).
+    *  - "trace:<file>": one "rate,computeScale,availability" CSV line per client, e.g.
+    *    "150kbps,1.2,0.9". Lines are reused in turn when there are more clients than lines.
+    */
+    class ClientProfileGenerator {
+    public:
+        virtual ~ClientProfileGenerator() {}
+
+        /**
+        * \brief Fill the profiles of n clients
+        * \param n         Number of clients
+        * \param profiles  Profiles to fill, resized to n
+        * \return False if the profiles could not be produced
+        */
+        virtual bool Generate(uint32_t n, ClientProfiles &profiles) = 0;
+
+        /**
+        * \brief Create a generator
+        * \param spec   Generator specification, see the class description
+        * \param bWifi  True for the wifi network, selects the rates of "cycle"
+        * \return The generator, null if the specification is invalid
+        */
+        static std::unique_ptr<ClientProfileGenerator> Create(const std::string &spec, bool bWifi);
+    };
+}
+
+#endif
@@ -24,12 +24,16 @@
  */
 
 #include "fl-client-session.h"
+#include "fl-client-health.h"
+#include "fl-energy.h"
+#include "ns3/assert.h"
 
 namespace ns3 {
 
     ClientSession::ClientSession(int clientID_, double radius_, double theta_) :
             m_client(nullptr), m_radius(radius_), m_theta(theta_), m_clientID(clientID_), m_cycle(0), m_inRound(true),
-            m_dropOut(false)
+            m_dropOut(false), m_energyProfile(0), m_compressionRatio(0), m_updateBytes(0), m_encodeTime(0),
+            m_decodeTime(0)
     {
 
     }
@@ -54,6 +58,16 @@ namespace ns3 {
         m_inRound=inRound;
     }
 
+    bool ClientSession::GetDropOut()
+    {
+        return m_dropOut;
+    }
+
+    void ClientSession::SetDropOut(bool dropOut)
+    {
+        m_dropOut=dropOut;
+    }
+
     int ClientSession::GetCycle()
     {
         return m_cycle;
@@ -83,29 +97,150 @@ namespace ns3 {
         return m_clientID;
     }
 
+    uint32_t ClientSession::GetEnergyProfile()
+    {
+        return m_energyProfile;
+    }
 
+    void ClientSession::SetEnergyProfile(uint32_t profile)
+    {
+        m_energyProfile=profile;
+    }
 
+    double ClientSession::GetComputationTime()
+    {
+        double computationTime = FLEnergy::GetProfile(m_energyProfile).computationTime;
+        if (m_health) {
+            computationTime *= m_health->GetSlowdown();
+        }
+        return computationTime;
+    }
+
+    ClientHealth *ClientSession::GetHealth()
+    {
+        return m_health.get();
+    }
+
+    void ClientSession::SetHealth(std::shared_ptr<ClientHealth> health)
+    {
+        m_health=health;
+    }
+
+    double ClientSession::GetCompressionRatio()
+    {
+        return m_compressionRatio;
+    }
+
+    void ClientSession::SetCompressionRatio(double ratio)
+    {
+        m_compressionRatio=ratio;
+    }
+
+    void ClientSession::SetUpdate(uint32_t bytes, double encodeTime, double decodeTime)
+    {
+        m_updateBytes=bytes;
+        m_encodeTime=encodeTime;
+        m_decodeTime=decodeTime;
+    }
+
+    uint32_t ClientSession::GetUpdateBytes()
+    {
+        return m_updateBytes;
+    }
+
+    double ClientSession::GetEncodeTime()
+    {
+        return m_encodeTime;
+    }
+
+    double ClientSession::GetDecodeTime()
+    {
+        return m_decodeTime;
+    }
 
 
-    ClientSessionManager::ClientSessionManager(std::map<int, std::shared_ptr<ClientSession> > &inn) :
-            m_clientSessionById(inn), m_nInRound(0), m_nInRoundFirstCycleDone(0) {
-        for (auto itr = m_clientSessionById.begin(); itr != m_clientSessionById.end(); itr++) {
+
+
+
+    ClientSessionManager::ClientSessionManager(std::map<int, std::shared_ptr<ClientSession> > &inn,
+                                               bool allConnected) :
+            m_nInRound(0), m_nInRoundFirstCycleDone(0) {
+        if (!inn.empty()) {
+            m_clientSessionById.resize(inn.rbegin()->first + 1);
+        }
+        m_clientSessionByAddress.reserve(inn.size());
+        m_clientSessionByNode.reserve(inn.size());
+
+        for (auto itr = inn.begin(); itr != inn.end(); itr++) {
+            m_clientSessionById[itr->first] = itr->second;
+            if (itr->second->GetInRound() || allConnected) {
+                auto node = itr->second->GetClient()->GetNode();
+                auto ipv4 = node->GetObject<ns3::Ipv4>();
+
+                // Edge aggregators reach the root on their backhaul, not their first interface
+                for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++) {
+                    m_clientSessionByAddress[ipv4->GetAddress(i, 0).GetLocal()] = itr->second->GetClientId();
+                }
+                m_clientSessionByNode[node->GetId()] = itr->second->GetClientId();
+            }
             if (itr->second->GetInRound()) {
-                auto clientAddress = itr->second->GetClient()->GetNode()->
-                        GetObject<ns3::Ipv4>()->GetAddress(1, 0).GetLocal();
+                m_nInRound++;
+            }
+        }
+    }
 
-                m_clientSessionByAddress[clientAddress] = itr->second->GetClientId();
+    void ClientSessionManager::BeginRound() {
+        m_nInRound = 0;
+        m_nInRoundFirstCycleDone = 0;
+        for (auto &session: m_clientSessionById) {
+            if (session && session->GetInRound()) {
                 m_nInRound++;
             }
         }
     }
 
+    bool ClientSessionManager::IsInRound(ns3::Ptr<ns3::Socket> socket) {
+        auto id = ResolveToIdFromServer(socket);
+        if (id < 0) {
+            return false;
+        }
+        return m_clientSessionById[id]->GetInRound();
+    }
+
+    int ClientSessionManager::GetNumInRound() {
+        return m_nInRound;
+    }
+
     int ClientSessionManager::ResolveToId(ns3::Ipv4Address &address) {
-        return m_clientSessionByAddress[address];
+        auto found = m_clientSessionByAddress.find(address);
+        return (found == m_clientSessionByAddress.end()) ? -1 : found->second;
+    }
+
+    int ClientSessionManager::ResolveToIdFromNode(uint32_t nodeId) {
+        auto found = m_clientSessionByNode.find(nodeId);
+        return (found == m_clientSessionByNode.end()) ? -1 : found->second;
+    }
+
+    uint32_t ClientSessionManager::GetEnergyProfile(int id) {
+        NS_ASSERT_MSG(id >= 0 && (size_t) id < m_clientSessionById.size(), "Unknown client " << id);
+        return m_clientSessionById[id]->GetEnergyProfile();
+    }
+
+    uint32_t ClientSessionManager::GetUpdateBytes(int id) {
+        NS_ASSERT_MSG(id >= 0 && (size_t) id < m_clientSessionById.size(), "Unknown client " << id);
+        return m_clientSessionById[id]->GetUpdateBytes();
+    }
+
+    double ClientSessionManager::GetDecodeTime(int id) {
+        NS_ASSERT_MSG(id >= 0 && (size_t) id < m_clientSessionById.size(), "Unknown client " << id);
+        return m_clientSessionById[id]->GetDecodeTime();
     }
 
     void ClientSessionManager::IncrementCycleCountFromServer(ns3::Ptr<ns3::Socket> socket) {
         auto id = ResolveToIdFromServer(socket);
+        if (id < 0) {
+            return;
+        }
         if (m_clientSessionById[id]->GetCycle() == 0) {
             m_nInRoundFirstCycleDone++;
         }
@@ -119,6 +254,9 @@ namespace ns3 {
 
     int ClientSessionManager::GetRound(ns3::Ptr<ns3::Socket> socket) {
         auto id = ResolveToIdFromServer(socket);
+        if (id < 0) {
+            return -1;
+        }
         return m_clientSessionById[id]->GetCycle();
     }
 
@@ -126,28 +264,52 @@ namespace ns3 {
 
 
     int ClientSessionManager::ResolveToIdFromServer(ns3::Ptr<ns3::Socket> socket) {
+        auto found = m_clientSessionBySocket.find(ns3::PeekPointer(socket));
+        if (found != m_clientSessionBySocket.end()) {
+            return found->second;
+        }
+
         ns3::Address addr;
         socket->GetPeerName(addr);
         auto temp = ns3::InetSocketAddress::ConvertFrom(addr).GetIpv4();
-        return ResolveToId(temp);
+        int id = ResolveToId(temp);
+        if (id >= 0) {
+            m_clientSessionBySocket[ns3::PeekPointer(socket)] = id;
+        }
+        return id;
 
     }
 
     void ClientSessionManager::Close() {
-        for (auto itr = m_clientSessionById.begin(); itr != m_clientSessionById.end(); itr++) {
-            if (itr->second->GetInRound()) {
-                itr->second->GetClient()->Close();
+        for (auto &session: m_clientSessionById) {
+            if (session && session->GetInRound()) {
+                session->GetClient()->Close();
             }
         }
     }
 
 
     ns3::Ipv4Address ClientSessionManager::ResolveToAddress(int id) {
+        NS_ASSERT_MSG(id >= 0 && (size_t) id < m_clientSessionById.size(), "Unknown client " << id);
         return m_clientSessionById[id]->GetClient()->GetNode()->
                 GetObject<ns3::Ipv4>()->GetAddress(1, 0).GetLocal();
     }
 
+    void ClientSessionManager::SetDropOut(int id) {
+        NS_ASSERT_MSG(id >= 0 && (size_t) id < m_clientSessionById.size(), "Unknown client " << id);
+        m_clientSessionById[id]->SetDropOut(true);
+    }
 
+    bool ClientSessionManager::IsDropOut(ns3::Ptr<ns3::Socket> socket) {
+        auto id = ResolveToIdFromServer(socket);
+        if (id < 0) {
+            return false;
+        }
+        return m_clientSessionById[id]->GetDropOut();
+    }
 
-}
+    void ClientSessionManager::Forget(ns3::Ptr<ns3::Socket> socket) {
+        m_clientSessionBySocket.erase(ns3::PeekPointer(socket));
+    }
 
+}
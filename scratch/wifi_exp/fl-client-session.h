@@ -40,9 +40,12 @@
 #include <cstring>
 #include<memory>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3 {
     class Socket;
+    class ClientHealth;
 
     /**
    * \ingroup fl-client-session
@@ -82,6 +85,18 @@ namespace ns3 {
         */
         void SetInRound(bool inRound);
 
+        /**
+        * \brief Get if client dropped out of the round (disconnected or timed out)
+        * \return True if the client dropped out
+        */
+        bool GetDropOut();
+
+        /**
+        * \brief Set if client dropped out of the round
+        * \param dropOut   True if the client dropped out
+        */
+        void SetDropOut(bool dropOut);
+
         /**
         * \brief Get cycle number representing how many times client has participated in round (async)
         * \return cycle number that a client is on
@@ -117,6 +132,73 @@ namespace ns3 {
         */
         int GetClientId();
 
+        /**
+        * \brief Get energy profile of client
+        * \return Index of the FLEnergy profile
+        */
+        uint32_t GetEnergyProfile();
+
+        /**
+        * \brief Set energy profile of client
+        * \param profile  Index returned by FLEnergy::ResolveProfile
+        */
+        void SetEnergyProfile(uint32_t profile);
+
+        /**
+        * \brief Get local training time of the next round
+        * \return Computation time of the energy profile, derated by the health stack if the client has one
+        */
+        double GetComputationTime();
+
+        /**
+        * \brief Get temperature and reliability stack of client
+        * \return The stack, null if the client has none
+        */
+        ClientHealth *GetHealth();
+
+        /**
+        * \brief Give the client a temperature and reliability stack
+        * \param health  The stack
+        */
+        void SetHealth(std::shared_ptr<ClientHealth> health);
+
+        /**
+        * \brief Get compression ratio of the client's update
+        * \return Ratio of the first codec stage, 0 for the one of the codec
+        */
+        double GetCompressionRatio();
+
+        /**
+        * \brief Set compression ratio of the client's update
+        * \param ratio  Ratio of the first codec stage, 0 for the one of the codec
+        */
+        void SetCompressionRatio(double ratio);
+
+        /**
+        * \brief Set the encoded update of the next round
+        * \param bytes       Bytes uploaded, 0 for the model size
+        * \param encodeTime  Client time spent encoding (s)
+        * \param decodeTime  Server time spent decoding (s)
+        */
+        void SetUpdate(uint32_t bytes, double encodeTime, double decodeTime);
+
+        /**
+        * \brief Get bytes uploaded in the next round
+        * \return Encoded update size, 0 for the model size
+        */
+        uint32_t GetUpdateBytes();
+
+        /**
+        * \brief Get client time spent encoding the update
+        * \return Seconds
+        */
+        double GetEncodeTime();
+
+        /**
+        * \brief Get server time spent decoding the update
+        * \return Seconds
+        */
+        double GetDecodeTime();
 
     private:
         ns3::Ptr<ns3::Socket> m_client;     //!< Socket of client
@@ -126,29 +208,88 @@ namespace ns3 {
         int m_cycle;                        //!< Client cycle for async round
         bool m_inRound;                     //!< Indicates whether client should participate in round
         bool m_dropOut;                     //!< Indicates if client has dropped out of round
+        uint32_t m_energyProfile;           //!< FLEnergy profile (device type, learning model, epochs)
+        std::shared_ptr<ClientHealth> m_health; //!< Temperature and reliability stack, null if not simulated
+        double m_compressionRatio;          //!< Ratio of the first codec stage, 0 for the codec's
+        uint32_t m_updateBytes;             //!< Bytes uploaded, 0 for the model size
+        double m_encodeTime;                //!< Client time spent encoding the update
+        double m_decodeTime;                //!< Server time spent decoding the update
     };
 
     /**
    * \ingroup fl-client-session-manager
    * \brief Manages the client session
+   *
+   * Sessions are kept in a vector indexed by client id (ids are 0 .. n-1) and resolved
+   * from addresses, server side sockets and node ids through hash indices, so the
+   * per upload lookups do not grow with the number of clients.
    */
     class ClientSessionManager {
     public:
         /**
         * \brief Construct client session manager
-        * \param inn    map of < client ids, client sessions >
+        * \param inn           map of < client ids, client sessions >
+        * \param allConnected  If true, index every client regardless of its in-round flag
+        *                      (persistent network, where all clients keep a socket across rounds)
         */
-        ClientSessionManager(std::map<int, std::shared_ptr<ClientSession> > &inn);
+        ClientSessionManager(std::map<int, std::shared_ptr<ClientSession> > &inn, bool allConnected = false);
+
+        /**
+        * \brief Re-count the clients in round and clear the first cycle counter
+        * Called at the start of each round of a persistent network
+        */
+        void BeginRound();
+
+        /**
+        * \brief Get if the client behind a server socket participates in this round
+        * \param socket  Client socket (server side)
+        * \return  True if the client is known and in round
+        */
+        bool IsInRound(ns3::Ptr<ns3::Socket> socket);
+
+        /**
+        * \brief Get number of clients in round
+        * \return  Number of clients in round
+        */
+        int GetNumInRound();
 
         /**
         * \brief Get client id from client address
         * \param address  Client address
-        * \return  Client id
+        * \return  Client id, -1 if unknown
         */
         int ResolveToId(ns3::Ipv4Address &address);
 
         /**
-        * \brief Increment cycle count (async) from server
+        * \brief Get client id from the id of the client node
+        * \param nodeId  Node id
+        * \return  Client id, -1 if unknown
+        */
+        int ResolveToIdFromNode(uint32_t nodeId);
+
+        /**
+        * \brief Get energy profile of a client
+        * \param id  Client id, must be known
+        * \return  Index of the FLEnergy profile
+        */
+        uint32_t GetEnergyProfile(int id);
+
+        /**
+        * \brief Get bytes a client uploads
+        * \param id  Client id, must be known
+        * \return  Encoded update size, 0 for the model size
+        */
+        uint32_t GetUpdateBytes(int id);
+
+        /**
+        * \brief Get server time spent decoding the update of a client
+        * \param id  Client id, must be known
+        * \return  Seconds
+        */
+        double GetDecodeTime(int id);
+
+        /**
+        * \brief Increment cycle count (async) from server, unknown peers are ignored
         * \param address  Client socket
         */
         void IncrementCycleCountFromServer(ns3::Ptr<ns3::Socket> socket);
@@ -162,13 +303,15 @@ namespace ns3 {
         /**
         * \brief Get cycle of client in async round
         * \param socket  Client socket to check round for
+        * \return Cycle of the client, -1 for an unknown peer
         */
         int GetRound(ns3::Ptr<ns3::Socket> socket);
 
         /**
         * \brief Get client id from client socket
+        * The peer address is resolved on the first call for a socket, later calls hit a socket index
         * \param socket  Client socket
-        * \return  Client id
+        * \return  Client id, -1 if unknown
         */
         int ResolveToIdFromServer(ns3::Ptr<ns3::Socket> socket);
 
@@ -179,14 +322,35 @@ namespace ns3 {
 
         /**
         * \brief Get client address from client id
-        * \param id  Client id
+        * \param id  Client id, must be known
         * \return  Client address
         */
         ns3::Ipv4Address ResolveToAddress(int id);
 
+        /**
+        * \brief Mark a client as dropped out of the round
+        * \param id  Client id, must be known
+        */
+        void SetDropOut(int id);
+
+        /**
+        * \brief Get if the client behind a server socket dropped out of the round
+        * \param socket  Client socket (server side)
+        * \return  True if the client is known and dropped out
+        */
+        bool IsDropOut(ns3::Ptr<ns3::Socket> socket);
+
+        /**
+        * \brief Forget a server socket, e.g. once closed
+        * \param socket  Client socket (server side)
+        */
+        void Forget(ns3::Ptr<ns3::Socket> socket);
+
     private:
-        std::map<ns3::Ipv4Address, int> m_clientSessionByAddress;                 //!< maps Client Address to Client id
-        std::map<int, std::shared_ptr<ClientSession> > &m_clientSessionById;      //!< maps client id to client session
+        std::unordered_map<ns3::Ipv4Address, int, ns3::Ipv4AddressHash> m_clientSessionByAddress; //!< maps Client Address to Client id
+        std::unordered_map<ns3::Socket *, int> m_clientSessionBySocket;           //!< maps server side socket to Client id
+        std::unordered_map<uint32_t, int> m_clientSessionByNode;                  //!< maps node id to Client id
+        std::vector<std::shared_ptr<ClientSession> > m_clientSessionById;         //!< client sessions indexed by client id
         int m_nInRound;                                                           //!< number of clients in round
         int m_nInRoundFirstCycleDone;                                             //!< number of clients with first cycle done
 
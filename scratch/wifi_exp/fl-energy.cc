@@ -1,11 +1,21 @@
 #include "fl-energy.h"
 
+#include <map>
+#include <tuple>
+#include <deque>
+
 namespace ns3 {
 
-    FLEnergy::FLEnergy()
+    FLEnergy::FLEnergy() : m_A(0), m_B(0), m_C(0), m_D(0), m_tp(0), m_freq(1500), m_epochs(0), m_ModelSize(0), m_MAC(0)
     {
     }
 
+    namespace {
+        // Profiles are appended and never removed, a deque keeps references stable
+        std::deque<FLEnergy::Profile> g_profiles;
+        std::map<std::tuple<std::string, std::string, double>, uint32_t> g_profileIndex;
+    }
+
     double FLEnergy::GetA (void) const
     {
     return m_A;
@@ -177,4 +187,58 @@ namespace ns3 {
         return time;
     }
 
-}
\ No newline at end of file
+    uint32_t FLEnergy::ResolveProfile(const std::string &deviceType, const std::string &learningModel, double epochs)
+    {
+        auto key = std::make_tuple(deviceType, learningModel, epochs);
+        auto itr = g_profileIndex.find(key);
+        if (itr != g_profileIndex.end()) {
+            return itr->second;
+        }
+
+        if ((deviceType != "4" && deviceType != "400") ||
+            (learningModel != "MNIST" && learningModel != "FashionMNIST" && learningModel != "CIFAR-10")) {
+            return INVALID_PROFILE;
+        }
+
+        // The device type selects the constants used by SetLearningModel
+        FLEnergy energy;
+        energy.SetDeviceType(deviceType);
+        energy.SetEpochs(epochs);
+        energy.SetLearningModel(learningModel);
+
+        g_profiles.push_back(Profile{energy.CalcComputationTime(), energy.CalcComputationalPower(),
+                                     energy.CalcTransmissionPower()});
+        uint32_t profile = g_profiles.size() - 1;
+        g_profileIndex.emplace(key, profile);
+        return profile;
+    }
+
+    const FLEnergy::Profile & FLEnergy::GetProfile(uint32_t profile)
+    {
+        return g_profiles[profile];
+    }
+
+    void FLEnergy::CalcBatch(size_t n, const uint32_t *profiles, const double *computationSpent,
+                             const double *transmissionSpent, double *computationTime, double *computationPower,
+                             double *computationEnergy, double *transmissionEnergy)
+    {
+        // Gather, transmission energy parks the transmission power until the second pass
+        for (size_t i = 0; i < n; i++) {
+            const Profile &p = g_profiles[profiles[i]];
+            computationTime[i] = p.computationTime;
+            computationPower[i] = p.computationPower;
+            transmissionEnergy[i] = p.transmissionPower;
+        }
+
+        const double *__restrict cs = computationSpent;
+        const double *__restrict ts = transmissionSpent;
+        const double *__restrict cp = computationPower;
+        double *__restrict ce = computationEnergy;
+        double *__restrict te = transmissionEnergy;
+        for (size_t i = 0; i < n; i++) {
+            ce[i] = cp[i] * cs[i];
+            te[i] = te[i] * ts[i];
+        }
+    }
+
+}
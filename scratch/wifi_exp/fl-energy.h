@@ -1,8 +1,13 @@
+#ifndef FL_ENERGY_H
+#define FL_ENERGY_H
+
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/type-id.h"
 #include "ns3/node.h"
 #include "ns3/double.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace ns3 {
@@ -12,6 +17,15 @@ namespace ns3 {
  */
 class FLEnergy{
 public:
+    /**
+    * \brief Computation time and powers of one (device type, learning model, epochs)
+    */
+    struct Profile {
+        double computationTime;    //!< Seconds of local training
+        double computationPower;   //!< Watts while training
+        double transmissionPower;  //!< Watts while transmitting
+    };
+
     /**
     * \brief Construct energy model
     * \param inn    map of < client ids, client sessions >
@@ -42,6 +56,43 @@ public:
     double CalcComputationalEnergy(double time);
     double CalcComputationTime();
 
+    static constexpr uint32_t INVALID_PROFILE = UINT32_MAX;  //!< ResolveProfile of unknown arguments
+
+    /**
+    * \brief Resolve a profile once; later calls with the same arguments return the same index
+    * \param deviceType     Device type, "4" or "400"
+    * \param learningModel  "MNIST", "FashionMNIST" or "CIFAR-10"
+    * \param epochs         Local epochs
+    * \return Index of the profile in the profile table, INVALID_PROFILE for an unknown
+    *         device type or learning model
+    */
+    static uint32_t ResolveProfile(const std::string &deviceType, const std::string &learningModel, double epochs);
+
+    /**
+    * \brief Get a resolved profile
+    * \param profile  Index returned by ResolveProfile
+    * \return The profile
+    */
+    static const Profile &GetProfile(uint32_t profile);
+
+    /**
+    * \brief Computation time, power and energies of n clients in one pass
+    *
+    * Inputs and outputs are parallel arrays of n elements (structure of arrays), the profile
+    * lookup is done first so the arithmetic runs as one vectorizable loop.
+    * \param n                 Number of clients
+    * \param profiles          Profile index of each client
+    * \param computationSpent  Time each client spent training
+    * \param transmissionSpent Time each client spent transmitting
+    * \param computationTime   Out: profile computation time
+    * \param computationPower  Out: profile computation power
+    * \param computationEnergy Out: computation power * computationSpent
+    * \param transmissionEnergy Out: transmission power * transmissionSpent
+    */
+    static void CalcBatch(size_t n, const uint32_t *profiles, const double *computationSpent,
+                          const double *transmissionSpent, double *computationTime, double *computationPower,
+                          double *computationEnergy, double *transmissionEnergy);
+
 private:
 
     double m_A;
@@ -60,3 +111,4 @@ private:
 
 }
 
+#endif
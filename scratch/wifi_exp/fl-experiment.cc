@@ -21,6 +21,7 @@
 #include "fl-experiment.h"
 #include "fl-client-application.h"
 #include "fl-server.h"
+#include "fl-client-health.h"
 #include "ns3/core-module.h"
 #include "ns3/csma-module.h"
 #include "ns3/applications-module.h"
@@ -32,10 +33,14 @@
 #include "ns3/reliability-module.h"
 #include "ns3/yans-error-rate-model.h"
 
+#include <cmath>
+#include <limits>
+
 namespace ns3 {
 
     Experiment::Experiment(int numClients, std::string &networkType, int maxPacketSize, double txGain, double modelSize,
-                           std::string &dataRate, bool bAsync, FLSimProvider *fl_sim_provider, FILE *fp, int round) :
+                           std::string &dataRate, bool bAsync, FLSimProvider *fl_sim_provider,
+                           RoundRecordWriter *log, int round) :
             m_numClients(numClients),
             m_networkType(networkType),
             m_maxPacketSize(maxPacketSize),
@@ -44,8 +49,127 @@ namespace ns3 {
             m_dataRate(dataRate),
             m_bAsync(bAsync),
             m_flSymProvider(fl_sim_provider),
-            m_fp(fp),
-            m_round(round) {
+            m_log(log),
+            m_round(round),
+            m_profiles(nullptr),
+            m_churn(nullptr),
+            m_churnStart(0),
+            m_roundTimeout(0),
+            m_bBroadcast(false),
+            m_aggregationOverhead(0),
+            m_aggregationRate(0),
+            m_codec(nullptr),
+            m_topology(nullptr),
+            m_bBuilt(false) {
+    }
+
+    Experiment::~Experiment() {
+        if (m_bBuilt) {
+            m_clientSessionManager.reset();
+            m_server = nullptr;
+            Simulator::Destroy();
+        }
+    }
+
+    void
+    Experiment::SetRound(int round) {
+        m_round = round;
+    }
+
+    void
+    Experiment::SetClientProfiles(const ClientProfiles *profiles) {
+        m_profiles = profiles;
+    }
+
+    void
+    Experiment::SetChurn(ChurnModel *churn, double roundStart, double roundTimeout) {
+        m_churn = churn;
+        m_churnStart = roundStart;
+        m_roundTimeout = roundTimeout;
+    }
+
+    void
+    Experiment::SetBroadcast(bool broadcast) {
+        m_bBroadcast = broadcast;
+    }
+
+    void
+    Experiment::SetAggregation(double overhead, DataRate rate) {
+        m_aggregationOverhead = overhead;
+        m_aggregationRate = rate;
+    }
+
+    void
+    Experiment::SetCodec(const UpdateCodec *codec) {
+        m_codec = codec;
+    }
+
+    void
+    Experiment::SetTopology(const TopologySpec *topology) {
+        m_topology = topology;
+    }
+
+    void
+    Experiment::SetAsyncPolicy(const AsyncPolicy &policy) {
+        m_asyncPolicy = policy;
+    }
+
+    void
+    Experiment::EncodeUpdates(std::map<int, std::shared_ptr<ClientSession> > &clients) {
+        for (auto &itr: clients) {
+            if (!m_codec) {
+                itr.second->SetUpdate(0, 0, 0);
+                continue;
+            }
+            EncodedUpdate update = m_codec->Encode(m_modelSize, itr.second->GetCompressionRatio());
+            itr.second->SetUpdate(update.GetBytes(), update.encodeTime, update.decodeTime);
+        }
+    }
+
+    uint32_t
+    Experiment::GetUpdateBytes(std::map<int, std::shared_ptr<ClientSession> > &clients, int id) const {
+        uint32_t bytes = clients[id]->GetUpdateBytes();
+        return bytes ? bytes : (uint32_t) m_modelSize;
+    }
+
+    void
+    Experiment::AddAggregationTime(std::map<int, std::shared_ptr<ClientSession> > &clients,
+                                   std::map<int, FLSimProvider::Message> &roundStats) {
+        Time aggregation = Server::GetAggregationTime(Seconds(m_aggregationOverhead), m_aggregationRate,
+                                                      roundStats.size(), m_modelSize);
+        for (auto &itr: roundStats) {
+            aggregation += Seconds(clients[itr.first]->GetDecodeTime());
+        }
+        if (aggregation.IsZero()) {
+            return;
+        }
+        NS_LOG_UNCOND("AGGREGATION: " << roundStats.size() << " updates, " << aggregation.As(Time::S));
+        for (auto &itr: roundStats) {
+            itr.second.roundTime += aggregation.GetSeconds();
+        }
+    }
+
+    void
+    Experiment::ApplyChurn(std::map<int, std::shared_ptr<ClientSession> > &clients) {
+        for (auto &itr: clients) {
+            itr.second->SetDropOut(false);
+            if (m_churn && itr.second->GetInRound() && !m_churn->IsAvailable(itr.first, m_churnStart)) {
+                NS_LOG_UNCOND("ID " << itr.first << " offline, left out of round " << m_round);
+                itr.second->SetInRound(false);
+            }
+        }
+    }
+
+    DataRate
+    Experiment::GetClientRate(int id) const {
+        NS_ASSERT_MSG(m_profiles && (uint32_t) id < m_profiles->GetN(), "No profile for client " << id);
+        return DataRate(m_profiles->dataRate[id]);
+    }
+
+    double
+    Experiment::GetComputationTime(std::map<int, std::shared_ptr<ClientSession> > &clients, int id) const {
+        NS_ASSERT_MSG(m_profiles && (uint32_t) id < m_profiles->GetN(), "No profile for client " << id);
+        return (clients[id]->GetComputationTime() + clients[id]->GetEncodeTime()) * m_profiles->computeScale[id];
     }
 
     void
@@ -140,11 +264,12 @@ namespace ns3 {
         mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
         mobility.Install(c);
 
-        int numClients = clients.size();
-        for (int j = 1; j <= numClients; j++) {
-            if (clients[j - 1]->GetInRound()) {
+        // Node j + 1 is the j-th client of the map, the server or edge aggregator is node 0
+        int j = 1;
+        for (auto itr = clients.begin(); itr != clients.end(); itr++, j++) {
+            if (itr->second->GetInRound()) {
 
-                Experiment::SetPosition(c.Get(j), clients[j - 1]->GetRadius(), clients[j - 1]->GetTheta());
+                Experiment::SetPosition(c.Get(j), itr->second->GetRadius(), itr->second->GetTheta());
             }
         }
 
@@ -152,40 +277,21 @@ namespace ns3 {
 
     }
 
-    const char *wifi_strings[] =
-            {
-                    "75kbps",
-                    "125kbps",
-                    "150kbps",
-                    "160kbps",
-                    "175kbps",
-                    "200kbps",
-            };
-
-    const char *ethernet_strings[] =
-            {
-                    "80kbps",
-                    "160kbps",
-                    "320kbps",
-                    "640kbps",
-                    "1024kbps",
-                    "2048kbps",
-            };
-
     std::map<int, FLSimProvider::Message>
     Experiment::WeakNetwork(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset) {
 
         int server = 0;
         int numClients = clients.size();
 
+        ApplyChurn(clients);
+        EncodeUpdates(clients);
+
         NodeContainer c;
         c.Create(numClients + 1);
 
         NetDeviceContainer devices;
-        const char **strings = ethernet_strings;
         if (m_networkType.compare("wifi") == 0) {
             devices = Wifi(c, clients);
-            strings = ethernet_strings;
         } else //assume ethernet if not specified
         {
             devices = Ethernet(c, clients);
@@ -207,6 +313,20 @@ namespace ns3 {
         server_helper.SetAttribute("DataRate", StringValue(m_dataRate));
         server_helper.SetAttribute("Async", BooleanValue(m_bAsync));
         server_helper.SetAttribute("TimeOffset", TimeValue(timeOffset));
+        server_helper.SetAttribute("RoundTimeout", TimeValue(Seconds(m_roundTimeout)));
+        server_helper.SetAttribute("Broadcast", BooleanValue(m_bBroadcast));
+        server_helper.SetAttribute("AggregationOverhead", TimeValue(Seconds(m_aggregationOverhead)));
+        server_helper.SetAttribute("AggregationRate", DataRateValue(m_aggregationRate));
+        if (m_bAsync) {
+            server_helper.SetAttribute("AsyncTimeBudget", TimeValue(m_asyncPolicy.timeBudget));
+            server_helper.SetAttribute("AsyncWallBudget", TimeValue(m_asyncPolicy.wallBudget));
+            server_helper.SetAttribute("AsyncMaxUpdates", UintegerValue(m_asyncPolicy.maxUpdates));
+            server_helper.SetAttribute("AsyncMaxCycles", UintegerValue(m_asyncPolicy.maxCycles));
+            server_helper.SetAttribute("AsyncStopAllCycled", BooleanValue(m_asyncPolicy.bStopAllCycled));
+            server_helper.SetAttribute("AsyncMaxStaleness", UintegerValue(m_asyncPolicy.maxStaleness));
+            server_helper.SetAttribute("AsyncBufferSize", UintegerValue(m_asyncPolicy.bufferSize));
+            server_helper.SetAttribute("AsyncReportBatch", UintegerValue(m_asyncPolicy.reportBatch));
+        }
         ApplicationContainer sinkApps = server_helper.Install(c.Get(server));
 
 
@@ -214,7 +334,7 @@ namespace ns3 {
 
 
         Address sinkAddress(InetSocketAddress(interfaces.GetAddress(server, 0), 80));
-        std::map<Ipv4Address, int> m_addrMap;
+        AddressMap addrMap;
         //initialize clients
         for (int j = 1; j <= numClients; j++) {
             if (clients[j - 1]->GetInRound()) {
@@ -222,7 +342,7 @@ namespace ns3 {
                 // Experiment::SetPosition (c.Get (j), clients[j - 1]->radius, clients[j - 1]->theta);
                 Ptr <Socket> source = Socket::CreateSocket(c.Get(j), TcpSocketFactory::GetTypeId());
 
-                m_addrMap[c.Get((j))->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()] = j - 1;
+                addrMap[c.Get((j))->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()] = j - 1;
 
                 source->SetAttribute("ConnCount", UintegerValue(1000));
                 source->SetAttribute("DataRetries", UintegerValue(100));
@@ -230,7 +350,14 @@ namespace ns3 {
 
                 Ptr <ClientApplication> app = CreateObject<ClientApplication>();
 
-                app->Setup(source, sinkAddress, m_maxPacketSize, m_modelSize, std::string(strings[j % 6]));
+                app->Setup(source, sinkAddress, m_maxPacketSize, m_modelSize, GetClientRate(j - 1));
+                app->SetComputationTime(GetComputationTime(clients, j - 1));
+                app->SetUpdateBytes(clients[j - 1]->GetUpdateBytes());
+                app->SetAttribute("Broadcast", BooleanValue(m_bBroadcast && !m_bAsync));
+                if (m_churn) {
+                    // The network only lives for this round, so a client that drops out stays out
+                    app->SetChurn(m_churn, j - 1, Seconds(m_churnStart) - Simulator::Now(), m_bAsync);
+                }
                 c.Get(j)->AddApplication(app);
                 app->SetStartTime(Seconds(1.));
                 app->SetStopTime(Seconds(1000000.0));
@@ -245,7 +372,7 @@ namespace ns3 {
         sinkApps.Get(0)->GetObject<ns3::Server>()->SetClientSessionManager(
             &client_session_manager,
             m_flSymProvider,
-            m_fp,
+            m_log,
             m_round
             );
 
@@ -259,74 +386,605 @@ namespace ns3 {
 
         std::map<int, FLSimProvider::Message> roundStats;
         if (m_bAsync == false) {
-            auto s1 = sinkApps.Get(0)->GetObject<ns3::Server>();
+            roundStats = CollectRoundStats(clients, sinkApps.Get(0)->GetObject<ns3::Server>(), addrMap);
+            AddAggregationTime(clients, roundStats);
+        }
+        Simulator::Destroy();
+        return roundStats;
+    }
 
-            auto sk = s1->GetAcceptedSockets();
-            std::map <Ipv4Address, FLSimProvider::Message> stats;
-            std::map<Ipv4Address, double> uplinkRound;
-            for (auto itr = sk.begin(); itr != sk.end(); itr++) {
-                auto beginUplink = itr->second->m_timeBeginReceivingModelFromClient;
-                auto endUplink = itr->second->m_timeEndReceivingModelFromClient;
-                auto clientAddress = InetSocketAddress::ConvertFrom(itr->second->m_address).GetIpv4();
 
-                NS_LOG_UNCOND(
-                        "[SERVER]  " << clientAddress << " -> 10.1.1.1" << std::endl <<
-                                     "  Sent=     " << itr->second->m_bytesSent << " bytes" << std::endl <<
-                                     "  Recv=     " << itr->second->m_bytesReceived << " bytes" << std::endl <<
-                                     "  Begin uplink=" << beginUplink.As(Time::S) << std::endl <<
-                                     "  End uplink=" << endUplink.As(Time::S) << std::endl <<
-                                     "  Difference=" << (endUplink - beginUplink).As(Time::S));
-                stats[clientAddress].roundTime = endUplink.GetDouble();
+    std::map<int, FLSimProvider::Message>
+    Experiment::Hierarchical(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset) {
+        NS_ASSERT_MSG(m_topology && m_topology->IsHierarchical() && !m_bAsync,
+                      "Hierarchical topology needs sync learning and edge aggregators");
+        int numClients = clients.size();
 
-                stats[clientAddress].throughput = itr->second->m_bytesReceived * 8.0 / 1000.0 /
-                                                  ((endUplink.GetDouble() - beginUplink.GetDouble()) / 1000000000.0);
+        ApplyChurn(clients);
+        EncodeUpdates(clients);
+
+        // Clients are split in contiguous blocks, one cell per edge aggregator
+        uint32_t nEdges = std::min<uint32_t>(m_topology->nEdges, numClients);
+        std::vector<std::map<int, std::shared_ptr<ClientSession> > > cells(nEdges);
+        for (auto &itr: clients) {
+            cells[(uint64_t) itr.first * nEdges / numClients][itr.first] = itr.second;
+        }
 
+        NodeContainer root;
+        root.Create(1);
+        InternetStackHelper internet;
+        internet.Install(root);
+
+        // One /16 per cell, every cell has its own channel
+        NodeContainer edges;
+        std::vector<NodeContainer> cellNodes(nEdges);
+        Ipv4AddressHelper ipv4;
+        ipv4.SetBase("10.1.0.0", "255.255.0.0");
+        for (uint32_t e = 0; e < nEdges; e++) {
+            cellNodes[e].Create(cells[e].size() + 1);
+            NetDeviceContainer devices;
+            if (m_networkType.compare("wifi") == 0) {
+                devices = Wifi(cellNodes[e], cells[e]);
+            } else {
+                devices = Ethernet(cellNodes[e], cells[e]);
             }
+            internet.Install(cellNodes[e]);
+            ipv4.Assign(devices);
+            ipv4.NewNetwork();
+            edges.Add(cellNodes[e].Get(0));
+        }
 
-            for (int j = 1; j <= numClients; j++) {
-                if (clients[j - 1]->GetInRound()) {
-                    auto app = clients[j - 1]->GetClient()->GetNode()->GetApplication(0);
-                    UintegerValue sent;
-                    UintegerValue rec;
-                    TimeValue begin;
-                    TimeValue end;
-                    Ipv4Address clientAddress;
-                    app->GetAttribute("BytesSent", sent);
-                    app->GetAttribute("BytesReceived", rec);
-                    app->GetAttribute("BeginDownlink", begin);
-                    app->GetAttribute("EndDownlink", end);
-
-                    clientAddress = InetSocketAddress::ConvertFrom(
-                            InetSocketAddress(interfaces.GetAddress(j, 0), 80)).GetIpv4();
-                    NS_LOG_UNCOND(
-                            "[CLIENT]  " << "10.1.1.1 -> " << clientAddress << std::endl <<
-                                         "  Sent=" << sent.Get() << " bytes" << std::endl <<
-                                         "  Recv=" << rec.Get() << " bytes" << std::endl <<
-                                         "  Begin downlink=" << begin.Get().As(Time::S) << std::endl <<
-                                         "  End downlink=" << end.Get().As(Time::S)
-                    );
-                    stats[clientAddress].roundTime =
-                            (stats[clientAddress].roundTime - begin.Get().GetDouble()) / 1000000000.0;
+        // The backhaul is the second interface of the edges, the cell stays the first
+        CsmaHelper backhaul;
+        backhaul.SetChannelAttribute("DataRate", StringValue(m_topology->backhaulRate));
+        backhaul.SetChannelAttribute("Delay", TimeValue(m_topology->backhaulDelay));
+        Ipv4AddressHelper backhaulIpv4;
+        std::vector<Ipv4Address> rootAddress(nEdges);
+        if (m_topology->bSharedBackhaul) {
+            backhaulIpv4.SetBase("172.16.0.0", "255.255.0.0");
+            Ipv4InterfaceContainer interfaces = backhaulIpv4.Assign(backhaul.Install(NodeContainer(root, edges)));
+            rootAddress.assign(nEdges, interfaces.GetAddress(0));
+        } else {
+            // A dedicated two node segment per edge
+            backhaulIpv4.SetBase("172.16.0.0", "255.255.255.252");
+            for (uint32_t e = 0; e < nEdges; e++) {
+                NodeContainer link(root, NodeContainer(edges.Get(e)));
+                Ipv4InterfaceContainer interfaces = backhaulIpv4.Assign(backhaul.Install(link));
+                backhaulIpv4.NewNetwork();
+                rootAddress[e] = interfaces.GetAddress(0);
+            }
+        }
 
+        // The root aggregates the edges' aggregates and ends the round
+        ServerHelper root_helper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 80));
+        root_helper.SetAttribute("MaxPacketSize", UintegerValue(m_maxPacketSize));
+        root_helper.SetAttribute("BytesModel", UintegerValue(m_modelSize));
+        root_helper.SetAttribute("DataRate", StringValue(m_topology->backhaulRate));
+        root_helper.SetAttribute("AggregationOverhead", TimeValue(Seconds(m_aggregationOverhead)));
+        root_helper.SetAttribute("AggregationRate", DataRateValue(m_aggregationRate));
+        ApplicationContainer rootApps = root_helper.Install(root.Get(0));
+        rootApps.Start(Seconds(0.));
+        Ptr<Server> rootServer = rootApps.Get(0)->GetObject<Server>();
+        rootServer->SetRoundEndCallback(MakeCallback(static_cast<void (*)(void)>(&Simulator::Stop)));
+
+        std::map<int, std::shared_ptr<ClientSession> > edgeSessions;
+        std::vector<Ptr<Server> > edgeServers(nEdges);
+        std::vector<std::unique_ptr<ClientSessionManager> > cellManagers;
+        AddressMap addrMap;
+        int nActive = 0;
+        for (uint32_t e = 0; e < nEdges; e++) {
+            bool active = false;
+            for (auto &itr: cells[e]) {
+                active = active || itr.second->GetInRound();
+            }
+            edgeSessions[e] = std::make_shared<ClientSession>(e, 0, 0);
+            edgeSessions[e]->SetInRound(active);
+            if (!active) {
+                continue;
+            }
+            nActive++;
+
+            Ptr<Node> edge = edges.Get(e);
+            ServerHelper edge_helper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 80));
+            edge_helper.SetAttribute("MaxPacketSize", UintegerValue(m_maxPacketSize));
+            edge_helper.SetAttribute("BytesModel", UintegerValue(m_modelSize));
+            edge_helper.SetAttribute("DataRate", StringValue(m_dataRate));
+            edge_helper.SetAttribute("RoundTimeout", TimeValue(Seconds(m_roundTimeout)));
+            edge_helper.SetAttribute("Broadcast", BooleanValue(m_bBroadcast));
+            edge_helper.SetAttribute("AggregationOverhead", TimeValue(Seconds(m_aggregationOverhead)));
+            edge_helper.SetAttribute("AggregationRate", DataRateValue(m_aggregationRate));
+            edge_helper.SetAttribute("HoldModel", BooleanValue(true));
+            ApplicationContainer edgeApps = edge_helper.Install(edge);
+            edgeApps.Start(Seconds(0.));
+            edgeServers[e] = edgeApps.Get(0)->GetObject<Server>();
+
+            // The edge takes the model of the root like a client, and uploads once its cell is aggregated
+            Ptr <Socket> uplinkSocket = Socket::CreateSocket(edge, TcpSocketFactory::GetTypeId());
+            uplinkSocket->SetAttribute("ConnCount", UintegerValue(1000));
+            uplinkSocket->SetAttribute("DataRetries", UintegerValue(100));
+            Ptr <ClientApplication> uplink = CreateObject<ClientApplication>();
+            uplink->Setup(uplinkSocket, InetSocketAddress(rootAddress[e], 80), m_maxPacketSize, m_modelSize,
+                          DataRate(m_topology->backhaulRate));
+            uplink->SetModelCallback(MakeCallback(&Server::ReleaseModel, PeekPointer(edgeServers[e])));
+            edgeServers[e]->SetRoundEndCallback(MakeCallback(&ClientApplication::Upload, PeekPointer(uplink)));
+            edge->AddApplication(uplink);
+            uplink->SetStartTime(Seconds(1.));
+            uplink->SetStopTime(Seconds(1000000.0));
+            edgeSessions[e]->SetClient(uplinkSocket);
+
+            Address edgeAddress(InetSocketAddress(edge->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal(), 80));
+            int j = 1;
+            for (auto itr = cells[e].begin(); itr != cells[e].end(); itr++, j++) {
+                if (!itr->second->GetInRound()) {
+                    continue;
+                }
+                Ptr <Node> node = cellNodes[e].Get(j);
+                Ptr <Socket> source = Socket::CreateSocket(node, TcpSocketFactory::GetTypeId());
+                addrMap[node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()] = itr->first;
+
+                source->SetAttribute("ConnCount", UintegerValue(1000));
+                source->SetAttribute("DataRetries", UintegerValue(100));
+
+                Ptr <ClientApplication> app = CreateObject<ClientApplication>();
+                app->Setup(source, edgeAddress, m_maxPacketSize, m_modelSize, GetClientRate(itr->first));
+                app->SetComputationTime(GetComputationTime(clients, itr->first));
+                app->SetUpdateBytes(itr->second->GetUpdateBytes());
+                app->SetAttribute("Broadcast", BooleanValue(m_bBroadcast));
+                if (m_churn) {
+                    app->SetChurn(m_churn, itr->first, Seconds(m_churnStart) - Simulator::Now(), false);
                 }
+                node->AddApplication(app);
+                app->SetStartTime(Seconds(1.));
+                app->SetStopTime(Seconds(1000000.0));
+
+                itr->second->SetClient(source);
+                itr->second->SetCycle(0);
             }
 
+            cellManagers.emplace_back(new ClientSessionManager(cells[e]));
+            edgeServers[e]->SetClientSessionManager(cellManagers.back().get(), m_flSymProvider, m_log, m_round);
+        }
+
+        ClientSessionManager rootManager(edgeSessions);
+        rootServer->SetClientSessionManager(&rootManager, nullptr, nullptr, m_round);
+
+        std::map<int, FLSimProvider::Message> roundStats;
+        if (nActive == 0) {
+            Simulator::Destroy();
+            return roundStats;
+        }
 
-            for (auto itr: stats) {
+        Simulator::Stop(Seconds(1000000.0));
+        Simulator::Run();
 
-                int id = m_addrMap[itr.first];
+        // Time at which the aggregate of each edge reached the root
+        std::vector<double> rootEnd(nEdges, -1);
+        for (auto &itr: rootServer->GetAcceptedSockets()) {
+            Ipv4Address address = InetSocketAddress::ConvertFrom(itr.second->m_address).GetIpv4();
+            int e = rootManager.ResolveToId(address);
+            if (e >= 0 && itr.second->m_bytesReceived > 0 && itr.second->m_bytesModelToReceive == 0) {
+                rootEnd[e] = itr.second->m_timeEndReceivingModelFromClient.GetSeconds();
+            }
+        }
 
-                NS_LOG_UNCOND("ID " << id << "  ,ADDRESS: " << itr.first << " ,Round 1 Latency=" << itr.second.roundTime
-                                    << "s ,Round 1 Throughput= "
-                                    << itr.second.throughput << "kbps");
+        int nAggregates = 0;
+        for (uint32_t e = 0; e < nEdges; e++) {
+            if (!edgeServers[e] || rootEnd[e] < 0) {
+                continue;
+            }
+            nAggregates++;
+
+            auto cellStats = CollectRoundStats(cells[e], edgeServers[e], addrMap);
+            NS_LOG_UNCOND("EDGE " << e << ": " << cellStats.size() << " updates, aggregate at root="
+                                  << rootEnd[e] << "s");
+            for (auto &itr: cellStats) {
+                // An update only counts once the aggregate of its edge reached the root
+                TimeValue begin;
+                clients[itr.first]->GetClient()->GetNode()->GetApplication(0)->GetAttribute("BeginDownlink", begin);
+                itr.second.roundTime = rootEnd[e] - begin.Get().GetSeconds();
+                roundStats[itr.first] = itr.second;
+            }
+        }
 
-                roundStats[id].throughput = itr.second.throughput;
-                roundStats[id].roundTime = itr.second.roundTime;
+        Time aggregation = Server::GetAggregationTime(Seconds(m_aggregationOverhead), m_aggregationRate,
+                                                      nAggregates, m_modelSize);
+        if (!aggregation.IsZero()) {
+            NS_LOG_UNCOND("AGGREGATION: " << nAggregates << " edge aggregates, " << aggregation.As(Time::S));
+            for (auto &itr: roundStats) {
+                itr.second.roundTime += aggregation.GetSeconds();
             }
         }
+
         Simulator::Destroy();
         return roundStats;
     }
 
-}
 
+    std::map<int, FLSimProvider::Message>
+    Experiment::CollectRoundStats(std::map<int, std::shared_ptr<ClientSession> > &clients, Ptr<Server> server,
+                                  AddressMap &addrMap) {
+        std::map<int, FLSimProvider::Message> roundStats;
+
+        auto sk = server->GetAcceptedSockets();
+        std::unordered_map<Ipv4Address, FLSimProvider::Message, Ipv4AddressHash> stats;
+        for (auto itr = sk.begin(); itr != sk.end(); itr++) {
+            auto beginUplink = itr->second->m_timeBeginReceivingModelFromClient;
+            auto endUplink = itr->second->m_timeEndReceivingModelFromClient;
+            auto clientAddress = InetSocketAddress::ConvertFrom(itr->second->m_address).GetIpv4();
+
+            auto id = addrMap.find(clientAddress);
+            if (id == addrMap.end() || !clients[id->second]->GetInRound() || clients[id->second]->GetDropOut()) {
+                continue;
+            }
+
+            NS_LOG_UNCOND(
+                    "[SERVER]  " << clientAddress << " -> 10.1.1.1" << std::endl <<
+                                 "  Sent=     " << itr->second->m_bytesSent << " bytes" << std::endl <<
+                                 "  Recv=     " << itr->second->m_bytesReceived << " bytes" << std::endl <<
+                                 "  Begin uplink=" << beginUplink.As(Time::S) << std::endl <<
+                                 "  End uplink=" << endUplink.As(Time::S) << std::endl <<
+                                 "  Difference=" << (endUplink - beginUplink).As(Time::S));
+            stats[clientAddress].roundTime = endUplink.GetDouble();
+
+            stats[clientAddress].throughput = itr->second->m_bytesReceived * 8.0 / 1000.0 /
+                                              ((endUplink.GetDouble() - beginUplink.GetDouble()) / 1000000000.0);
+
+        }
+
+        for (auto &client: clients) {
+            if (client.second->GetInRound() && !client.second->GetDropOut()) {
+                auto node = client.second->GetClient()->GetNode();
+                auto app = node->GetApplication(0);
+                UintegerValue sent;
+                UintegerValue rec;
+                TimeValue begin;
+                TimeValue end;
+                Ipv4Address clientAddress;
+                app->GetAttribute("BytesSent", sent);
+                app->GetAttribute("BytesReceived", rec);
+                app->GetAttribute("BeginDownlink", begin);
+                app->GetAttribute("EndDownlink", end);
+
+                clientAddress = node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+                NS_LOG_UNCOND(
+                        "[CLIENT]  " << "10.1.1.1 -> " << clientAddress << std::endl <<
+                                     "  Sent=" << sent.Get() << " bytes" << std::endl <<
+                                     "  Recv=" << rec.Get() << " bytes" << std::endl <<
+                                     "  Begin downlink=" << begin.Get().As(Time::S) << std::endl <<
+                                     "  End downlink=" << end.Get().As(Time::S)
+                );
+                stats[clientAddress].roundTime =
+                        (stats[clientAddress].roundTime - begin.Get().GetDouble()) / 1000000000.0;
+
+            }
+        }
+
+
+        for (auto itr: stats) {
+
+            int id = addrMap[itr.first];
+
+            NS_LOG_UNCOND("ID " << id << "  ,ADDRESS: " << itr.first << " ,Round " << m_round << " Latency="
+                                << itr.second.roundTime << "s ,Round " << m_round << " Throughput= "
+                                << itr.second.throughput << "kbps");
+
+            roundStats[id].throughput = itr.second.throughput;
+            roundStats[id].roundTime = itr.second.roundTime;
+        }
+        return roundStats;
+    }
+
+    void
+    Experiment::BuildPersistentNetwork(std::map<int, std::shared_ptr<ClientSession> > &clients) {
+        int server = 0;
+        int numClients = clients.size();
+
+        m_nodes.Create(numClients + 1);
+
+        NetDeviceContainer devices;
+        if (m_networkType.compare("wifi") == 0) {
+            devices = Wifi(m_nodes, clients);
+            // Wifi() only places the clients in round, every client keeps its node here
+            for (int j = 1; j <= numClients; j++) {
+                Experiment::SetPosition(m_nodes.Get(j), clients[j - 1]->GetRadius(), clients[j - 1]->GetTheta());
+            }
+        } else //assume ethernet if not specified
+        {
+            devices = Ethernet(m_nodes, clients);
+        }
+
+        InternetStackHelper internet;
+        internet.Install(m_nodes);
+        Ipv4AddressHelper ipv4;
+        ipv4.SetBase("10.1.1.0", "255.255.255.0");
+        m_interfaces = ipv4.Assign(devices);
+
+        ServerHelper server_helper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), 80));
+        server_helper.SetAttribute("MaxPacketSize", UintegerValue(m_maxPacketSize));
+        server_helper.SetAttribute("BytesModel", UintegerValue(m_modelSize));
+        server_helper.SetAttribute("DataRate", StringValue(m_dataRate));
+        server_helper.SetAttribute("Async", BooleanValue(m_bAsync));
+        server_helper.SetAttribute("Persistent", BooleanValue(true));
+        server_helper.SetAttribute("RoundTimeout", TimeValue(Seconds(m_roundTimeout)));
+        server_helper.SetAttribute("Broadcast", BooleanValue(m_bBroadcast));
+        server_helper.SetAttribute("AggregationOverhead", TimeValue(Seconds(m_aggregationOverhead)));
+        server_helper.SetAttribute("AggregationRate", DataRateValue(m_aggregationRate));
+        ApplicationContainer sinkApps = server_helper.Install(m_nodes.Get(server));
+        sinkApps.Start(Seconds(0.));
+        m_server = sinkApps.Get(0)->GetObject<ns3::Server>();
+
+        Address sinkAddress(InetSocketAddress(m_interfaces.GetAddress(server, 0), 80));
+        for (int j = 1; j <= numClients; j++) {
+            Ptr <Socket> source = Socket::CreateSocket(m_nodes.Get(j), TcpSocketFactory::GetTypeId());
+
+            m_addrMap[m_nodes.Get(j)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()] = j - 1;
+
+            source->SetAttribute("ConnCount", UintegerValue(1000));
+            source->SetAttribute("DataRetries", UintegerValue(100));
+
+            Ptr <ClientApplication> app = CreateObject<ClientApplication>();
+
+            app->Setup(source, sinkAddress, m_maxPacketSize, m_modelSize, GetClientRate(j - 1));
+            app->SetEnergyProfile(clients[j - 1]->GetEnergyProfile());
+            app->SetAttribute("Broadcast", BooleanValue(m_bBroadcast && !m_bAsync));
+            if (m_churn) {
+                // Simulation time is experiment time from here on; clients come back when available
+                app->SetChurn(m_churn, j - 1, Seconds(m_churnStart) - Simulator::Now(), true);
+            }
+            m_nodes.Get(j)->AddApplication(app);
+            app->SetStartTime(Seconds(1.));
+
+            clients[j - 1]->SetClient(source);
+        }
+
+        m_clientSessionManager = std::unique_ptr<ClientSessionManager>(new ClientSessionManager(clients, true));
+        m_server->SetClientSessionManager(m_clientSessionManager.get(), m_flSymProvider, m_log, m_round);
+        m_bBuilt = true;
+    }
+
+    std::map<int, FLSimProvider::Message>
+    Experiment::RunRound(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset) {
+        bool firstRound = !m_bBuilt;
+        ApplyChurn(clients);
+        EncodeUpdates(clients);
+        if (firstRound) {
+            BuildPersistentNetwork(clients);
+        }
+
+        m_clientSessionManager->BeginRound();
+        for (auto &itr: clients) {
+            if (itr.second->GetInRound()) {
+                itr.second->SetCycle(0);
+            }
+        }
+
+        std::map<int, FLSimProvider::Message> roundStats;
+        if (m_clientSessionManager->GetNumInRound() == 0) {
+            // Nobody can take part, let time pass until a client's availability changes
+            double next = m_churn ? m_churn->EarliestChange(clients.size(), m_churnStart)
+                                  : std::numeric_limits<double>::infinity();
+            if (!std::isinf(next)) {
+                Simulator::Stop(Seconds(next - m_churnStart));
+                Simulator::Run();
+            }
+            timeOffset = Simulator::Now();
+            return roundStats;
+        }
+
+        // Simulation time is continuous across rounds, no offset is added to the reported times
+        m_server->SetAttribute("TimeOffset", TimeValue(Time(0)));
+        m_server->SetClientSessionManager(m_clientSessionManager.get(), m_flSymProvider, m_log, m_round);
+
+        // The training time changes with the health of the client
+        for (auto &itr: clients) {
+            if (itr.second->GetInRound()) {
+                Ptr<ClientApplication> app =
+                        DynamicCast<ClientApplication>(itr.second->GetClient()->GetNode()->GetApplication(0));
+                app->SetComputationTime(GetComputationTime(clients, itr.first));
+                app->SetUpdateBytes(itr.second->GetUpdateBytes());
+            }
+            // Every client hears the broadcast, only the ones in round take it
+            if (m_bBroadcast) {
+                DynamicCast<ClientApplication>(itr.second->GetClient()->GetNode()->GetApplication(0))
+                        ->ExpectModel(itr.second->GetInRound());
+            }
+        }
+
+        if (!firstRound) {
+            // Connections are already up, re-arm the applications and restart the exchange
+            for (auto &itr: clients) {
+                if (itr.second->GetInRound()) {
+                    DynamicCast<ClientApplication>(itr.second->GetClient()->GetNode()->GetApplication(0))
+                            ->ResetRound();
+                }
+            }
+            Simulator::ScheduleNow(&Server::StartRound, m_server, m_round);
+        }
+
+        // Safety net in case a round never completes; Simulator::Stop(delay) can not be cancelled
+        EventId roundTimeout = Simulator::Schedule(Seconds(1000000.0),
+                                                   static_cast<void (*)(void)>(&Simulator::Stop));
+        Simulator::Run();
+        Simulator::Cancel(roundTimeout);
+
+        timeOffset = Simulator::Now();
+
+        if (m_bAsync == false) {
+            roundStats = CollectRoundStats(clients, m_server, m_addrMap);
+            AddAggregationTime(clients, roundStats);
+        }
+        return roundStats;
+    }
+
+
+    FLAnalyticModel::Estimate
+    Experiment::Predict(std::map<int, std::shared_ptr<ClientSession> > &clients, int id, int nInRound,
+                        const FLAnalyticModel &model) {
+        DataRate clientRate = GetClientRate(id);
+        DataRate serverRate(m_dataRate);
+
+        double updateBytes = GetUpdateBytes(clients, id);
+        auto e = model.Predict(clients[id]->GetRadius(), nInRound, serverRate.GetBitRate(), clientRate.GetBitRate(),
+                               m_modelSize, updateBytes, m_maxPacketSize,
+                               GetComputationTime(clients, id));
+        if (m_bBroadcast && !m_bAsync) {
+            // A single transmission reaches every client, the downlink does not share the medium
+            e.downlink = model.Predict(clients[id]->GetRadius(), 1, serverRate.GetBitRate(),
+                                       clientRate.GetBitRate(), m_modelSize, updateBytes, m_maxPacketSize,
+                                       0).downlink;
+        }
+        return e;
+    }
+
+    std::map<int, FLSimProvider::Message>
+    Experiment::Analytic(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset,
+                         FLAnalyticModel &model) {
+        ApplyChurn(clients);
+        EncodeUpdates(clients);
+
+        int nInRound = 0;
+        for (auto &itr: clients) {
+            if (itr.second->GetInRound()) {
+                nInRound++;
+            }
+        }
+
+        // Clients start at 1s, like the packet-level engine
+        double start = 1.0 + timeOffset.GetSeconds();
+
+        // Predict every in-round client, then price all of them in one energy batch
+        std::vector<int> ids;
+        std::vector<FLAnalyticModel::Estimate> estimates;
+        std::vector<uint32_t> profiles;
+        std::vector<double> computation, uplink;
+        for (auto &itr: clients) {
+            if (!itr.second->GetInRound()) {
+                continue;
+            }
+            auto e = Predict(clients, itr.first, nInRound, model);
+
+            double roundTime = e.downlink + e.computation + e.uplink;
+            if (m_roundTimeout > 0 && roundTime > m_roundTimeout) {
+                NS_LOG_UNCOND("ID " << itr.first << " dropped (timeout), Round " << m_round << " (analytic)");
+                itr.second->SetDropOut(true);
+                continue;
+            }
+            if (m_churn && m_churn->NextChange(itr.first, m_churnStart) < m_churnStart + 1.0 + roundTime) {
+                NS_LOG_UNCOND("ID " << itr.first << " dropped (disconnected), Round " << m_round << " (analytic)");
+                itr.second->SetDropOut(true);
+                continue;
+            }
+
+            ids.push_back(itr.first);
+            estimates.push_back(e);
+            profiles.push_back(itr.second->GetEnergyProfile());
+            computation.push_back(e.computation);
+            uplink.push_back(e.uplink);
+        }
+
+        size_t n = ids.size();
+        std::vector<double> compTime(n), compPower(n), compEnergy(n), tranEnergy(n);
+        FLEnergy::CalcBatch(n, profiles.data(), computation.data(), uplink.data(),
+                            compTime.data(), compPower.data(), compEnergy.data(), tranEnergy.data());
+
+        std::map<int, FLSimProvider::Message> roundStats;
+        for (size_t i = 0; i < n; i++) {
+            int id = ids[i];
+            const auto &e = estimates[i];
+
+            double endDownlink = start + e.downlink;
+            double beginUplink = endDownlink + e.computation;
+            double endUplink = beginUplink + e.uplink;
+
+            m_log->Add(RoundRecord{
+                    m_round, (uint32_t) id,
+                    beginUplink, endUplink,
+                    start, endDownlink,
+                    compEnergy[i], tranEnergy[i]
+            });
+
+            roundStats[id].roundTime = e.downlink + e.computation + e.uplink;
+            roundStats[id].throughput = GetUpdateBytes(clients, id) * 8.0 / 1000.0 / e.uplink;
+
+            NS_LOG_UNCOND("ID " << id << " ,Round " << m_round << " Latency=" << roundStats[id].roundTime
+                                << "s ,Round " << m_round << " Throughput= " << roundStats[id].throughput
+                                << "kbps (analytic)");
+        }
+        AddAggregationTime(clients, roundStats);
+        return roundStats;
+    }
+
+    void
+    Experiment::Calibrate(std::map<int, std::shared_ptr<ClientSession> > &clients,
+                          std::map<int, FLSimProvider::Message> &roundStats, FLAnalyticModel &model) {
+        int nInRound = 0;
+        for (auto &itr: clients) {
+            if (itr.second->GetInRound()) {
+                nInRound++;
+            }
+        }
+
+        for (auto &itr: roundStats) {
+            auto e = Predict(clients, itr.first, nInRound, model);
+            model.AddSample(e, clients[itr.first]->GetRadius(), itr.second.roundTime);
+        }
+        model.Fit();
+    }
+
+
+    void
+    Experiment::SelectHealthy(std::map<int, std::shared_ptr<ClientSession> > &clients, double minReliability) {
+        int nHealthy = 0;
+        for (auto &itr: clients) {
+            ClientHealth *health = itr.second->GetHealth();
+            if (itr.second->GetInRound() && (!health || health->IsHealthy(minReliability))) {
+                nHealthy++;
+            }
+        }
+        // Keep the selection as it is rather than run an empty round
+        if (nHealthy == 0) {
+            return;
+        }
+
+        for (auto &itr: clients) {
+            ClientHealth *health = itr.second->GetHealth();
+            if (itr.second->GetInRound() && health && !health->IsHealthy(minReliability)) {
+                NS_LOG_UNCOND("ID " << itr.first << " ,Round " << m_round << " skipped, temperature="
+                                    << health->GetTemperature() << "C reliability=" << health->GetReliability());
+                itr.second->SetInRound(false);
+            }
+        }
+    }
+
+    void
+    Experiment::UpdateHealth(std::map<int, std::shared_ptr<ClientSession> > &clients,
+                             std::map<int, FLSimProvider::Message> &roundStats) {
+        // The round lasts until the slowest client uploaded, the others idle until then
+        double roundTime = 0;
+        for (auto &itr: roundStats) {
+            roundTime = std::max(roundTime, itr.second.roundTime);
+        }
+
+        for (auto &itr: clients) {
+            ClientHealth *health = itr.second->GetHealth();
+            if (!health) {
+                continue;
+            }
+
+            auto stats = roundStats.find(itr.first);
+            if (stats == roundStats.end()) {
+                health->Run(0, 0, roundTime);
+                continue;
+            }
+
+            // Computation time of this round, taken before the stack moves on
+            double busy = std::min(GetComputationTime(clients, itr.first), roundTime);
+            health->Run(busy, FLEnergy::GetProfile(itr.second->GetEnergyProfile()).computationPower,
+                        roundTime - busy);
+
+            stats->second.temperature = health->GetTemperature();
+            stats->second.reliability = health->GetReliability();
+        }
+    }
+
+}
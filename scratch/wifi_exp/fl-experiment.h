@@ -34,21 +34,60 @@
 #include "ns3/mobility-model.h"
 #include "ns3/packet-socket-helper.h"
 #include "ns3/packet-socket-address.h"
+#include "ns3/node-container.h"
+#include "ns3/ipv4-interface-container.h"
 #include "fl-sim-interface.h"
 #include "fl-client-session.h"
+#include "fl-client-profile.h"
+#include "fl-client-churn.h"
+#include "fl-server.h"
+#include "fl-analytic-model.h"
+#include "fl-update-codec.h"
+#include "fl-topology.h"
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include <cstdio>
 
 namespace ns3 {
     /**
+    * \ingroup fl-experiment
+    * \brief When an async run stops and how the server folds in the updates,
+    *        see the Async attributes of Server
+    */
+    struct AsyncPolicy {
+        Time timeBudget = Time(0);  //!< Simulated time before stopping, 0 for none
+        Time wallBudget = Time(0);  //!< Wall clock time before stopping, 0 for none
+        uint32_t maxUpdates = 0;    //!< Updates aggregated before stopping, 0 for none
+        uint32_t maxCycles = 3;     //!< Cycles of one client before stopping, 0 for none
+        bool bStopAllCycled = true; //!< Stop once every client completed a cycle
+        uint32_t maxStaleness = 0;  //!< Updates staler than this are discarded, 0 for no bound
+        uint32_t bufferSize = 1;    //!< Updates aggregated together (FedBuff K)
+        uint32_t reportBatch = 1;   //!< Messages sent to flsim per write
+
+        /**
+        * \brief Get if the run stops at all
+        * \return True if at least one stop condition is set
+        */
+        bool HasStopCondition() const {
+            return timeBudget.IsStrictlyPositive() || wallBudget.IsStrictlyPositive() ||
+                   maxUpdates > 0 || maxCycles > 0 || bStopAllCycled;
+        }
+    };
+
+    /**
   * \ingroup fl-experiment
   * \brief Sets up and runs fl experiments
   */
     class Experiment {
     public:
+        /**
+        * \brief map of <client address, client id>
+        */
+        typedef std::unordered_map<Ipv4Address, int, Ipv4AddressHash> AddressMap;
+
         /**
         * \brief Constructs Experiment
         * \param numClients      Number of clients in experiment
@@ -59,9 +98,12 @@ namespace ns3 {
         * \param dataRate        Datarate for server
         * \param bAsync          If running async experiment, true
         * \param pflSymProvider  pointer to an fl-sim-interface (used to communicate with flsim)
+        * \param log             Writer of the per upload records
+        * \param round           Experiment round
         */
         Experiment(int numClients, std::string &networkType, int maxPacketSize, double txGain, double modelSize,
-                   std::string &dataRate, bool bAsync, FLSimProvider *pflSymProvider, FILE *fp, int round);
+                   std::string &dataRate, bool bAsync, FLSimProvider *pflSymProvider, RoundRecordWriter *log,
+                   int round);
 
         /**
         * \brief Runs network experiment
@@ -73,6 +115,131 @@ namespace ns3 {
         std::map<int, FLSimProvider::Message>
         WeakNetwork(std::map<int, std::shared_ptr<ClientSession> > &packetsReceived, ns3::Time &timeOffset);
 
+        /**
+        * \brief Runs a sync round on the hierarchical topology set by SetTopology
+        * The root is node 0 of its own container; every edge aggregator serves one cell (Wi-Fi
+        * BSS or CSMA segment) of clients, waits for the model of the root before sending it
+        * to them, and forwards the aggregate of their updates to the root over the backhaul.
+        * A client's round lasts until the aggregate of its edge reached the root.
+        * \param clients      map of <client, client sessions>
+        * \param timeOffset   Unused, rounds are independent
+        * \return             map of <client id, message>, messages to send back to flsim for each client
+        */
+        std::map<int, FLSimProvider::Message>
+        Hierarchical(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset);
+
+        /**
+        * \brief Runs one round on a persistent network.
+        * The topology, sockets and routing state are built on the first call and kept
+        * alive across calls; following rounds only re-arm the per-round state of the
+        * server and client applications.
+        * \param clients      map of <client, client sessions>
+        * \param timeOffset   Set to the simulation time at the end of the round
+        * \return             map of <client id, message>, messages to send back to flsim for each client
+        */
+        std::map<int, FLSimProvider::Message>
+        RunRound(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset);
+
+        /**
+        * \brief Estimates a sync round in closed form instead of simulating it
+        * \param clients      map of <client, client sessions>
+        * \param timeOffset   Offset added to the logged times
+        * \param model        Analytic model, calibrated or not
+        * \return             map of <client id, message>, messages to send back to flsim for each client
+        */
+        std::map<int, FLSimProvider::Message>
+        Analytic(std::map<int, std::shared_ptr<ClientSession> > &clients, ns3::Time &timeOffset,
+                 FLAnalyticModel &model);
+
+        /**
+        * \brief Adds the packet-level results of a round to the analytic model samples and refits it
+        * \param clients      map of <client, client sessions>
+        * \param roundStats   Packet-level results of the round
+        * \param model        Analytic model to calibrate
+        */
+        void Calibrate(std::map<int, std::shared_ptr<ClientSession> > &clients,
+                       std::map<int, FLSimProvider::Message> &roundStats, FLAnalyticModel &model);
+
+        /**
+        * \brief Takes the throttled or worn clients out of the round
+        * Clients without a health stack are kept. If no client would be left, the selection is kept as is.
+        * \param clients         map of <client, client sessions>
+        * \param minReliability  Reliability below which a client is considered worn
+        */
+        void SelectHealthy(std::map<int, std::shared_ptr<ClientSession> > &clients, double minReliability);
+
+        /**
+        * \brief Advances the health stack of every client over the round and reports it in the round stats
+        * Clients of the round train for their computation time and idle until the slowest one is done,
+        * the others idle for the whole round.
+        * \param clients      map of <client, client sessions>
+        * \param roundStats   Results of the round, temperature and reliability are filled in
+        */
+        void UpdateHealth(std::map<int, std::shared_ptr<ClientSession> > &clients,
+                          std::map<int, FLSimProvider::Message> &roundStats);
+
+        /**
+        * \brief Sets the round used for logging
+        * \param round   Experiment round
+        */
+        void SetRound(int round);
+
+        /**
+        * \brief Sets the link rate and compute speed of the clients, must be called before any round
+        * \param profiles   Profiles indexed by client id, must outlive the experiment
+        */
+        void SetClientProfiles(const ClientProfiles *profiles);
+
+        /**
+        * \brief Sets the availability of the clients and the round timeout
+        * Clients unavailable when the round starts are taken out of it, clients that become
+        * unavailable during the round disconnect, and uploads taking longer than the timeout
+        * are dropped; both are reported as failures by the server.
+        * \param churn         Churn model, null if clients are always available
+        * \param roundStart    Experiment time at which the round starts (s)
+        * \param roundTimeout  Longest time from sending the model to receiving the update (s), 0 for none
+        */
+        void SetChurn(ChurnModel *churn, double roundStart, double roundTimeout);
+
+        /**
+        * \brief Sets whether the server broadcasts the model once per round instead of sending
+        *        it over every connection (sync only)
+        * \param broadcast   True for the UDP broadcast with NACK repair
+        */
+        void SetBroadcast(bool broadcast);
+
+        /**
+        * \brief Sets the time the server spends aggregating the updates, added to the round time
+        * \param overhead   Fixed cost of an aggregation (s)
+        * \param rate       Rate at which update bytes are aggregated, 0 for free
+        */
+        void SetAggregation(double overhead, DataRate rate);
+
+        /**
+        * \brief Sets the encoding of the updates the clients upload
+        * The encoding time is added to the training time of the client, the decoding time to
+        * the aggregation time of the server.
+        * \param codec   Codec, null to upload the dense model; must outlive the experiment
+        */
+        void SetCodec(const UpdateCodec *codec);
+
+        /**
+        * \brief Sets the topology used by Hierarchical
+        * \param topology  Topology, must outlive the experiment
+        */
+        void SetTopology(const TopologySpec *topology);
+
+        /**
+        * \brief Sets the stop conditions and aggregation of async runs
+        * \param policy  Policy, copied
+        */
+        void SetAsyncPolicy(const AsyncPolicy &policy);
+
+        /**
+        * \brief Destroys the persistent network, if one was built
+        */
+        ~Experiment();
+
     private:
         /**
         * \brief Set position of node in network
@@ -91,6 +258,7 @@ namespace ns3 {
 
         /**
         * \brief Sets up wifi network
+        * Node 0 of c is the server, node j + 1 the j-th client of clients
         */
         NetDeviceContainer Wifi(ns3::NodeContainer &c, std::map<int, std::shared_ptr<ClientSession> > &clients);
 
@@ -99,6 +267,61 @@ namespace ns3 {
         */
         NetDeviceContainer Ethernet(NodeContainer &c, std::map<int, std::shared_ptr<ClientSession> > &clients);
 
+        /**
+        * \brief Predicts one client's round with the analytic model
+        */
+        FLAnalyticModel::Estimate Predict(std::map<int, std::shared_ptr<ClientSession> > &clients, int id,
+                                          int nInRound, const FLAnalyticModel &model);
+
+        /**
+        * \brief Gets the uplink data rate of a client from its profile
+        */
+        DataRate GetClientRate(int id) const;
+
+        /**
+        * \brief Gets the training time of a client, its session's time scaled by its profile
+        */
+        double GetComputationTime(std::map<int, std::shared_ptr<ClientSession> > &clients, int id) const;
+
+        /**
+        * \brief Clears the drop outs of the last round and takes the clients unavailable at
+        *        the start of the round out of it
+        */
+        void ApplyChurn(std::map<int, std::shared_ptr<ClientSession> > &clients);
+
+        /**
+        * \brief Adds the server aggregation and decoding of the round's updates to every sync round time
+        */
+        void AddAggregationTime(std::map<int, std::shared_ptr<ClientSession> > &clients,
+                                std::map<int, FLSimProvider::Message> &roundStats);
+
+        /**
+        * \brief Encodes the update of every client with its compression ratio
+        */
+        void EncodeUpdates(std::map<int, std::shared_ptr<ClientSession> > &clients);
+
+        /**
+        * \brief Gets the bytes a client uploads
+        */
+        uint32_t GetUpdateBytes(std::map<int, std::shared_ptr<ClientSession> > &clients, int id) const;
+
+        /**
+        * \brief Builds the persistent network: nodes, devices, stack, server and one connected
+        *        client application per client regardless of its in-round flag
+        */
+        void BuildPersistentNetwork(std::map<int, std::shared_ptr<ClientSession> > &clients);
+
+        /**
+        * \brief Collects the sync round statistics from the server and the client applications
+        * \param clients     map of <client, client sessions>
+        * \param server      Server application of the round
+        * \param addrMap     map of <client address, client id>
+        * \return            map of <client id, message>
+        */
+        std::map<int, FLSimProvider::Message>
+        CollectRoundStats(std::map<int, std::shared_ptr<ClientSession> > &clients, Ptr<Server> server,
+                          AddressMap &addrMap);
+
         int m_numClients;                 //!< Number of clients in experiment
         std::string m_networkType;        //!< Network type
         int m_maxPacketSize;              //!< Max packet size
@@ -107,8 +330,25 @@ namespace ns3 {
         std::string m_dataRate;           //!< Datarate for server
         bool m_bAsync;                    //!< Indicator bool for whether experiement is async
         FLSimProvider *m_flSymProvider;   //!< pointer to an fl-sim-interface (used to communicate with flsim)
-        FILE *m_fp;                       //!< pointer to logfile
+        RoundRecordWriter *m_log;         //!< Writer of the per upload records
         int m_round;                      //!< experiment round
+        const ClientProfiles *m_profiles; //!< Link rate and compute speed of the clients
+        ChurnModel *m_churn;              //!< Availability of the clients, null if always available
+        double m_churnStart;              //!< Experiment time at which the round starts
+        double m_roundTimeout;            //!< Longest upload before a client is dropped, 0 for none
+        bool m_bBroadcast;                //!< Server broadcasts the model once per round
+        double m_aggregationOverhead;     //!< Fixed cost of an aggregation (s)
+        DataRate m_aggregationRate;       //!< Rate at which update bytes are aggregated, 0 for free
+        const UpdateCodec *m_codec;       //!< Encoding of the updates, null for the dense model
+        const TopologySpec *m_topology;   //!< Topology of Hierarchical, null for the star
+        AsyncPolicy m_asyncPolicy;        //!< Stop conditions and aggregation of async runs
+
+        bool m_bBuilt;                                                  //!< Persistent network has been built
+        NodeContainer m_nodes;                                          //!< Persistent network nodes (server is 0)
+        Ipv4InterfaceContainer m_interfaces;                            //!< Persistent network interfaces
+        Ptr<Server> m_server;                                           //!< Persistent network server
+        AddressMap m_addrMap;                                           //!< Persistent network map of <address, client id>
+        std::unique_ptr<ClientSessionManager> m_clientSessionManager;   //!< Persistent network session manager
     };
 }
 
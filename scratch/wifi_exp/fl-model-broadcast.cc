@@ -0,0 +1,411 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-model-broadcast.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE ("ModelBroadcast");
+
+    NS_OBJECT_ENSURE_REGISTERED (ModelBroadcastHeader);
+
+    // type, flags, reserved (2), round, index or count
+    static const uint32_t HEADER_FIXED_SIZE = 12;
+
+    ModelBroadcastHeader::ModelBroadcastHeader() :
+            type(CHUNK),
+            lastOfPass(false),
+            round(0),
+            index(0) {
+    }
+
+    TypeId
+    ModelBroadcastHeader::GetTypeId(void) {
+        static TypeId tid = TypeId("ns3::ModelBroadcastHeader")
+                .SetParent<Header>()
+                .SetGroupName("Applications")
+                .AddConstructor<ModelBroadcastHeader>();
+        return tid;
+    }
+
+    TypeId
+    ModelBroadcastHeader::GetInstanceTypeId(void) const {
+        return GetTypeId();
+    }
+
+    void
+    ModelBroadcastHeader::Print(std::ostream &os) const {
+        if (type == CHUNK) {
+            os << "CHUNK round=" << round << " index=" << index << (lastOfPass ? " last" : "");
+        } else {
+            os << "NACK round=" << round << " missing=" << missing.size();
+        }
+    }
+
+    uint32_t
+    ModelBroadcastHeader::GetSerializedSize(void) const {
+        return HEADER_FIXED_SIZE + (type == NACK ? 4 * missing.size() : 0);
+    }
+
+    void
+    ModelBroadcastHeader::Serialize(Buffer::Iterator start) const {
+        Buffer::Iterator i = start;
+        i.WriteU8(type);
+        i.WriteU8(lastOfPass ? 1 : 0);
+        i.WriteU16(0);
+        i.WriteHtonU32(round);
+        if (type == CHUNK) {
+            i.WriteHtonU32(index);
+        } else {
+            i.WriteHtonU32(missing.size());
+            for (uint32_t chunk: missing) {
+                i.WriteHtonU32(chunk);
+            }
+        }
+    }
+
+    uint32_t
+    ModelBroadcastHeader::Deserialize(Buffer::Iterator start) {
+        Buffer::Iterator i = start;
+        type = static_cast<Type>(i.ReadU8());
+        lastOfPass = i.ReadU8() != 0;
+        i.ReadU16();
+        round = i.ReadNtohU32();
+        missing.clear();
+        if (type == CHUNK) {
+            index = i.ReadNtohU32();
+        } else {
+            uint32_t count = i.ReadNtohU32();
+            missing.resize(count);
+            for (uint32_t n = 0; n < count; n++) {
+                missing[n] = i.ReadNtohU32();
+            }
+        }
+        return GetSerializedSize();
+    }
+
+    ModelBroadcaster::ModelBroadcaster() :
+            m_socket(0),
+            m_rate(0),
+            m_chunkSize(0),
+            m_maxPasses(0),
+            m_round(0),
+            m_bytes(0),
+            m_numChunks(0),
+            m_passes(0),
+            m_next(0),
+            m_bActive(false),
+            m_chunksSent(0) {
+    }
+
+    ModelBroadcaster::~ModelBroadcaster() {
+        if (m_socket) {
+            m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket> >());
+        }
+    }
+
+    void
+    ModelBroadcaster::Setup(Ptr<Node> node, Ipv4Address destination, DataRate rate, uint32_t chunkSize,
+                            Time repairTimeout, uint32_t maxPasses, Callback<void, Ipv4Address> delivered) {
+        m_socket = Socket::CreateSocket(node, UdpSocketFactory::GetTypeId());
+        if (m_socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), NACK_PORT)) == -1) {
+            NS_FATAL_ERROR("Failed to bind broadcast socket");
+        }
+        m_socket->SetAllowBroadcast(true);
+        m_socket->SetRecvCallback(MakeCallback(&ModelBroadcaster::HandleRead, this));
+
+        m_destination = destination;
+        m_rate = rate;
+        m_chunkSize = std::max<uint32_t>(chunkSize, 1);
+        m_repairTimeout = repairTimeout;
+        m_maxPasses = std::max<uint32_t>(maxPasses, 1);
+        m_delivered = delivered;
+    }
+
+    void
+    ModelBroadcaster::Start(uint32_t round, uint32_t bytes, const std::vector<Ipv4Address> &receivers) {
+        Cancel();
+        m_round = round;
+        m_bytes = bytes;
+        m_numChunks = (bytes + m_chunkSize - 1) / m_chunkSize;
+        m_pending.clear();
+        for (const auto &receiver: receivers) {
+            m_pending[receiver] = false;
+        }
+        if (m_pending.empty() || m_numChunks == 0) {
+            return;
+        }
+
+        m_bActive = true;
+        m_passes = 1;
+        m_nacked.assign(m_numChunks, 0);
+        m_pass.resize(m_numChunks);
+        for (uint32_t chunk = 0; chunk < m_numChunks; chunk++) {
+            m_pass[chunk] = chunk;
+        }
+        m_next = 0;
+        NS_LOG_UNCOND("[SERVER]  Broadcasting " << m_numChunks << " chunks to " << m_pending.size()
+                                                << " clients, round " << m_round);
+        SendNext();
+    }
+
+    void
+    ModelBroadcaster::AddReceiver(Ipv4Address receiver) {
+        if (m_bActive) {
+            m_pending[receiver] = false;
+        }
+    }
+
+    void
+    ModelBroadcaster::Drop(Ipv4Address receiver) {
+        if (m_pending.erase(receiver)) {
+            CheckDone();
+        }
+    }
+
+    void
+    ModelBroadcaster::Cancel() {
+        m_bActive = false;
+        m_pending.clear();
+        if (m_event.IsRunning()) {
+            Simulator::Cancel(m_event);
+        }
+    }
+
+    bool
+    ModelBroadcaster::IsActive() const {
+        return m_bActive;
+    }
+
+    uint64_t
+    ModelBroadcaster::GetChunksSent() const {
+        return m_chunksSent;
+    }
+
+    void
+    ModelBroadcaster::SendNext() {
+        if (m_next == m_pass.size()) {
+            m_event = Simulator::Schedule(m_repairTimeout, &ModelBroadcaster::EndPass, this);
+            return;
+        }
+
+        ModelBroadcastHeader header;
+        header.type = ModelBroadcastHeader::CHUNK;
+        header.round = m_round;
+        header.index = m_pass[m_next];
+        header.lastOfPass = m_next + 1 == m_pass.size();
+
+        uint32_t size = std::min(m_chunkSize, m_bytes - header.index * m_chunkSize);
+        Ptr<Packet> packet = Create<Packet>(size);
+        packet->AddHeader(header);
+        m_socket->SendTo(packet, 0, InetSocketAddress(m_destination, DATA_PORT));
+        m_chunksSent++;
+        m_next++;
+
+        Time gap = m_rate.GetBitRate() > 0 ? m_rate.CalculateBytesTxTime(packet->GetSize()) : Time(0);
+        m_event = Simulator::Schedule(gap, &ModelBroadcaster::SendNext, this);
+    }
+
+    void
+    ModelBroadcaster::EndPass() {
+        if (++m_passes > m_maxPasses) {
+            NS_LOG_UNCOND("[SERVER]  Broadcast gave up after " << m_maxPasses << " passes, "
+                                                               << m_pending.size() << " clients left");
+            Cancel();
+            return;
+        }
+
+        // A client that stayed silent missed the end of the pass, it gets the whole model again
+        bool silent = false;
+        for (auto &itr: m_pending) {
+            silent = silent || !itr.second;
+            itr.second = false;
+        }
+
+        m_pass.clear();
+        for (uint32_t chunk = 0; chunk < m_numChunks; chunk++) {
+            if (silent || m_nacked[chunk]) {
+                m_pass.push_back(chunk);
+            }
+        }
+        std::fill(m_nacked.begin(), m_nacked.end(), 0);
+        m_next = 0;
+        SendNext();
+    }
+
+    void
+    ModelBroadcaster::HandleRead(Ptr<Socket> socket) {
+        Ptr<Packet> packet;
+        Address from;
+        while ((packet = socket->RecvFrom(from))) {
+            ModelBroadcastHeader header;
+            if (packet->GetSize() < HEADER_FIXED_SIZE || !packet->RemoveHeader(header) ||
+                header.type != ModelBroadcastHeader::NACK || header.round != m_round || !m_bActive) {
+                continue;
+            }
+
+            Ipv4Address receiver = InetSocketAddress::ConvertFrom(from).GetIpv4();
+            auto itr = m_pending.find(receiver);
+            if (itr == m_pending.end()) {
+                continue;
+            }
+
+            if (header.missing.empty()) {
+                m_pending.erase(itr);
+                m_delivered(receiver);
+                CheckDone();
+                continue;
+            }
+
+            itr->second = true;
+            for (uint32_t chunk: header.missing) {
+                if (chunk < m_numChunks) {
+                    m_nacked[chunk] = 1;
+                }
+            }
+        }
+    }
+
+    void
+    ModelBroadcaster::CheckDone() {
+        if (m_bActive && m_pending.empty()) {
+            NS_LOG_UNCOND("[SERVER]  Broadcast of round " << m_round << " delivered after " << m_passes
+                                                          << " passes");
+            Cancel();
+        }
+    }
+
+    ModelBroadcastReceiver::ModelBroadcastReceiver() :
+            m_socket(0),
+            m_bytes(0),
+            m_chunkSize(0),
+            m_bEnabled(true),
+            m_bStarted(false),
+            m_round(0),
+            m_missing(0) {
+    }
+
+    ModelBroadcastReceiver::~ModelBroadcastReceiver() {
+        if (m_socket) {
+            m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket> >());
+        }
+    }
+
+    void
+    ModelBroadcastReceiver::Setup(Ptr<Node> node, Ipv4Address server, uint32_t bytes, uint32_t chunkSize,
+                                  Time nackTimeout, Callback<void> received) {
+        m_socket = Socket::CreateSocket(node, UdpSocketFactory::GetTypeId());
+        if (m_socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), ModelBroadcaster::DATA_PORT)) == -1) {
+            NS_FATAL_ERROR("Failed to bind broadcast socket");
+        }
+        m_socket->SetRecvCallback(MakeCallback(&ModelBroadcastReceiver::HandleRead, this));
+
+        m_server = server;
+        m_bytes = bytes;
+        m_chunkSize = std::max<uint32_t>(chunkSize, 1);
+        m_nackTimeout = nackTimeout;
+        m_received = received;
+    }
+
+    void
+    ModelBroadcastReceiver::SetEnabled(bool enabled) {
+        m_bEnabled = enabled;
+        if (!enabled) {
+            // Whatever arrived belongs to a round the client is leaving
+            m_bStarted = false;
+            m_nackEvent.Cancel();
+        }
+    }
+
+    void
+    ModelBroadcastReceiver::HandleRead(Ptr<Socket> socket) {
+        Ptr<Packet> packet;
+        while ((packet = socket->Recv())) {
+            ModelBroadcastHeader header;
+            if (!m_bEnabled || packet->GetSize() < HEADER_FIXED_SIZE || !packet->RemoveHeader(header) ||
+                header.type != ModelBroadcastHeader::CHUNK) {
+                continue;
+            }
+
+            if (!m_bStarted || header.round != m_round) {
+                uint32_t numChunks = (m_bytes + m_chunkSize - 1) / m_chunkSize;
+                m_bStarted = true;
+                m_round = header.round;
+                m_have.assign(numChunks, 0);
+                m_missing = numChunks;
+            }
+            if (header.index >= m_have.size()) {
+                continue;
+            }
+
+            if (m_missing == 0) {
+                // The server missed the confirmation and is still repairing
+                if (header.lastOfPass) {
+                    SendNack();
+                }
+                continue;
+            }
+
+            if (!m_have[header.index]) {
+                m_have[header.index] = 1;
+                m_missing--;
+            }
+
+            m_nackEvent.Cancel();
+            if (m_missing == 0) {
+                SendNack();
+                m_received();
+            } else if (header.lastOfPass) {
+                SendNack();
+            } else {
+                m_nackEvent = Simulator::Schedule(m_nackTimeout, &ModelBroadcastReceiver::SendNack, this);
+            }
+        }
+    }
+
+    void
+    ModelBroadcastReceiver::SendNack() {
+        ModelBroadcastHeader header;
+        header.type = ModelBroadcastHeader::NACK;
+        header.round = m_round;
+        if (m_missing > 0) {
+            // Keep the NACK within one chunk, the rest is asked for after the next pass
+            size_t maxMissing = m_chunkSize > HEADER_FIXED_SIZE + 4 ? (m_chunkSize - HEADER_FIXED_SIZE) / 4 : 1;
+            for (uint32_t chunk = 0; chunk < m_have.size() && header.missing.size() < maxMissing; chunk++) {
+                if (!m_have[chunk]) {
+                    header.missing.push_back(chunk);
+                }
+            }
+        }
+
+        Ptr<Packet> packet = Create<Packet>(0);
+        packet->AddHeader(header);
+        m_socket->SendTo(packet, 0, InetSocketAddress(m_server, ModelBroadcaster::NACK_PORT));
+    }
+}
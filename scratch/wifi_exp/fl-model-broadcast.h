@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_MODEL_BROADCAST_H
+#define FL_MODEL_BROADCAST_H
+
+#include "ns3/callback.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/header.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+    class Node;
+    class Socket;
+
+    /**
+    * \ingroup fl-server
+    * \brief Header of the model broadcast datagrams
+    *
+    * A CHUNK carries bytes [index * chunkSize, (index + 1) * chunkSize) of the model of a
+    * round; the last chunk of each pass is flagged so the clients answer at once. A NACK
+    * lists the chunks a client is missing, an empty NACK confirms the whole model arrived.
+    */
+    class ModelBroadcastHeader : public Header {
+    public:
+        /**
+        * \brief Datagram type
+        */
+        enum Type : uint8_t {
+            CHUNK = 0,   //!< Model bytes, server to clients
+            NACK = 1,    //!< Missing chunks, client to server
+        };
+
+        ModelBroadcastHeader();
+
+        static TypeId GetTypeId(void);
+        TypeId GetInstanceTypeId(void) const override;
+        void Print(std::ostream &os) const override;
+        uint32_t GetSerializedSize(void) const override;
+        void Serialize(Buffer::Iterator start) const override;
+        uint32_t Deserialize(Buffer::Iterator start) override;
+
+        Type type;                        //!< Datagram type
+        bool lastOfPass;                  //!< CHUNK: last chunk of the pass
+        uint32_t round;                   //!< Round of the model
+        uint32_t index;                   //!< CHUNK: chunk index
+        std::vector<uint32_t> missing;    //!< NACK: missing chunk indices
+    };
+
+    /**
+    * \ingroup fl-server
+    * \brief Sends the global model once to every client of a round over UDP broadcast
+    *
+    * Chunks are paced at the data rate. After each pass the broadcaster waits for the
+    * repair timeout and sends the union of the chunks the clients NACKed, or the whole
+    * model again if a client stayed silent (it missed the end of the pass). It stops once
+    * every receiver confirmed, was dropped, or after maxPasses passes.
+    */
+    class ModelBroadcaster {
+    public:
+        static const uint16_t DATA_PORT = 9000;   //!< Port the clients listen on
+        static const uint16_t NACK_PORT = 9001;   //!< Port the server listens on for NACKs
+
+        ModelBroadcaster();
+        ~ModelBroadcaster();
+
+        /**
+        * \brief Setup the broadcaster
+        * \param node           Server node
+        * \param destination    Broadcast address of the clients' subnet
+        * \param rate           Pacing rate
+        * \param chunkSize      Model bytes per datagram
+        * \param repairTimeout  Time waited for NACKs after each pass
+        * \param maxPasses      Passes before giving up on the receivers left
+        * \param delivered      Called with the address of each client that confirmed the model
+        */
+        void Setup(Ptr<Node> node, Ipv4Address destination, DataRate rate, uint32_t chunkSize,
+                   Time repairTimeout, uint32_t maxPasses, Callback<void, Ipv4Address> delivered);
+
+        /**
+        * \brief Start broadcasting the model of a round
+        * \param round      Round number carried by the chunks
+        * \param bytes      Model size
+        * \param receivers  Clients that must confirm the model
+        */
+        void Start(uint32_t round, uint32_t bytes, const std::vector<Ipv4Address> &receivers);
+
+        /**
+        * \brief Add a client after the start, it receives the whole model in the next pass
+        * \param receiver  Client address
+        */
+        void AddReceiver(Ipv4Address receiver);
+
+        /**
+        * \brief Stop waiting for a client, e.g. it disconnected
+        * \param receiver  Client address
+        */
+        void Drop(Ipv4Address receiver);
+
+        /**
+        * \brief Stop the broadcast
+        */
+        void Cancel();
+
+        /**
+        * \brief Get if a broadcast is in progress
+        * \return True until every receiver confirmed, was dropped, or the passes ran out
+        */
+        bool IsActive() const;
+
+        /**
+        * \brief Get number of chunks sent since Setup, repairs included
+        * \return Number of chunks
+        */
+        uint64_t GetChunksSent() const;
+
+    private:
+        /**
+        * \brief Send the next chunk of the pass, or wait for NACKs at the end of it
+        */
+        void SendNext();
+
+        /**
+        * \brief Start the next pass from the NACKs received
+        */
+        void EndPass();
+
+        /**
+        * \brief Read the NACKs
+        */
+        void HandleRead(Ptr<Socket> socket);
+
+        /**
+        * \brief Stop once nobody is left
+        */
+        void CheckDone();
+
+        Ptr<Socket> m_socket;                                   //!< Sends chunks and receives NACKs
+        Ipv4Address m_destination;                              //!< Broadcast address
+        DataRate m_rate;                                        //!< Pacing rate
+        uint32_t m_chunkSize;                                   //!< Model bytes per datagram
+        Time m_repairTimeout;                                   //!< Wait for NACKs after each pass
+        uint32_t m_maxPasses;                                   //!< Passes before giving up
+        Callback<void, Ipv4Address> m_delivered;                //!< Called when a client confirms
+
+        uint32_t m_round;                                       //!< Round being broadcast
+        uint32_t m_bytes;                                       //!< Model size
+        uint32_t m_numChunks;                                   //!< Chunks in the model
+        uint32_t m_passes;                                      //!< Passes started
+        std::vector<uint32_t> m_pass;                           //!< Chunks of the current pass
+        size_t m_next;                                          //!< Next chunk of the pass to send
+        std::vector<uint8_t> m_nacked;                          //!< Chunks NACKed since the last pass
+        std::unordered_map<Ipv4Address, bool, Ipv4AddressHash> m_pending;  //!< Receivers left, true if heard this pass
+        bool m_bActive;                                         //!< Broadcast in progress
+        uint64_t m_chunksSent;                                  //!< Chunks sent since Setup
+        EventId m_event;                                        //!< Next chunk or end of the pass
+    };
+
+    /**
+    * \ingroup fl-client
+    * \brief Receives the broadcast model and NACKs the missing chunks
+    *
+    * A NACK is sent when the last chunk of a pass arrives, or nackTimeout after the last
+    * chunk heard if the end of the pass was lost. A new round number resets the receiver.
+    */
+    class ModelBroadcastReceiver {
+    public:
+        ModelBroadcastReceiver();
+        ~ModelBroadcastReceiver();
+
+        /**
+        * \brief Setup the receiver
+        * \param node         Client node
+        * \param server       Server address, NACKs go to its NACK_PORT
+        * \param bytes        Model size
+        * \param chunkSize    Model bytes per datagram
+        * \param nackTimeout  Time without chunks before NACKing
+        * \param received     Called once the whole model of a round arrived
+        */
+        void Setup(Ptr<Node> node, Ipv4Address server, uint32_t bytes, uint32_t chunkSize, Time nackTimeout,
+                   Callback<void> received);
+
+        /**
+        * \brief Ignore the broadcast while disabled, e.g. the client is offline
+        * \param enabled  False to ignore
+        */
+        void SetEnabled(bool enabled);
+
+    private:
+        /**
+        * \brief Read the chunks
+        */
+        void HandleRead(Ptr<Socket> socket);
+
+        /**
+        * \brief Send the missing chunks, none once complete
+        */
+        void SendNack();
+
+        Ptr<Socket> m_socket;           //!< Receives chunks and sends NACKs
+        Ipv4Address m_server;           //!< Server address
+        uint32_t m_bytes;               //!< Model size
+        uint32_t m_chunkSize;           //!< Model bytes per datagram
+        Time m_nackTimeout;             //!< Time without chunks before NACKing
+        Callback<void> m_received;      //!< Called once the model arrived
+        bool m_bEnabled;                //!< Not ignoring the broadcast
+        bool m_bStarted;                //!< A round was heard
+        uint32_t m_round;               //!< Round being received
+        std::vector<uint8_t> m_have;    //!< Chunks received
+        uint32_t m_missing;             //!< Chunks not received yet
+        EventId m_nackEvent;            //!< NACK if nothing more arrives
+    };
+}
+
+#endif
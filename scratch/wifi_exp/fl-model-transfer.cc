@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-model-transfer.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE ("ModelTransfer");
+
+    ModelTransfer::ModelTransfer() :
+            m_socket(0),
+            m_rate(0),
+            m_burst(0),
+            m_paced(false),
+            m_remaining(0),
+            m_tokens(0),
+            m_lastRefill(),
+            m_event() {
+    }
+
+    ModelTransfer::~ModelTransfer() {
+        // Owners cancel pending wake ups while the simulator is alive, the socket may outlive us
+        if (m_socket) {
+            m_socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        }
+    }
+
+    void ModelTransfer::Setup(Ptr<Socket> socket, DataRate rate, uint32_t burst, bool paced,
+                              Callback<void, Ptr<Socket>, uint32_t> sent) {
+        m_socket = socket;
+        m_rate = rate;
+        m_burst = std::max<uint32_t>(burst, 1);
+        m_paced = paced && rate.GetBitRate() > 0;
+        m_sent = sent;
+    }
+
+    uint32_t ModelTransfer::GetBurst(uint32_t pacingBurst, uint32_t packetSize) {
+        return pacingBurst ? pacingBurst : BURST_PACKETS * packetSize;
+    }
+
+    void ModelTransfer::Start(uint32_t bytes) {
+        Cancel();
+        m_remaining = bytes;
+        m_tokens = m_burst;
+        m_lastRefill = Simulator::Now();
+        m_socket->SetSendCallback(MakeCallback(&ModelTransfer::HandleSend, this));
+        Pump();
+    }
+
+    void ModelTransfer::Cancel() {
+        m_remaining = 0;
+        if (m_event.IsRunning()) {
+            Simulator::Cancel(m_event);
+        }
+        if (m_socket) {
+            m_socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        }
+    }
+
+    uint32_t ModelTransfer::GetRemaining() const {
+        return m_remaining;
+    }
+
+    void ModelTransfer::HandleSend(Ptr<Socket> socket, uint32_t available) {
+        Pump();
+    }
+
+    void ModelTransfer::Pump() {
+        // Waiting for tokens, the scheduled wake up resumes
+        if (m_remaining == 0 || m_event.IsRunning()) {
+            return;
+        }
+
+        while (m_remaining) {
+            uint32_t bytes = std::min(m_remaining, m_socket->GetTxAvailable());
+            if (bytes == 0) {
+                // The send callback resumes once the buffer drains
+                return;
+            }
+
+            if (m_paced) {
+                Time now = Simulator::Now();
+                m_tokens = std::min<double>(m_burst, m_tokens + (now - m_lastRefill).GetSeconds() *
+                                                                m_rate.GetBitRate() / 8.0);
+                m_lastRefill = now;
+
+                uint32_t want = std::min(m_remaining, m_burst);
+                if (m_tokens < want) {
+                    // Wake up once a full burst (or the rest of the model) can go out
+                    double wait = (want - m_tokens) * 8.0 / m_rate.GetBitRate();
+                    m_event = Simulator::Schedule(NanoSeconds(std::ceil(wait * 1e9)), &ModelTransfer::Pump, this);
+                    return;
+                }
+                bytes = std::min(bytes, want);
+            }
+
+            int sent = m_socket->Send(Create<Packet>(bytes));
+            if (sent <= 0) {
+                // A full buffer is resumed by the send callback, a closed socket is dropped by
+                // the owner from its close callback
+                if (m_socket->GetErrno() != Socket::ERROR_MSGSIZE) {
+                    NS_LOG_WARN("Model write of " << bytes << " bytes failed, errno " << m_socket->GetErrno());
+                }
+                return;
+            }
+
+            m_remaining -= sent;
+            if (m_paced) {
+                m_tokens -= sent;
+            }
+            if (!m_sent.IsNull()) {
+                m_sent(m_socket, sent);
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_MODEL_TRANSFER_H
+#define FL_MODEL_TRANSFER_H
+
+#include "ns3/callback.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+    class Socket;
+
+    /**
+    * \ingroup fl-client
+    * \brief Sends a model over a connected socket
+    *
+    * Each write fills the socket send buffer with as many bytes as GetTxAvailable allows
+    * (one Packet per write); the transfer resumes from the socket send callback when
+    * buffer space frees up instead of polling. With pacing, writes are further limited by
+    * a token bucket filled at the data rate and holding at most burst bytes, and a single
+    * event is scheduled for when enough tokens have accrued. The default burst of
+    * BURST_PACKETS packets writes them as one Packet per wake up, keeping the average rate;
+    * a burst equal to the max packet size keeps the timing of sending one packet every
+    * size / rate seconds, at the cost of one event and one Packet per packet.
+    */
+    class ModelTransfer {
+    public:
+        static constexpr uint32_t BURST_PACKETS = 16;  //!< Default burst, in max size packets
+
+        ModelTransfer();
+        ~ModelTransfer();
+
+        /**
+        * \brief Setup the transfer
+        * \param socket   Connected socket to send on
+        * \param rate     Pacing rate
+        * \param burst    Token bucket depth in bytes
+        * \param paced    If false, only the socket send buffer limits the writes
+        * \param sent     Called after every write with the socket and the bytes written
+        */
+        void Setup(Ptr<Socket> socket, DataRate rate, uint32_t burst, bool paced,
+                   Callback<void, Ptr<Socket>, uint32_t> sent);
+
+        /**
+        * \brief Get the token bucket depth of a PacingBurst attribute
+        * \param pacingBurst  Attribute value in bytes, 0 for the default
+        * \param packetSize   Max packet size
+        * \return pacingBurst, or BURST_PACKETS packets if it is 0
+        */
+        static uint32_t GetBurst(uint32_t pacingBurst, uint32_t packetSize);
+
+        /**
+        * \brief Start sending bytes; the token bucket starts full
+        * \param bytes  Number of bytes to send
+        */
+        void Start(uint32_t bytes);
+
+        /**
+        * \brief Stop the transfer, bytes not written yet are dropped
+        */
+        void Cancel();
+
+        /**
+        * \brief Get number of bytes left to write
+        * \return Number of bytes
+        */
+        uint32_t GetRemaining() const;
+
+    private:
+        /**
+        * \brief Socket send callback
+        */
+        void HandleSend(Ptr<Socket> socket, uint32_t available);
+
+        /**
+        * \brief Write as much as the send buffer and the tokens allow, then wait
+        */
+        void Pump();
+
+        Ptr<Socket> m_socket;                             //!< Connected socket
+        DataRate m_rate;                                  //!< Pacing rate
+        uint32_t m_burst;                                 //!< Token bucket depth
+        bool m_paced;                                     //!< Pacing enabled
+        Callback<void, Ptr<Socket>, uint32_t> m_sent;     //!< Called after every write
+        uint32_t m_remaining;                             //!< Bytes left to write
+        double m_tokens;                                  //!< Tokens, in bytes
+        Time m_lastRefill;                                //!< Last time tokens were added
+        EventId m_event;                                  //!< Pending wake up for tokens
+    };
+}
+
+#endif
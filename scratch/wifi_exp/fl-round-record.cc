@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-round-record.h"
+
+namespace ns3 {
+
+    size_t RoundRecordWriter::Block::Size() const {
+        return id.size();
+    }
+
+    RoundRecordWriter::RoundRecordWriter(FILE *fp, Format format, bool background) :
+            m_fp(fp),
+            m_format(format),
+            m_background(background),
+            m_stop(false) {
+        if (m_format == Format::BINARY) {
+            uint32_t header[2] = {MAGIC, VERSION};
+            fwrite(header, sizeof(header), 1, m_fp);
+        }
+        if (m_background) {
+            m_thread = std::thread(&RoundRecordWriter::Run, this);
+        }
+    }
+
+    RoundRecordWriter::~RoundRecordWriter() {
+        EndRound();
+        if (m_background) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cv.notify_one();
+            m_thread.join();
+        }
+    }
+
+    void RoundRecordWriter::Add(const RoundRecord &record) {
+        m_current.round.push_back(record.round);
+        m_current.id.push_back(record.id);
+        m_current.beginUplink.push_back(record.beginUplink);
+        m_current.endUplink.push_back(record.endUplink);
+        m_current.beginDownlink.push_back(record.beginDownlink);
+        m_current.endDownlink.push_back(record.endDownlink);
+        m_current.compEnergy.push_back(record.compEnergy);
+        m_current.tranEnergy.push_back(record.tranEnergy);
+    }
+
+    void RoundRecordWriter::EndRound() {
+        if (m_current.Size() == 0) {
+            return;
+        }
+
+        if (m_background) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_queue.push_back(std::move(m_current));
+            }
+            m_cv.notify_one();
+        } else {
+            Write(m_current);
+        }
+        m_current = Block();
+    }
+
+    void RoundRecordWriter::Run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            Block block = std::move(m_queue.front());
+            m_queue.pop_front();
+
+            lock.unlock();
+            Write(block);
+            lock.lock();
+        }
+    }
+
+    void RoundRecordWriter::Write(const Block &block) {
+        uint32_t n = block.Size();
+        if (m_format == Format::CSV) {
+            for (uint32_t i = 0; i < n; i++) {
+                fprintf(m_fp, "%i,%u,%f,%f,%f,%f,%f,%f\n",
+                        block.round[i], block.id[i],
+                        block.beginUplink[i], block.endUplink[i],
+                        block.beginDownlink[i], block.endDownlink[i],
+                        block.compEnergy[i], block.tranEnergy[i]);
+            }
+        } else {
+            fwrite(&n, sizeof(n), 1, m_fp);
+            fwrite(block.round.data(), sizeof(int32_t), n, m_fp);
+            fwrite(block.id.data(), sizeof(uint32_t), n, m_fp);
+            for (const std::vector<double> *column: {&block.beginUplink, &block.endUplink,
+                                                     &block.beginDownlink, &block.endDownlink,
+                                                     &block.compEnergy, &block.tranEnergy}) {
+                fwrite(column->data(), sizeof(double), n, m_fp);
+            }
+        }
+        fflush(m_fp);
+    }
+
+    bool RoundRecordWriter::ConvertToCsv(FILE *in, FILE *out) {
+        uint32_t header[2];
+        if (fread(header, sizeof(header), 1, in) != 1 || header[0] != MAGIC || header[1] != VERSION) {
+            return false;
+        }
+
+        // A malformed count must not allocate more than the file holds
+        long start = ftell(in);
+        if (start < 0 || fseek(in, 0, SEEK_END) != 0) {
+            return false;
+        }
+        long end = ftell(in);
+        if (end < start || fseek(in, start, SEEK_SET) != 0) {
+            return false;
+        }
+        const size_t recordBytes = sizeof(int32_t) + sizeof(uint32_t) + 6 * sizeof(double);
+
+        RoundRecordWriter writer(out, Format::CSV, false);
+        uint32_t n;
+        while (fread(&n, sizeof(n), 1, in) == 1) {
+            long position = ftell(in);
+            if (position < 0 || n > (size_t) (end - position) / recordBytes) {
+                return false;
+            }
+            Block &block = writer.m_current;
+            block.round.resize(n);
+            block.id.resize(n);
+            bool ok = fread(block.round.data(), sizeof(int32_t), n, in) == n &&
+                      fread(block.id.data(), sizeof(uint32_t), n, in) == n;
+            for (std::vector<double> *column: {&block.beginUplink, &block.endUplink,
+                                               &block.beginDownlink, &block.endDownlink,
+                                               &block.compEnergy, &block.tranEnergy}) {
+                column->resize(n);
+                ok = ok && fread(column->data(), sizeof(double), n, in) == n;
+            }
+            if (!ok) {
+                writer.m_current = Block();
+                return false;
+            }
+            writer.EndRound();
+        }
+        return true;
+    }
+}
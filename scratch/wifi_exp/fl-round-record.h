@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_ROUND_RECORD_H
+#define FL_ROUND_RECORD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-experiment
+    * \brief Result of one client upload
+    */
+    struct RoundRecord {
+        int32_t round;
+        uint32_t id;
+        double beginUplink;
+        double endUplink;
+        double beginDownlink;
+        double endDownlink;
+        double compEnergy;
+        double tranEnergy;
+    };
+
+    /**
+    * \ingroup fl-experiment
+    * \brief Buffers the round records in memory and writes them once per round
+    *
+    * Records are kept column by column until EndRound, which writes them as CSV lines
+    * (round, id, begin/end uplink, begin/end downlink, comp energy, tx energy) or as a
+    * binary block, optionally from a background thread so the simulation does not wait
+    * on the disk.
+    *
+    * Binary layout: a "FLRR" magic and a uint32_t version, then one block per round made
+    * of a uint32_t record count n followed by the columns in RoundRecord order, each n
+    * values long (int32_t, uint32_t, then six doubles), native endianness.
+    */
+    class RoundRecordWriter {
+    public:
+        /**
+         * \brief Output format
+         */
+        enum class Format {
+            CSV,
+            BINARY,
+        };
+
+        static constexpr uint32_t MAGIC = 0x52524c46;   //!< "FLRR"
+        static constexpr uint32_t VERSION = 1;          //!< Binary layout version
+
+        /**
+        * \brief Constructs RoundRecordWriter
+        * \param fp          Output file, still owned by the caller
+        * \param format      Output format
+        * \param background  Write from a background thread
+        */
+        RoundRecordWriter(FILE *fp, Format format, bool background);
+
+        /**
+        * \brief Writes the pending records and stops the background thread
+        */
+        ~RoundRecordWriter();
+
+        /**
+        * \brief Buffers one record
+        * \param record  Record to add
+        */
+        void Add(const RoundRecord &record);
+
+        /**
+        * \brief Writes and flushes the records of the round
+        */
+        void EndRound();
+
+        /**
+        * \brief Converts a binary log to CSV
+        * \param in   Binary log, seekable
+        * \param out  CSV output
+        * \return     False if the binary log is malformed
+        */
+        static bool ConvertToCsv(FILE *in, FILE *out);
+
+    private:
+        /**
+         * \brief Records of one round, column by column
+         */
+        struct Block {
+            std::vector<int32_t> round;
+            std::vector<uint32_t> id;
+            std::vector<double> beginUplink;
+            std::vector<double> endUplink;
+            std::vector<double> beginDownlink;
+            std::vector<double> endDownlink;
+            std::vector<double> compEnergy;
+            std::vector<double> tranEnergy;
+
+            size_t Size() const;
+        };
+
+        /**
+        * \brief Writes and flushes a block
+        */
+        void Write(const Block &block);
+
+        /**
+        * \brief Background thread loop
+        */
+        void Run();
+
+        FILE *m_fp;                         //!< Output file
+        Format m_format;                    //!< Output format
+        Block m_current;                    //!< Records of the current round
+        bool m_background;                  //!< Write from a background thread
+        std::thread m_thread;               //!< Background writer
+        std::mutex m_mutex;                 //!< Protects m_queue and m_stop
+        std::condition_variable m_cv;       //!< Signals m_queue and m_stop changes
+        std::deque<Block> m_queue;          //!< Rounds waiting for the background writer
+        bool m_stop;                        //!< Background writer must exit once m_queue is empty
+    };
+}
+
+#endif
@@ -35,6 +35,7 @@
 #include "ns3/integer.h"
 #include "ns3/uinteger.h"
 #include "ns3/inet-socket-address.h"
+#include "ns3/ipv4.h"
 #include "fl-sim-interface.h"
 
 namespace ns3 {
@@ -54,6 +55,20 @@ namespace ns3 {
                               DataRateValue(DataRate("1b/s")),
                               MakeDataRateAccessor(&Server::m_dataRate),
                               MakeDataRateChecker())
+                .AddAttribute("Pacing",
+                              "Pace the model transfer at DataRate, otherwise only the "
+                              "TCP send buffer limits it",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(true),
+                              MakeBooleanAccessor(&Server::m_bPacing),
+                              MakeBooleanChecker())
+                .AddAttribute("PacingBurst",
+                              "Bytes that can be written at once when pacing, "
+                              "0 for ModelTransfer::BURST_PACKETS MaxPacketSize packets",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&Server::m_pacingBurst),
+                              MakeUintegerChecker<uint32_t>())
 
                 .AddAttribute("Local",
                               "The Address on which to Bind the rx socket.",
@@ -89,13 +104,127 @@ namespace ns3 {
                               TypeId::ATTR_SGC,
                               TimeValue(),
                               MakeTimeAccessor(&Server::m_timeOffset),
-                              MakeTimeChecker());
+                              MakeTimeChecker())
+                .AddAttribute("Persistent",
+                              "Keep client connections across rounds and stop the simulation "
+                              "once every in-round client finished its upload",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(false),
+                              MakeBooleanAccessor(&Server::m_bPersistent),
+                              MakeBooleanChecker())
+                .AddAttribute("RoundTimeout",
+                              "Longest time from sending the model to receiving the update "
+                              "before the client is dropped, 0 for none",
+                              TypeId::ATTR_SGC,
+                              TimeValue(Time(0)),
+                              MakeTimeAccessor(&Server::m_roundTimeout),
+                              MakeTimeChecker())
+                .AddAttribute("AggregationOverhead",
+                              "Fixed time spent aggregating the updates of a round (sync) "
+                              "or each update (async)",
+                              TypeId::ATTR_SGC,
+                              TimeValue(Time(0)),
+                              MakeTimeAccessor(&Server::m_aggregationOverhead),
+                              MakeTimeChecker())
+                .AddAttribute("AggregationRate",
+                              "Rate at which the server aggregates update bytes, 0 for free",
+                              TypeId::ATTR_SGC,
+                              DataRateValue(DataRate(0)),
+                              MakeDataRateAccessor(&Server::m_aggregationRate),
+                              MakeDataRateChecker())
+                .AddAttribute("Broadcast",
+                              "Send the model once per round over UDP broadcast with NACK repair "
+                              "instead of once per TCP connection (sync only)",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(false),
+                              MakeBooleanAccessor(&Server::m_bBroadcast),
+                              MakeBooleanChecker())
+                .AddAttribute("BroadcastHoldoff",
+                              "Longest wait for the in-round clients to connect before broadcasting",
+                              TypeId::ATTR_SGC,
+                              TimeValue(Seconds(1.0)),
+                              MakeTimeAccessor(&Server::m_broadcastHoldoff),
+                              MakeTimeChecker())
+                .AddAttribute("BroadcastRepairTimeout",
+                              "Time waited for NACKs after each broadcast pass",
+                              TypeId::ATTR_SGC,
+                              TimeValue(MilliSeconds(50)),
+                              MakeTimeAccessor(&Server::m_repairTimeout),
+                              MakeTimeChecker())
+                .AddAttribute("BroadcastMaxPasses",
+                              "Broadcast passes before giving up on the clients that did not confirm",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(50),
+                              MakeUintegerAccessor(&Server::m_maxPasses),
+                              MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("HoldModel",
+                              "Hold the model until ReleaseModel, e.g. until an edge aggregator "
+                              "received it from the root",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(false),
+                              MakeBooleanAccessor(&Server::m_bHoldModel),
+                              MakeBooleanChecker())
+                .AddAttribute("AsyncTimeBudget",
+                              "Async: simulated time before stopping, 0 for none",
+                              TypeId::ATTR_SGC,
+                              TimeValue(Time(0)),
+                              MakeTimeAccessor(&Server::m_timeBudget),
+                              MakeTimeChecker())
+                .AddAttribute("AsyncWallBudget",
+                              "Async: wall clock time before stopping, checked at every update, 0 for none",
+                              TypeId::ATTR_SGC,
+                              TimeValue(Time(0)),
+                              MakeTimeAccessor(&Server::m_wallBudget),
+                              MakeTimeChecker())
+                .AddAttribute("AsyncMaxUpdates",
+                              "Async: updates aggregated before stopping, 0 for none",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&Server::m_maxUpdates),
+                              MakeUintegerChecker<uint32_t>())
+                .AddAttribute("AsyncMaxCycles",
+                              "Async: stop once a client completed this many cycles, 0 for none",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(3),
+                              MakeUintegerAccessor(&Server::m_maxCycles),
+                              MakeUintegerChecker<uint32_t>())
+                .AddAttribute("AsyncStopAllCycled",
+                              "Async: stop once every in-round client completed a cycle",
+                              TypeId::ATTR_SGC,
+                              BooleanValue(true),
+                              MakeBooleanAccessor(&Server::m_bStopAllCycled),
+                              MakeBooleanChecker())
+                .AddAttribute("AsyncMaxStaleness",
+                              "Async: updates trained on a model more than this many aggregations old "
+                              "are discarded and the client restarts from the current model, 0 for no bound",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&Server::m_maxStaleness),
+                              MakeUintegerChecker<uint32_t>())
+                .AddAttribute("AsyncBufferSize",
+                              "Async: updates buffered per aggregation (FedBuff K). With 1 a client waits "
+                              "for the aggregation of its update, otherwise it goes on with the current model",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(1),
+                              MakeUintegerAccessor(&Server::m_bufferSize),
+                              MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("AsyncReportBatch",
+                              "Async: messages sent to flsim per write, pending ones are flushed at the stop",
+                              TypeId::ATTR_SGC,
+                              UintegerValue(1),
+                              MakeUintegerAccessor(&Server::m_reportBatch),
+                              MakeUintegerChecker<uint32_t>(1));
 
 
         return tid;
     }
 
-    Server::Server() : m_packetSize(0), m_sendEvent(), m_bytesModel(0), m_bAsync(false), m_fLSimProvider(nullptr) {
+    Server::Server() : m_packetSize(0), m_bytesModel(0), m_bPacing(true), m_pacingBurst(0), m_bAsync(false), m_fLSimProvider(nullptr),
+                       m_round(0), m_bPersistent(false), m_nRoundCompleted(0), m_roundTimeout(0),
+                       m_aggregationOverhead(0), m_aggregationRate(0), m_nUpdates(0), m_bBroadcast(false),
+                       m_maxPasses(50), m_bHoldModel(false), m_maxUpdates(0), m_maxCycles(3),
+                       m_bStopAllCycled(true), m_maxStaleness(0), m_bufferSize(1), m_reportBatch(1),
+                       m_modelVersion(0), m_nAggregated(0), m_nBuffered(0), m_bStopped(false) {
         m_socket = 0;
     }
 
@@ -103,7 +232,7 @@ namespace ns3 {
         NS_LOG_FUNCTION(this);
     }
 
-    std::map <Ptr<Socket>, std::shared_ptr<Server::ClientSessionData>>
+    const Server::SocketList &
     Server::GetAcceptedSockets(void) const {
         NS_LOG_FUNCTION(this);
         return m_socketList;
@@ -113,6 +242,8 @@ namespace ns3 {
         NS_LOG_FUNCTION(this);
         m_socket = 0;
         m_socketList.clear();
+        m_held.clear();
+        m_roundEnd = MakeNullCallback<void>();
 
         // chain up
         Application::DoDispose();
@@ -141,6 +272,24 @@ namespace ns3 {
                 MakeCallback(&Server::HandlePeerClose, this),
                 MakeCallback(&Server::HandlePeerError, this));
 
+        if (m_bAsync) {
+            m_wallStart = std::chrono::steady_clock::now();
+            if (m_timeBudget.IsStrictlyPositive()) {
+                m_budgetEvent = Simulator::Schedule(m_timeBudget, &Server::StopAsync, this);
+            }
+        }
+
+        if (m_bBroadcast && m_bAsync) {
+            NS_LOG_UNCOND("Broadcast downlink is only supported for sync learning, sending per connection");
+            m_bBroadcast = false;
+        }
+        if (m_bBroadcast) {
+            // Every client shares the server's subnet, a subnet-directed broadcast reaches all of them
+            Ipv4InterfaceAddress iface = GetNode()->GetObject<Ipv4>()->GetAddress(1, 0);
+            m_broadcaster.Setup(GetNode(), iface.GetLocal().GetSubnetDirectedBroadcast(iface.GetMask()),
+                                m_dataRate, m_packetSize, m_repairTimeout, m_maxPasses,
+                                MakeCallback(&Server::BroadcastDelivered, this));
+        }
     }
 
     void Server::StopApplication()     // Called at time specified by Stop
@@ -148,12 +297,14 @@ namespace ns3 {
         NS_LOG_FUNCTION(this);
         NS_LOG_UNCOND("Stopping Application");
 
-        if (m_sendEvent.IsRunning()) {
-            Simulator::Cancel(m_sendEvent);
-        }
+        m_broadcaster.Cancel();
+        m_broadcastEvent.Cancel();
+        m_budgetEvent.Cancel();
 
         //Close all connections
         for (auto const &itr: m_socketList) {
+            itr.second->m_transfer.Cancel();
+            itr.second->m_timeout.Cancel();
             itr.first->Close();
             itr.first->SetRecvCallback(MakeNullCallback < void, Ptr < Socket > > ());
         }
@@ -181,7 +332,7 @@ namespace ns3 {
                 return;
             }
 
-            if (itr->second->m_bytesReceived % m_bytesModel == 0) {
+            if (itr->second->m_bytesModelToReceive == itr->second->m_bytesUpdate) {
                 itr->second->m_timeBeginReceivingModelFromClient = Simulator::Now();
             }
 
@@ -201,34 +352,50 @@ namespace ns3 {
                 auto endDownlink=
                     itr->second->m_timeEndSendingModelFromClient.GetSeconds() +  m_timeOffset.GetSeconds();
 
-                auto energy = FLEnergy();
-                energy.SetDeviceType("400");
-                energy.SetLearningModel("CIFAR-10");
-                energy.SetEpochs(5.0);
-                double compEnergy = energy.CalcComputationalEnergy(beginUplink-endDownlink);
-                double tranEnergy = energy.CalcTransmissionEnergy(endUplink-beginUplink);
-                NS_LOG_UNCOND(energy.GetA());
-                fprintf(m_fp, "%i,%u,%f,%f,%f,%f,%f,%f\n",
-                         m_round,
-                         m_clientSessionManager->ResolveToIdFromServer(socket),
-                         beginUplink, endUplink,
-                         beginDownlink, endDownlink,
-                         compEnergy, tranEnergy
-                );
-                fflush(m_fp);
+                int id = m_clientSessionManager->ResolveToIdFromServer(socket);
+                // The root of the hierarchical topology does not log its edge aggregators, nor
+                // unknown peers
+                if (m_log && id >= 0) {
+                    const auto &profile = FLEnergy::GetProfile(m_clientSessionManager->GetEnergyProfile(id));
+                    double compEnergy = profile.computationPower * (beginUplink - endDownlink);
+                    double tranEnergy = profile.transmissionPower * (endUplink - beginUplink);
+                    m_log->Add(RoundRecord{
+                            m_round,
+                            (uint32_t) id,
+                            beginUplink, endUplink,
+                            beginDownlink, endDownlink,
+                            compEnergy, tranEnergy
+                    });
+                }
+
+                itr->second->m_timeout.Cancel();
+                m_nUpdates++;
+                Time decode = Seconds(id >= 0 ? m_clientSessionManager->GetDecodeTime(id) : 0);
+                m_decodeTime += decode;
+
+                if ((m_bPersistent || !m_roundEnd.IsNull()) && !m_bAsync) {
+                    EndUpload();
+                }
 
                 if (m_bAsync) {
+                    uint32_t staleness = m_modelVersion - itr->second->m_modelVersion;
+                    bool stale = m_maxStaleness > 0 && staleness > m_maxStaleness;
 
-                    if (m_fLSimProvider) {
+                    if (m_fLSimProvider && (!stale || m_fLSimProvider->ReportsStaleness())) {
                         FLSimProvider::AsyncMessage message;
 
-                        message.id = m_clientSessionManager->ResolveToIdFromServer(socket);
+                        message.id = id;
                         message.endTime = endUplink;
                         message.startTime = beginDownlink;
                         message.throughput = itr->second->m_bytesReceived * 8.0 / 1000.0 /
                                              ((endUplink - beginUplink));
+                        message.status = stale ? FLSimProvider::AsyncMessage::Status::STALE
+                                               : FLSimProvider::AsyncMessage::Status::COMPLETE;
+                        message.bytesReceived = itr->second->m_bytesUpdate;
+                        message.staleness = staleness;
+                        message.modelVersion = itr->second->m_modelVersion;
 
-                        m_fLSimProvider->send(&message);
+                        Report(message);
 
                         ns3::Address addr;
                         socket->GetPeerName(addr);
@@ -241,23 +408,43 @@ namespace ns3 {
                                              "  Begin uplink=" << beginUplink << std::endl <<
                                              "  End uplink=" << endUplink << std::endl <<
                                              "  Round time=" << (endUplink - beginDownlink) << std::endl <<
-                                             "  UplinkDifference=" << (endUplink - beginUplink) << std::endl);
+                                             "  UplinkDifference=" << (endUplink - beginUplink) << std::endl <<
+                                             "  Staleness=" << staleness << std::endl);
                     }
 
-                    m_clientSessionManager->IncrementCycleCountFromServer(socket);
+                    if (stale) {
+                        NS_LOG_UNCOND("[SERVER]  Client " << id << " update discarded, staleness " << staleness);
+                    } else {
+                        m_nAggregated++;
+                    }
 
-                    if (m_clientSessionManager->HasAllClientsFinishedFirstCycle() ||
-                        (m_clientSessionManager->GetRound(socket) == 3)) {
-                        m_clientSessionManager->Close();
-                        if (m_fLSimProvider) {
-                            m_fLSimProvider->end();
+                    if (!EndCycle(socket)) {
+                        if (stale) {
+                            // Nothing to fold in, the client starts over from the current model
+                            StartSendingModel(socket);
+                        } else if (m_bufferSize > 1) {
+                            // The client goes on with the current model, the buffer is folded in once full
+                            m_nBuffered++;
+                            m_bufferDecodeTime += decode;
+                            if (m_nBuffered >= m_bufferSize) {
+                                Time aggregation = m_bufferDecodeTime +
+                                                   GetAggregationTime(m_aggregationOverhead, m_aggregationRate,
+                                                                      m_nBuffered, m_bytesModel);
+                                m_nBuffered = 0;
+                                m_bufferDecodeTime = Time(0);
+                                Simulator::Schedule(aggregation, &Server::AsyncAggregated, this, nullptr);
+                            }
+                            StartSendingModel(socket);
+                        } else {
+                            // The next model goes out once this update is folded in
+                            Time aggregation = decode + GetAggregationTime(m_aggregationOverhead, m_aggregationRate,
+                                                                           1, m_bytesModel);
+                            if (aggregation.IsZero()) {
+                                AsyncAggregated(socket);
+                            } else {
+                                Simulator::Schedule(aggregation, &Server::AsyncAggregated, this, socket);
+                            }
                         }
-
-                        m_timeOffset = Simulator::Now() + Time(m_timeOffset.GetSeconds());
-                        NS_LOG_UNCOND("STOPPING_SIMULATION" << std::endl << std::endl);
-                        Simulator::Stop();
-                    } else {
-                        StartSendingModel(socket);
                     }
                 }
             }
@@ -269,10 +456,184 @@ namespace ns3 {
 
     void Server::HandlePeerClose(Ptr <Socket> socket) {
         NS_LOG_FUNCTION(this << socket);
+        auto itr = m_socketList.find(socket);
+        if (itr != m_socketList.end() && itr->second->m_bytesModelToReceive > 0) {
+            UploadFailed(socket, FLSimProvider::AsyncMessage::Status::DISCONNECTED);
+        }
     }
 
     void Server::HandlePeerError(Ptr <Socket> socket) {
         NS_LOG_FUNCTION(this << socket);
+        HandlePeerClose(socket);
+    }
+
+    void Server::UploadFailed(Ptr <Socket> socket, FLSimProvider::AsyncMessage::Status status) {
+        NS_LOG_FUNCTION(this << socket);
+        auto itr = m_socketList.find(socket);
+        if (itr == m_socketList.end()) {
+            return;
+        }
+        std::shared_ptr<ClientSessionData> session = itr->second;
+        session->m_timeout.Cancel();
+        session->m_transfer.Cancel();
+
+        int id = m_clientSessionManager->ResolveToIdFromServer(socket);
+        uint32_t received = session->m_bytesUpdate - session->m_bytesModelToReceive;
+        session->m_bytesModelToReceive = 0;
+
+        double now = Simulator::Now().GetSeconds() + m_timeOffset.GetSeconds();
+        double beginDownlink = session->m_timeBeginSendingModelFromClient.GetSeconds() + m_timeOffset.GetSeconds();
+        double beginUplink = session->m_timeBeginReceivingModelFromClient.GetSeconds() + m_timeOffset.GetSeconds();
+        NS_LOG_UNCOND("[SERVER]  Client " << id << " dropped ("
+                                          << (status == FLSimProvider::AsyncMessage::Status::TIMEOUT ?
+                                              "timeout" : "disconnected")
+                                          << "), received " << received << " of " << session->m_bytesUpdate << " bytes");
+
+        // The connection is not reused, a client coming back connects again
+        socket->SetRecvCallback(MakeNullCallback < void, Ptr < Socket > > ());
+        socket->SetCloseCallbacks(MakeNullCallback < void, Ptr < Socket > > (),
+                                  MakeNullCallback < void, Ptr < Socket > > ());
+        Simulator::ScheduleNow(&Socket::Close, socket);
+
+        if (m_bBroadcast) {
+            m_broadcaster.Drop(InetSocketAddress::ConvertFrom(session->m_address).GetIpv4());
+        }
+
+        if (m_bAsync) {
+            if (m_fLSimProvider && m_fLSimProvider->ReportsFailures()) {
+                FLSimProvider::AsyncMessage message;
+                message.id = id;
+                message.startTime = beginDownlink;
+                message.endTime = now;
+                message.throughput = (received > 0 && now > beginUplink) ?
+                                     received * 8.0 / 1000.0 / (now - beginUplink) : 0;
+                message.status = status;
+                message.bytesReceived = received;
+                message.staleness = m_modelVersion - session->m_modelVersion;
+                message.modelVersion = session->m_modelVersion;
+                Report(message);
+            }
+            EndCycle(socket);
+        } else {
+            if (id >= 0) {
+                m_clientSessionManager->SetDropOut(id);
+            }
+            if (m_bPersistent || !m_roundEnd.IsNull()) {
+                EndUpload();
+            }
+        }
+
+        m_clientSessionManager->Forget(socket);
+        m_socketList.erase(socket);
+    }
+
+    bool Server::EndCycle(Ptr <Socket> socket) {
+        m_clientSessionManager->IncrementCycleCountFromServer(socket);
+
+        bool stop = (m_bStopAllCycled && m_clientSessionManager->HasAllClientsFinishedFirstCycle()) ||
+                    (m_maxCycles > 0 && m_clientSessionManager->GetRound(socket) >= (int) m_maxCycles) ||
+                    (m_maxUpdates > 0 && m_nAggregated >= m_maxUpdates);
+        if (!stop && m_wallBudget.IsStrictlyPositive()) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_wallStart;
+            stop = elapsed.count() >= m_wallBudget.GetSeconds();
+        }
+
+        if (stop || m_bStopped) {
+            StopAsync();
+            return true;
+        }
+        return false;
+    }
+
+    void Server::StopAsync() {
+        if (m_bStopped) {
+            return;
+        }
+        m_bStopped = true;
+        m_budgetEvent.Cancel();
+
+        m_clientSessionManager->Close();
+        FlushReports();
+        if (m_fLSimProvider) {
+            m_fLSimProvider->end();
+        }
+
+        m_timeOffset = Simulator::Now() + Time(m_timeOffset.GetSeconds());
+        NS_LOG_UNCOND("STOPPING_SIMULATION" << std::endl << std::endl);
+        Simulator::Stop();
+    }
+
+    void Server::AsyncAggregated(Ptr <Socket> socket) {
+        m_modelVersion++;
+        if (socket) {
+            StartSendingModel(socket);
+        }
+    }
+
+    void Server::Report(const FLSimProvider::AsyncMessage &message) {
+        m_reports.push_back(message);
+        if (m_reports.size() >= m_reportBatch) {
+            FlushReports();
+        }
+    }
+
+    void Server::FlushReports() {
+        if (m_reports.empty() || !m_fLSimProvider) {
+            return;
+        }
+        if (m_reports.size() == 1) {
+            m_fLSimProvider->send(&m_reports[0]);
+        } else {
+            m_fLSimProvider->send(m_reports);
+        }
+        m_reports.clear();
+    }
+
+    void Server::EndUpload() {
+        m_nRoundCompleted++;
+        if (m_nRoundCompleted == m_clientSessionManager->GetNumInRound()) {
+            NS_LOG_UNCOND("ROUND_COMPLETE" << std::endl);
+            m_broadcaster.Cancel();
+            Time aggregation = m_decodeTime + GetAggregationTime(m_aggregationOverhead, m_aggregationRate,
+                                                                 m_nUpdates, m_bytesModel);
+            if (!m_roundEnd.IsNull()) {
+                Simulator::Schedule(aggregation, &Server::NotifyRoundEnd, this);
+            } else if (aggregation.IsZero()) {
+                Simulator::Stop();
+            } else {
+                Simulator::Stop(aggregation);
+            }
+        }
+    }
+
+    void Server::SetRoundEndCallback(Callback<void> roundEnd) {
+        m_roundEnd = roundEnd;
+    }
+
+    void Server::NotifyRoundEnd() {
+        m_roundEnd();
+    }
+
+    void Server::ReleaseModel() {
+        m_bHoldModel = false;
+        for (auto &socket: m_held) {
+            // Dropped while the model was held
+            if (m_socketList.find(socket) != m_socketList.end()) {
+                BeginDownlink(socket);
+            }
+        }
+        m_held.clear();
+    }
+
+    Time Server::GetAggregationTime(Time overhead, DataRate rate, uint32_t nUpdates, uint32_t bytes) {
+        if (nUpdates == 0) {
+            return Time(0);
+        }
+        Time aggregation = overhead;
+        if (rate.GetBitRate() > 0) {
+            aggregation += Seconds((double) nUpdates * bytes * 8.0 / rate.GetBitRate());
+        }
+        return aggregation;
     }
 
     bool Server::ConnectionRequestCallback(Ptr <Socket> socket, const Address &address) {
@@ -287,8 +648,17 @@ namespace ns3 {
 
         auto nsess = m_socketList.insert(std::make_pair(socket, clientSession));
         nsess.first->second->m_address = from;
+        nsess.first->second->m_transfer.Setup(socket, m_dataRate, ModelTransfer::GetBurst(m_pacingBurst, m_packetSize),
+                                              m_bPacing, MakeCallback(&Server::ModelSent, this));
         socket->SetRecvCallback(MakeCallback(&Server::ReceivedDataCallback, this));
-        StartSendingModel(socket);
+        // A client that dropped out of a sync round comes back for the next one
+        if (m_clientSessionManager->IsInRound(socket) && !m_clientSessionManager->IsDropOut(socket)) {
+            if (m_bHoldModel) {
+                m_held.push_back(socket);
+            } else {
+                BeginDownlink(socket);
+            }
+        }
 
         NS_LOG_UNCOND("Accept:" << m_clientSessionManager->ResolveToIdFromServer(socket));
 
@@ -300,64 +670,136 @@ namespace ns3 {
         }
     }
 
-    void Server::ServerHandleSend(Ptr <Socket> socket, uint32_t available) {
-        m_socket->SetSendCallback(MakeNullCallback < void, Ptr < Socket > , uint32_t > ());
+    void Server::StartRound(int round) {
+        NS_LOG_FUNCTION(this << round);
+        m_round = round;
+        m_nRoundCompleted = 0;
+        m_nUpdates = 0;
+        m_decodeTime = Time(0);
+        m_broadcastEvent.Cancel();
+        m_broadcastReady.clear();
+        m_broadcastReceivers.clear();
+
+        for (auto &itr: m_socketList) {
+            if (!m_clientSessionManager->IsInRound(itr.first)) {
+                continue;
+            }
+            itr.second->m_bytesReceived = 0;
+            itr.second->m_bytesSent = 0;
+            itr.second->m_timeBeginReceivingModelFromClient = Time();
+            itr.second->m_timeEndReceivingModelFromClient = Time();
+            itr.second->m_timeBeginSendingModelFromClient = Simulator::Now();
+            itr.second->m_timeEndSendingModelFromClient = Time();
+            if (m_bBroadcast) {
+                PrepareDownlink(itr.first);
+                m_broadcastReady.push_back(itr.first);
+            } else {
+                StartSendingModel(itr.first);
+            }
+        }
+
+        if (!m_broadcastReady.empty()) {
+            StartBroadcast();
+        }
+    }
 
-        if (m_sendEvent.IsExpired()) {
-            SendModel(socket);
+    void Server::BeginDownlink(Ptr <Socket> socket) {
+        if (m_bBroadcast) {
+            PrepareDownlink(socket);
+            BroadcastReady(socket);
+        } else {
+            StartSendingModel(socket);
         }
     }
 
     void Server::StartSendingModel(Ptr <Socket> socket) {
         auto itr = m_socketList.find(socket);
-        itr->second->m_bytesModelToReceive = m_bytesModel;
-        itr->second->m_bytesModelToSend = m_bytesModel;
+        // The client may have been dropped while the update was aggregated
+        if (itr == m_socketList.end()) {
+            return;
+        }
+        PrepareDownlink(socket);
+        itr->second->m_transfer.Start(m_bytesModel);
+    }
+
+    void Server::PrepareDownlink(Ptr <Socket> socket) {
+        auto itr = m_socketList.find(socket);
+        int id = m_clientSessionManager->ResolveToIdFromServer(socket);
+        uint32_t bytesUpdate = id >= 0 ? m_clientSessionManager->GetUpdateBytes(id) : 0;
+        itr->second->m_bytesUpdate = bytesUpdate ? bytesUpdate : m_bytesModel;
+        itr->second->m_bytesModelToReceive = itr->second->m_bytesUpdate;
+        itr->second->m_modelVersion = m_modelVersion;
         if (m_clientSessionManager->GetRound(socket) == 0)
             itr->second->m_timeBeginSendingModelFromClient;
         else
             itr->second->m_timeBeginSendingModelFromClient = Simulator::Now();
-        SendModel(socket);
-    }
 
-    void Server::SendModel(Ptr <Socket> socket) {
+        itr->second->m_timeout.Cancel();
+        if (m_roundTimeout.IsStrictlyPositive()) {
+            itr->second->m_timeout = Simulator::Schedule(m_roundTimeout, &Server::UploadFailed, this, socket,
+                                                         FLSimProvider::AsyncMessage::Status::TIMEOUT);
+        }
+    }
 
-        //Check if send buffer has available space
-        //If not, wait for data ready callback
-        auto available = socket->GetTxAvailable();
-        if (available == 0) {
-            socket->SetSendCallback(MakeCallback(&Server::ServerHandleSend, this));
+    void Server::BroadcastReady(Ptr <Socket> socket) {
+        if (m_broadcaster.IsActive()) {
+            // Late client, it gets the whole model with the next pass
+            Ipv4Address address = InetSocketAddress::ConvertFrom(m_socketList[socket]->m_address).GetIpv4();
+            m_broadcastReceivers[address] = socket;
+            m_broadcaster.AddReceiver(address);
             return;
         }
 
-        auto itr = m_socketList.find(socket);
-
-        if (itr == m_socketList.end() || itr->second->m_bytesModelToSend == 0) {
-            return;
+        m_broadcastReady.push_back(socket);
+        if ((int) m_broadcastReady.size() >= m_clientSessionManager->GetNumInRound()) {
+            StartBroadcast();
+        } else if (!m_broadcastEvent.IsRunning()) {
+            m_broadcastEvent = Simulator::Schedule(m_broadcastHoldoff, &Server::StartBroadcast, this);
         }
+    }
 
-        auto bytes = std::min(std::min(
-                itr->second->m_bytesModelToSend, available), m_packetSize);
+    void Server::StartBroadcast() {
+        m_broadcastEvent.Cancel();
 
-        auto bytesSent = socket->Send(Create<Packet>(bytes));
+        std::vector<Ipv4Address> receivers;
+        for (auto &socket: m_broadcastReady) {
+            auto itr = m_socketList.find(socket);
+            // Dropped while waiting for the others
+            if (itr == m_socketList.end()) {
+                continue;
+            }
+            Ipv4Address address = InetSocketAddress::ConvertFrom(itr->second->m_address).GetIpv4();
+            m_broadcastReceivers[address] = socket;
+            receivers.push_back(address);
+        }
+        m_broadcastReady.clear();
+        m_broadcaster.Start(m_round, m_bytesModel, receivers);
+    }
 
-        if (bytesSent == -1) {
+    void Server::BroadcastDelivered(Ipv4Address address) {
+        auto receiver = m_broadcastReceivers.find(address);
+        if (receiver == m_broadcastReceivers.end()) {
+            return;
+        }
+        auto itr = m_socketList.find(receiver->second);
+        if (itr == m_socketList.end()) {
             return;
         }
 
-        itr->second->m_bytesSent += bytesSent;
-        itr->second->m_bytesModelToSend -= bytesSent;
+        itr->second->m_bytesSent += m_bytesModel;
+        itr->second->m_timeEndSendingModelFromClient = Simulator::Now();
+    }
 
-        if (itr->second->m_bytesModelToSend) {
-            Time nextTime(Seconds((bytes * 8) /
-                                  static_cast<double>(m_dataRate.GetBitRate())));
+    void Server::ModelSent(Ptr <Socket> socket, uint32_t bytes) {
+        auto itr = m_socketList.find(socket);
+        if (itr == m_socketList.end()) {
+            return;
+        }
 
-            m_sendEvent = Simulator::Schedule(nextTime,
-                                              &Server::SendModel, this, socket);
+        itr->second->m_bytesSent += bytes;
+        if (itr->second->m_transfer.GetRemaining() == 0) {
+            itr->second->m_timeEndSendingModelFromClient = Simulator::Now();
         }
-        else
-          {
-            itr->second->m_timeEndSendingModelFromClient=Simulator::Now();
-          }
     }
 
 } // Namespace ns3
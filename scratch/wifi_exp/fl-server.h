@@ -31,8 +31,12 @@
 #include <unordered_map>
 #include <map>
 #include <memory>
+#include <chrono>
 #include "fl-sim-interface.h"
 #include "fl-energy.h"
+#include "fl-round-record.h"
+#include "fl-model-transfer.h"
+#include "fl-model-broadcast.h"
 
 
 
@@ -54,7 +58,8 @@ namespace ns3 {
          */
         class ClientSessionData {
         public:
-            ClientSessionData() : m_bytesReceived(0), m_bytesSent(0), m_bytesModelToSend(0), m_bytesModelToReceive(0) {
+            ClientSessionData() : m_bytesReceived(0), m_bytesSent(0), m_bytesModelToReceive(0), m_bytesUpdate(0),
+                                  m_modelVersion(0) {
 
             }
 
@@ -64,13 +69,30 @@ namespace ns3 {
             ns3::Time m_timeEndSendingModelFromClient;        //!<Set time when last message is sent to client
             uint32_t m_bytesReceived;                         //!<Total number of bytes received
             uint32_t m_bytesSent;                             //!<Total number of bytes sent
-            uint32_t m_bytesModelToSend;                      //!<Remaining number of bytes to send
             uint32_t m_bytesModelToReceive;                   //!<Remaining number of bytes to receive
+            uint32_t m_bytesUpdate;                           //!<Size of the encoded update expected this cycle
+            uint32_t m_modelVersion;                          //!<Async: version of the model sent this cycle
             ns3::Address m_address;                           //!<Address of the connected client
+            ModelTransfer m_transfer;                         //!<Sends the model to the client
+            EventId m_timeout;                                //!<Round timeout of the current cycle
 
         };
 
 
+        /**
+         * \brief Hash of a socket pointer, used to index the accepted sockets
+         */
+        struct SocketHash {
+            size_t operator()(const Ptr<Socket> &socket) const {
+                return std::hash<Socket *>()(PeekPointer(socket));
+            }
+        };
+
+        /**
+         * \brief Accepted sockets and their client session
+         */
+        typedef std::unordered_map<Ptr<Socket>, std::shared_ptr<ClientSessionData>, SocketHash> SocketList;
+
         /**
          * \brief Get the type ID.
          * \return the object TypeId
@@ -84,21 +106,57 @@ namespace ns3 {
          * \brief Gets a list of all connected sockets and their client session
          * \return List of pointers to accepted sockets
          */
-        std::map <Ptr<Socket>, std::shared_ptr<ClientSessionData>> GetAcceptedSockets(void) const;
+        const SocketList &GetAcceptedSockets(void) const;
 
         /**
          * \brief Sets the session manager and flsim provider
          * \param pSessionManager Session Manager for this experiment
          * \param fl_sim_provider Flsim provider for this experiment
+         * \param log             Writer of the per upload records
+         * \param round           Round
          */
          //TODO: move to cc file
-        void SetClientSessionManager(ClientSessionManager *pSessionManager, FLSimProvider *fl_sim_provider, FILE *fp, int round) {
+        void SetClientSessionManager(ClientSessionManager *pSessionManager, FLSimProvider *fl_sim_provider,
+                                     RoundRecordWriter *log, int round) {
             m_clientSessionManager = pSessionManager;
             m_fLSimProvider = fl_sim_provider;
-            m_fp=fp;
+            m_log=log;
             m_round=round;
         }
 
+        /**
+         * \brief Re-arms the per-round state of every accepted socket whose client
+         *        is in round and starts sending it the model.
+         *        Used by the persistent network, where connections outlive the round.
+         * \param round Round number used for logging
+         */
+        void StartRound(int round);
+
+        /**
+         * \brief Hands the end of a sync round, once aggregated, to a callback instead of
+         *        leaving the simulation running; the server then counts the uploads of its
+         *        in-round clients like a persistent one.
+         *        Used by the aggregators of the hierarchical topology.
+         * \param roundEnd Called once every in-round client uploaded or dropped out
+         */
+        void SetRoundEndCallback(Callback<void> roundEnd);
+
+        /**
+         * \brief Starts the downlink of the clients held by the HoldModel attribute, and of the
+         *        clients connecting from now on
+         */
+        void ReleaseModel();
+
+        /**
+         * \brief Gets the time the server spends aggregating updates
+         * \param overhead  Fixed cost of an aggregation
+         * \param rate      Rate at which update bytes are aggregated, 0 for free
+         * \param nUpdates  Number of updates aggregated
+         * \param bytes     Size of one update
+         * \return          overhead + nUpdates * bytes / rate
+         */
+        static Time GetAggregationTime(Time overhead, DataRate rate, uint32_t nUpdates, uint32_t bytes);
+
     protected:
         virtual void DoDispose(void);
 
@@ -115,17 +173,43 @@ namespace ns3 {
         void ReceivedDataCallback(Ptr <Socket> socket);
 
         /**
-         * \brief Sends a packet from server to client, continues
-         *        to send packets until there are no remaining bytes to be sent.
-         * \param socket Connected client socket in which to send bytes.
+         * \brief Called by the model transfer after every write to the client
+         * \param socket Connected client socket
+         * \param bytes  Number of bytes written
          */
-        void SendModel(Ptr <Socket> socket);
+        void ModelSent(Ptr <Socket> socket, uint32_t bytes);
 
         /**
          * \brief Begins the process of sending the model to the client
          */
         void StartSendingModel(Ptr <Socket> socket);
 
+        /**
+         * \brief Starts the downlink of an in-round client, over its connection or the broadcast
+         */
+        void BeginDownlink(Ptr <Socket> socket);
+
+        /**
+         * \brief Arms the downlink state of a client: bytes to receive, timestamps and round timeout
+         */
+        void PrepareDownlink(Ptr <Socket> socket);
+
+        /**
+         * \brief Broadcast: counts a client ready for the model and starts once all in-round clients are
+         */
+        void BroadcastReady(Ptr <Socket> socket);
+
+        /**
+         * \brief Broadcast: sends the model to every client ready for it
+         */
+        void StartBroadcast();
+
+        /**
+         * \brief Called by the broadcaster when a client confirmed the whole model
+         * \param address Client address
+         */
+        void BroadcastDelivered(Ipv4Address address);
+
         /**
          * \brief
          * \param s
@@ -142,15 +226,6 @@ namespace ns3 {
          */
         void NewConnectionCreatedCallback(Ptr <Socket> socket, const Address &from);
 
-        /**
-         * \brief Callback used to schedule a send when TxAvailable becomes
-         *        positive
-         * \param sock       Socket that is ready to send
-         * \param available  TxAvailable
-         */
-         //TODO:rename to handlereadytosend like in client file
-        void ServerHandleSend(Ptr <Socket> sock, uint32_t available);
-
         /**
          * \brief Handle an connection close
          * \param socket the connected socket
@@ -163,6 +238,52 @@ namespace ns3 {
          */
         void HandlePeerError(Ptr <Socket> socket);
 
+        /**
+         * \brief Drop a client whose cycle did not complete, report it and close its connection
+         * \param socket the connected socket
+         * \param status why the cycle failed
+         */
+        void UploadFailed(Ptr <Socket> socket, FLSimProvider::AsyncMessage::Status status);
+
+        /**
+         * \brief Async: count the end of a client's cycle and stop once every client is done
+         * \param socket the connected socket
+         * \return True if the simulation stops
+         */
+        bool EndCycle(Ptr <Socket> socket);
+
+        /**
+         * \brief Async: stop the simulation, flushing the reports to flsim
+         */
+        void StopAsync();
+
+        /**
+         * \brief Async: an aggregation finished, the model moves to the next version
+         * \param socket Client waiting for the new model, null if none
+         */
+        void AsyncAggregated(Ptr <Socket> socket);
+
+        /**
+         * \brief Async: send a message to flsim, or queue it until AsyncReportBatch are pending
+         * \param message Message to send
+         */
+        void Report(const FLSimProvider::AsyncMessage &message);
+
+        /**
+         * \brief Async: send the queued messages to flsim
+         */
+        void FlushReports();
+
+        /**
+         * \brief Persistent sync: count a client of the round as done and stop once all are
+         */
+        void EndUpload();
+
+        /**
+         * \brief Calls the round end callback, scheduled once the round is aggregated
+         */
+        void NotifyRoundEnd();
+
         /**
          * \brief Packet received: assemble byte stream to extract SeqTsSizeHeader
          * \param p received packet
@@ -176,20 +297,55 @@ namespace ns3 {
 
 
         Ptr <Socket> m_socket;                                                    //!< Listening socket
-        std::map <Ptr<Socket>, std::shared_ptr<ClientSessionData>> m_socketList;  //!< the accepted sockets
+        SocketList m_socketList;                                                  //!< the accepted sockets
         ClientSessionManager *m_clientSessionManager;                             //!< Container that holds all client sessions
         Address m_local;                                                          //!< Local address to bind to
         uint64_t m_totalRx;                                                       //!< Total bytes received
         TypeId m_tid;                                                             //!< Protocol TypeId
         uint32_t m_packetSize;                                                    //!< Max packet size for server to client communication
-        ns3::EventId m_sendEvent; //!< Send event handle used to cancel a pending event
         uint32_t m_bytesModel;    //!< Size of model that will be sent between the client and server
         ns3::DataRate m_dataRate; //!< Rate which data is transmitted from server to client
+        bool m_bPacing;           //!< Pace the model transfer at m_dataRate
+        uint32_t m_pacingBurst;   //!< Token bucket depth of the pacing, 0 for the default
         bool m_bAsync;            //!< Flag that is used to configure server as sync or async
         FLSimProvider *m_fLSimProvider; //!< Communications interface with python simulator
         ns3::Time m_timeOffset;   //!< For async, offset between rounds
-        FILE *m_fp;               //!< File pointer for logging.
+        RoundRecordWriter *m_log; //!< Writer of the per upload records
         int m_round;              //!< Round
+        bool m_bPersistent;       //!< Keep connections across rounds, stop once all in-round clients uploaded
+        int m_nRoundCompleted;    //!< Number of in-round clients whose upload completed this round
+        ns3::Time m_roundTimeout; //!< Longest cycle before a client is dropped, 0 for none
+        ns3::Time m_aggregationOverhead;  //!< Fixed cost of aggregating the updates
+        ns3::DataRate m_aggregationRate;  //!< Rate at which update bytes are aggregated, 0 for free
+        int m_nUpdates;           //!< Number of updates received this round
+        ns3::Time m_decodeTime;   //!< Time decoding the updates received this round
+        bool m_bBroadcast;        //!< Send the model once over UDP broadcast instead of once per connection
+        ns3::Time m_broadcastHoldoff;     //!< Longest wait for the in-round clients to connect before broadcasting
+        ns3::Time m_repairTimeout;        //!< Wait for NACKs after each broadcast pass
+        uint32_t m_maxPasses;     //!< Broadcast passes before giving up on the clients left
+        ModelBroadcaster m_broadcaster;   //!< Sends the model to all clients at once
+        std::vector<Ptr <Socket> > m_broadcastReady;  //!< Clients waiting for the broadcast to start
+        std::unordered_map<Ipv4Address, Ptr <Socket>, Ipv4AddressHash> m_broadcastReceivers;  //!< Clients of the broadcast
+        EventId m_broadcastEvent; //!< Broadcast start once the hold off expires
+        Callback<void> m_roundEnd;        //!< End of a sync round, null to leave the simulation running
+        bool m_bHoldModel;        //!< Hold the downlink until ReleaseModel
+        std::vector<Ptr <Socket> > m_held;    //!< Clients waiting for ReleaseModel
+        ns3::Time m_timeBudget;   //!< Async: simulated time before stopping, 0 for none
+        ns3::Time m_wallBudget;   //!< Async: wall clock time before stopping, 0 for none
+        uint32_t m_maxUpdates;    //!< Async: updates aggregated before stopping, 0 for none
+        uint32_t m_maxCycles;     //!< Async: cycles of one client before stopping, 0 for none
+        bool m_bStopAllCycled;    //!< Async: stop once every client completed a cycle
+        uint32_t m_maxStaleness;  //!< Async: updates staler than this are discarded, 0 for no bound
+        uint32_t m_bufferSize;    //!< Async: updates aggregated together (FedBuff K)
+        uint32_t m_reportBatch;   //!< Async: messages sent to flsim per write
+        uint32_t m_modelVersion;  //!< Async: aggregations done so far
+        uint32_t m_nAggregated;   //!< Async: updates accepted so far
+        uint32_t m_nBuffered;     //!< Async: updates waiting for the next aggregation
+        ns3::Time m_bufferDecodeTime;     //!< Async: time decoding the buffered updates
+        std::vector<FLSimProvider::AsyncMessage> m_reports;  //!< Async: messages not sent to flsim yet
+        std::chrono::steady_clock::time_point m_wallStart;   //!< Async: wall clock time of the start
+        EventId m_budgetEvent;    //!< Async: stop at the end of the time budget
+        bool m_bStopped;          //!< Async: the simulation was stopped
 
     };
 
@@ -18,117 +18,290 @@
  * Author: Emily Ekaireb <eekaireb@ucsd.edu>
  */
 #include "fl-sim-interface.h"
+#include <errno.h>
+#include <stddef.h>
 
 namespace ns3 {
+    bool FLSimProvider::SetTransport(const std::string &type, const std::string &endpoint) {
+        m_transport = FLSimTransport::Create(type, endpoint);
+        return m_transport != nullptr;
+    }
+
     void FLSimProvider::waitForConnection() {
-        m_server_fd = socket(AF_INET, SOCK_STREAM, 0);
-        if (m_server_fd < 0) {
-            NS_LOG_UNCOND("Could not create a socket");
+        if (!m_transport) {
+            m_transport = FLSimTransport::Create("tcp", std::to_string(m_port));
+        }
+
+        if (!m_transport->Accept()) {
             exit(-1);
         }
-        int opt = 1;
-        setsockopt(m_server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT,
-                   &opt, sizeof(opt));
+    }
 
-        m_address.sin_family = AF_INET;
-        m_address.sin_addr.s_addr = INADDR_ANY;
-        m_address.sin_port = htons(m_port);
+    bool FLSimProvider::ReadFully(void *buf, size_t len) {
+        char *p = (char *) buf;
+        while (len) {
+            ssize_t n = m_transport->Read(p, len);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            p += n;
+            len -= n;
+        }
+        return true;
+    }
 
-        if (bind(m_server_fd, (struct sockaddr *) &m_address, sizeof(m_address)) == -1) {
-            NS_LOG_UNCOND("Could not bind to port");
+    bool FLSimProvider::WriteFully(struct iovec *iov, int iovcnt) {
+        while (iovcnt) {
+            ssize_t n = m_transport->Writev(iov, iovcnt);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                NS_LOG_UNCOND("Write to flsim failed: " << strerror(errno));
+                return false;
+            }
+            // Skip what was written, resume inside a partially written buffer
+            while (iovcnt && (size_t) n >= iov->iov_len) {
+                n -= iov->iov_len;
+                iov++;
+                iovcnt--;
+            }
+            if (iovcnt) {
+                iov->iov_base = (char *) iov->iov_base + n;
+                iov->iov_len -= n;
+            }
         }
-        listen(m_server_fd, 3);
+        return true;
+    }
 
-        int addrlen = sizeof(m_address);
-        m_new_socket = accept(m_server_fd, (struct sockaddr *) &m_address,
-                            (socklen_t * ) & addrlen);
+    bool FLSimProvider::SendCommand(COMMAND::Type type, uint32_t nItems, const void *payload, size_t length) {
+        FRAME f;
+        f.command.command = static_cast<COMMAND::Type>(static_cast<uint32_t>(type) |
+                                                       (m_version << COMMAND::VERSION_SHIFT));
+        f.command.nItems = nItems;
+        f.length = length;
 
-        if (m_new_socket < 0) {
-            exit(-1);
+        struct iovec iov[2];
+        iov[0].iov_base = &f;
+        iov[0].iov_len = (m_version == COMMAND::VERSION_LEGACY) ? sizeof(COMMAND) : sizeof(FRAME);
+        iov[1].iov_base = const_cast<void *>(payload);
+        iov[1].iov_len = length;
+
+        if (!WriteFully(iov, length ? 2 : 1)) {
+            // The peer may have part of the frame, the stream cannot be resynchronized: drop it, and
+            // the rounds left of the batch, so the next recv returns EXIT
+            NS_LOG_UNCOND("Connection to flsim lost");
+            m_transport->Close();
+            m_pendingRounds.clear();
+            m_pendingRatios.clear();
+            return false;
         }
+        return true;
     }
 
     FLSimProvider::COMMAND::Type FLSimProvider::recv(std::map<int, std::shared_ptr<ClientSession> > &packetsReceived) {
+        if (!m_pendingRounds.empty()) {
+            NextPendingRound(packetsReceived);
+            return COMMAND::Type::RUN_SIMULATION;
+        }
+
         COMMAND c;
-        int len = read(m_new_socket, (char *) &c, sizeof(c));
+        if (!ReadFully(&c, sizeof(c))) {
+            NS_LOG_UNCOND("Socket closed by Python");
+            m_transport->Close();
+            return COMMAND::Type::EXIT;
+        }
+
+        m_version = static_cast<uint32_t>(c.command) >> COMMAND::VERSION_SHIFT;
+        c.command = static_cast<COMMAND::Type>(static_cast<uint32_t>(c.command) & COMMAND::TYPE_MASK);
 
-        if (len != sizeof(COMMAND)) {
-            if (len != 0) {
-                NS_LOG_UNCOND("Invalid Command: Len(" << len << ")!=(" << sizeof(COMMAND) << ")");
-            } else {
+        uint32_t length = 0;
+        if (m_version > COMMAND::VERSION_STALENESS) {
+            NS_LOG_UNCOND("Unsupported protocol version " << m_version);
+            m_transport->Close();
+            return COMMAND::Type::EXIT;
+        } else if (m_version >= COMMAND::VERSION_FRAMED) {
+            if (!ReadFully(&length, sizeof(length))) {
                 NS_LOG_UNCOND("Socket closed by Python");
+                m_transport->Close();
+                return COMMAND::Type::EXIT;
             }
-            close(m_new_socket);
-            return COMMAND::Type::EXIT;
         }
 
         if (c.command == COMMAND::Type::EXIT) {
             NS_LOG_UNCOND("Exit Called");
-            close(m_new_socket);
+            m_transport->Close();
             return COMMAND::Type::EXIT;
-        } else if (c.command != COMMAND::Type::RUN_SIMULATION) {
+        } else if (c.command != COMMAND::Type::RUN_SIMULATION &&
+                   c.command != COMMAND::Type::RUN_SIMULATION_BATCH) {
             NS_LOG_UNCOND("Invalid command");
-            close(m_new_socket);
+            m_transport->Close();
             return COMMAND::Type::EXIT;
         } else if (packetsReceived.size() != c.nItems) {
             NS_LOG_UNCOND("Invalid number of clients");
-            close(m_new_socket);
+            m_transport->Close();
             return COMMAND::Type::EXIT;
         }
 
+        uint32_t nRounds = 1;
+        if (m_version == COMMAND::VERSION_LEGACY) {
+            if (c.command == COMMAND::Type::RUN_SIMULATION_BATCH &&
+                (!ReadFully(&nRounds, sizeof(nRounds)) || nRounds == 0 ||
+                 nRounds > COMMAND::MAX_ROUNDS)) {
+                NS_LOG_UNCOND("Invalid number of rounds");
+                m_transport->Close();
+                return COMMAND::Type::EXIT;
+            }
 
-        int i = 0;
-        for (auto it = packetsReceived.begin(); it != packetsReceived.end(); it++, i++) {
-            uint32_t temp;
+            // All flags of all rounds in one read
+            m_buffer.resize((size_t) nRounds * c.nItems * sizeof(uint32_t));
+            if (!ReadFully(m_buffer.data(), m_buffer.size())) {
+                NS_LOG_UNCOND("Invalid valid length received");
+                m_transport->Close();
+                return COMMAND::Type::EXIT;
+            }
 
-            if (sizeof(temp) != read(m_new_socket, (char *) &temp, sizeof(temp))) {
+            const uint32_t *flags = (const uint32_t *) m_buffer.data();
+            for (uint32_t round = 0; round < nRounds; round++, flags += c.nItems) {
+                m_pendingRounds.emplace_back(flags, flags + c.nItems);
+                m_pendingRatios.emplace_back();
+            }
+        } else {
+            if (length > COMMAND::MAX_FRAME_LENGTH) {
+                NS_LOG_UNCOND("Invalid frame length " << length);
+                m_transport->Close();
+                return COMMAND::Type::EXIT;
+            }
+            m_buffer.resize(length);
+            if (!ReadFully(m_buffer.data(), m_buffer.size())) {
                 NS_LOG_UNCOND("Invalid valid length received");
+                m_transport->Close();
+                return COMMAND::Type::EXIT;
+            }
+
+            const uint8_t *bitmap = m_buffer.data();
+            size_t bitmapLength = (c.nItems + 7) / 8;
+            if (c.command == COMMAND::Type::RUN_SIMULATION_BATCH) {
+                if (length < sizeof(nRounds)) {
+                    NS_LOG_UNCOND("Invalid number of rounds");
+                    m_transport->Close();
+                    return COMMAND::Type::EXIT;
+                }
+                memcpy(&nRounds, bitmap, sizeof(nRounds));
+                bitmap += sizeof(nRounds);
+                length -= sizeof(nRounds);
+                // Without clients the length does not bound the number of rounds
+                if (nRounds == 0 || nRounds > COMMAND::MAX_ROUNDS) {
+                    NS_LOG_UNCOND("Invalid number of rounds");
+                    m_transport->Close();
+                    return COMMAND::Type::EXIT;
+                }
+            }
+            size_t ratiosLength = (m_version >= COMMAND::VERSION_CODEC) ? c.nItems * sizeof(float) : 0;
+            if (nRounds == 0 || length != nRounds * (bitmapLength + ratiosLength)) {
+                NS_LOG_UNCOND("Invalid frame length " << length);
+                m_transport->Close();
                 return COMMAND::Type::EXIT;
             }
 
-            it->second->SetInRound((temp == 0) ? false : true);
+            for (uint32_t round = 0; round < nRounds; round++, bitmap += bitmapLength + ratiosLength) {
+                std::vector<uint32_t> inRound(c.nItems);
+                for (uint32_t i = 0; i < c.nItems; i++) {
+                    inRound[i] = (bitmap[i >> 3] >> (i & 7)) & 1;
+                }
+                m_pendingRounds.push_back(std::move(inRound));
 
+                std::vector<float> ratios(ratiosLength / sizeof(float));
+                if (ratiosLength) {
+                    memcpy(ratios.data(), bitmap + bitmapLength, ratiosLength);
+                }
+                m_pendingRatios.push_back(std::move(ratios));
+            }
+        }
 
+        if (c.command == COMMAND::Type::RUN_SIMULATION_BATCH) {
+            NS_LOG_UNCOND("Batch of " << nRounds << " rounds received");
         }
+        NextPendingRound(packetsReceived);
+        return COMMAND::Type::RUN_SIMULATION;
+    }
 
+    uint32_t FLSimProvider::GetPendingRounds() const {
+        return m_pendingRounds.size();
+    }
 
-        return c.command;
+    void FLSimProvider::NextPendingRound(std::map<int, std::shared_ptr<ClientSession> > &packetsReceived) {
+        auto &inRound = m_pendingRounds.front();
+        auto &ratios = m_pendingRatios.front();
+        int i = 0;
+        for (auto it = packetsReceived.begin(); it != packetsReceived.end(); it++, i++) {
+            it->second->SetInRound((inRound[i] == 0) ? false : true);
+            it->second->SetCompressionRatio(ratios.empty() ? 0 : ratios[i]);
+        }
+        m_pendingRounds.pop_front();
+        m_pendingRatios.pop_front();
     }
 
     void FLSimProvider::Close() {
-        close(m_new_socket);
+        m_transport->Close();
+    }
+
+    bool FLSimProvider::send(AsyncMessage *pMessage) {
+        // Versions before VERSION_CHURN stop the message after throughput, before
+        // VERSION_STALENESS after bytesReceived
+        size_t size = (m_version >= COMMAND::VERSION_STALENESS) ? sizeof(AsyncMessage) :
+                      (m_version >= COMMAND::VERSION_CHURN) ? offsetof(AsyncMessage, staleness)
+                                                            : offsetof(AsyncMessage, status);
+        return SendCommand(COMMAND::Type::RESPONSE, 1, pMessage, size);
+    }
+
+    bool FLSimProvider::send(const std::vector<AsyncMessage> &messages) {
+        if (!ReportsStaleness()) {
+            for (auto message: messages) {
+                if (!send(&message)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        return SendCommand(COMMAND::Type::RESPONSE, messages.size(), messages.data(),
+                    messages.size() * sizeof(AsyncMessage));
     }
 
-    void FLSimProvider::send(AsyncMessage *pMessage) {
-        COMMAND r;
-        r.command = COMMAND::Type::RESPONSE;
-        r.nItems = 1;
-        write(m_new_socket, (char *) &r, sizeof(r));
-        write(m_new_socket, pMessage, sizeof(AsyncMessage));
+    bool FLSimProvider::ReportsFailures() const {
+        return m_version >= COMMAND::VERSION_CHURN;
     }
 
-    void FLSimProvider::end() {
-        COMMAND r;
-        r.command = COMMAND::Type::ENDSIM;
-        r.nItems = 0;
-        write(m_new_socket, (char *) &r, sizeof(r));
+    bool FLSimProvider::ReportsStaleness() const {
+        return m_version >= COMMAND::VERSION_STALENESS;
     }
 
+    bool FLSimProvider::end() {
+        return SendCommand(COMMAND::Type::ENDSIM, 0, nullptr, 0);
+    }
 
-    void FLSimProvider::send(std::map<int, Message> &roundTime) {
-        //NS_LOG_FUNCTION(this);
 
-        COMMAND r;
-        r.command = COMMAND::Type::RESPONSE;
-        r.nItems = roundTime.size();
-        write(m_new_socket, (char *) &r, sizeof(r));
+    bool FLSimProvider::send(std::map<int, Message> &roundTime) {
+        //NS_LOG_FUNCTION(this);
 
-        for (auto it = roundTime.begin(); it != roundTime.end(); it++) {
+        // Messages are packed contiguously so the whole response goes out in one writev,
+        // versions before VERSION_HEALTH stop each one after throughput
+        size_t size = (m_version >= COMMAND::VERSION_HEALTH) ? sizeof(Message) : offsetof(Message, temperature);
+        std::vector<uint8_t> messages(roundTime.size() * size);
+        uint8_t *p = messages.data();
+        for (auto it = roundTime.begin(); it != roundTime.end(); it++, p += size) {
             Message &temp = it->second;
             temp.id = it->first;
-            write(m_new_socket, (char *) &it->second, sizeof(Message));
+            memcpy(p, &temp, size);
         }
 
+        bool sent = SendCommand(COMMAND::Type::RESPONSE, roundTime.size(), messages.data(), messages.size());
+
         roundTime.clear();
+        return sent;
     }
-}
\ No newline at end of file
+}
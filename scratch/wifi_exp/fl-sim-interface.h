@@ -36,14 +36,15 @@
 #include "ns3/flow-monitor-module.h"
 
 #include "fl-client-session.h"
-#include <unistd.h>
+#include "fl-sim-transport.h"
 #include <stdio.h>
-#include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdlib.h>
-#include <netinet/in.h>
 #include <string.h>
 #include <map>
 #include <memory>
+#include <deque>
+#include <vector>
 
 namespace ns3 {
 
@@ -61,41 +62,117 @@ namespace ns3 {
             uint64_t id;
             double roundTime;
             double throughput;
+            double temperature;   //!< Device temperature at the end of the round (C), 0 without a health stack
+            double reliability;   //!< Device reliability at the end of the round, 0 without a health stack
         };
 
         /**
          * \brief AsyncMessage used to communicate the result of a clients round in a async experiment.
          */
         struct AsyncMessage {
+            /**
+             * \brief Outcome of the client's upload
+             */
+            enum class Status : uint32_t {
+                COMPLETE     = 0,   //!< The whole model was received
+                DISCONNECTED = 1,   //!< The client went offline during the cycle
+                TIMEOUT      = 2,   //!< The cycle exceeded the round timeout
+                STALE        = 3,   //!< Received, but discarded for exceeding the staleness bound
+            };
+
             uint64_t id;
             double startTime;
             double endTime;
             double throughput;
+            Status status;            //!< Outcome of the upload
+            uint32_t bytesReceived;   //!< Bytes of the model received in this cycle
+            uint32_t staleness;       //!< Aggregations between the model sent and this update
+            uint32_t modelVersion;    //!< Version of the model the client trained on
         };
 
 
         /**
          * \brief Command message used to communicate intent between
          * flsim and fl-experiment
+         *
+         * The upper 16 bits of command hold the protocol version, the lower 16 bits the Type.
+         *
+         * Version 0 (legacy): RUN_SIMULATION is followed by nItems uint32_t participation flags.
+         * RUN_SIMULATION_BATCH is followed by a uint32_t number of rounds and then
+         * nItems uint32_t participation flags per round; the rounds are run back to
+         * back and each round's response is sent as soon as the round finishes.
+         *
+         * Version 1 (framed): every COMMAND is followed by a uint32_t payload length in bytes
+         * and the payload. Participation vectors are packed bitmaps of (nItems + 7) / 8 bytes,
+         * client i at bit (i % 8) of byte (i / 8); RUN_SIMULATION_BATCH prefixes its bitmaps
+         * with a uint32_t number of rounds. Responses use the version of the last command received.
+         *
+         * Version 2 (health): framed like version 1, each Message of a RESPONSE also carries
+         * the temperature and reliability of the client. Earlier versions send id, roundTime
+         * and throughput only.
+         *
+         * Version 3 (churn): like version 2, each AsyncMessage also carries a status and the
+         * number of model bytes received, and failed uploads (disconnections, timeouts) are
+         * reported as AsyncMessages too. Earlier versions only receive completed uploads, as
+         * id, startTime, endTime and throughput.
+         *
+         * Version 4 (codec): like version 3, each participation bitmap is followed by nItems
+         * float32 compression ratios, one per client, the ratio of the first stage of the update
+         * codec for that round (0 for the ratio of the codec specification).
+         *
+         * Version 5 (staleness): like version 4, each AsyncMessage also carries the staleness of
+         * the update and the model version it was trained on, updates discarded for staleness are
+         * reported with the STALE status, and one RESPONSE may carry several AsyncMessages
+         * (nItems of them). Earlier versions receive one AsyncMessage per RESPONSE and no STALE.
          */
         struct COMMAND {
             enum class Type : uint32_t {
-                RESPONSE       = 0,
-                RUN_SIMULATION = 1,
-                EXIT           = 2,
-                ENDSIM         = 3,
+                RESPONSE             = 0,
+                RUN_SIMULATION       = 1,
+                EXIT                 = 2,
+                ENDSIM               = 3,
+                RUN_SIMULATION_BATCH = 4,
             };
 
+            static constexpr uint32_t VERSION_LEGACY = 0;  //!< One read/write per field, no length prefix
+            static constexpr uint32_t VERSION_FRAMED = 1;  //!< Length-prefixed frames, bitmap participation vectors
+            static constexpr uint32_t VERSION_HEALTH = 2;  //!< Framed, responses carry temperature and reliability
+            static constexpr uint32_t VERSION_CHURN = 3;   //!< Async messages carry a status, failures are reported
+            static constexpr uint32_t VERSION_CODEC = 4;   //!< Rounds carry a compression ratio per client
+            static constexpr uint32_t VERSION_STALENESS = 5;  //!< Async messages carry staleness, several per response
+            static constexpr uint32_t VERSION_SHIFT = 16;  //!< Position of the version in command
+            static constexpr uint32_t TYPE_MASK = 0xffff;  //!< Mask of the Type in command
+            static constexpr uint32_t MAX_ROUNDS = 1 << 16;  //!< Rounds accepted in one RUN_SIMULATION_BATCH
+            static constexpr uint32_t MAX_FRAME_LENGTH = 64 << 20;  //!< Payload bytes accepted in one frame
+
             Type command;
             uint32_t nItems;
         };
 
+        /**
+         * \brief Header of a version 1 frame
+         */
+        struct FRAME {
+            COMMAND command;
+            uint32_t length;   //!< Number of payload bytes following the header
+        };
+
         /**
          * \brief Constructor; listening port for the flsim
          *
          * \param port
          */
-        FLSimProvider(uint16_t port) : m_port(port) {}
+        FLSimProvider(uint16_t port) : m_port(port), m_version(COMMAND::VERSION_LEGACY) {}
+
+        /**
+         * \brief Select the transport used by waitForConnection, TCP on the
+         * constructor port if never called
+         *
+         * \param type      "tcp", "unix" or "shm"
+         * \param endpoint  Port for tcp, socket path for unix, segment name for shm
+         * \return False if the type is unknown
+         */
+        bool SetTransport(const std::string &type, const std::string &endpoint);
 
         /**
          * \brief Wait for flsim to connect.
@@ -104,30 +181,61 @@ namespace ns3 {
 
         /**
          * \brief Receive next experiment to run
+         * If rounds of a previous RUN_SIMULATION_BATCH are pending, the next one is
+         * applied without reading from the socket.
          *
          * \param clientSessionMap Map of client id to ClientSession
          * \return
          */
         COMMAND::Type recv(std::map<int, std::shared_ptr<ClientSession>> &clientSessionMap);
 
+        /**
+         * \brief Get number of batched rounds not run yet
+         * \return Number of pending rounds
+         */
+        uint32_t GetPendingRounds() const;
+
         /**
          * \brief Send the round times
          *
          * \param roundTimeMap
+         * \return False if the write failed and the connection was closed
          */
-        void send(std::map<int, Message> &roundTimeMap);
+        bool send(std::map<int, Message> &roundTimeMap);
 
         /**
          * \brief Send an AsyncMessage
          * Used at the end of each client round
          * \param pMessage Pointer to an AsyncMessage to send
+         * \return False if the write failed and the connection was closed
          */
-        void send(AsyncMessage *pMessage);
+        bool send(AsyncMessage *pMessage);
+
+        /**
+         * \brief Send several AsyncMessages in one RESPONSE
+         * Peers before VERSION_STALENESS get one RESPONSE per message.
+         * \param messages Messages to send
+         * \return False if the write failed and the connection was closed
+         */
+        bool send(const std::vector<AsyncMessage> &messages);
+
+        /**
+         * \brief Get if the peer takes several AsyncMessages per RESPONSE and the STALE status
+         * \return True if the peer speaks VERSION_STALENESS or later
+         */
+        bool ReportsStaleness() const;
+
+        /**
+         * \brief Get if failed uploads can be reported to flsim
+         * \return True if the peer speaks VERSION_CHURN or later
+         */
+        bool ReportsFailures() const;
 
         /**
          * \brief Send end message
+         * \return False if the write failed and the connection was closed
          */
-        void end();
+        bool end();
 
         /**
          * Close socket if open
@@ -136,10 +244,44 @@ namespace ns3 {
 
     private:
 
+        /**
+         * \brief Apply the next pending batched round to the client sessions
+         * \param clientSessionMap Map of client id to ClientSession
+         */
+        void NextPendingRound(std::map<int, std::shared_ptr<ClientSession>> &clientSessionMap);
+
+        /**
+         * \brief Read exactly len bytes, retrying on short reads
+         * \param buf  Destination buffer
+         * \param len  Number of bytes to read
+         * \return True on success, false on error or if the socket was closed
+         */
+        bool ReadFully(void *buf, size_t len);
+
+        /**
+         * \brief Write all buffers with as few writev calls as possible, retrying on short writes
+         * \param iov     Buffers to write, modified on short writes
+         * \param iovcnt  Number of buffers
+         * \return True on success
+         */
+        bool WriteFully(struct iovec *iov, int iovcnt);
+
+        /**
+         * \brief Send a COMMAND and its payload in one write, framed if the peer speaks version 1
+         * \param type     Command type
+         * \param nItems   Number of items
+         * \param payload  Payload bytes, may be null
+         * \param length   Number of payload bytes
+         * \return True on success, otherwise the connection is closed and the next recv returns EXIT
+         */
+        bool SendCommand(COMMAND::Type type, uint32_t nItems, const void *payload, size_t length);
+
+        std::deque<std::vector<uint32_t>> m_pendingRounds; //!< Participation flags of batched rounds not run yet
+        std::deque<std::vector<float>> m_pendingRatios;    //!< Compression ratios of m_pendingRounds, empty before VERSION_CODEC
         uint16_t m_port;              //!< Listening port number
-        int m_server_fd;              //!< Listening socket file descriptor
-        int m_new_socket;             //!< Session socket file descriptor
-        struct sockaddr_in m_address; //!< Address data structure used to configure TCP socket.
+        std::unique_ptr<FLSimTransport> m_transport; //!< Byte stream to flsim
+        uint32_t m_version;           //!< Protocol version of the last command received
+        std::vector<uint8_t> m_buffer; //!< Receive buffer for participation vectors
     };
 }
 #endif
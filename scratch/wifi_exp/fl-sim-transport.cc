@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+#include "fl-sim-transport.h"
+#include "ns3/log.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <algorithm>
+
+namespace ns3 {
+
+    std::unique_ptr<FLSimTransport> FLSimTransport::Create(const std::string &type, const std::string &endpoint) {
+        if (type == "tcp") {
+            char *end = nullptr;
+            errno = 0;
+            long port = strtol(endpoint.c_str(), &end, 10);
+            if (endpoint.empty() || *end != '\0' || errno != 0 || port <= 0 || port > 65535) {
+                return nullptr;
+            }
+            return std::unique_ptr<FLSimTransport>(new FLSimTcpTransport(port));
+        } else if (type == "unix") {
+            return std::unique_ptr<FLSimTransport>(new FLSimUnixTransport(endpoint));
+        } else if (type == "shm") {
+            return std::unique_ptr<FLSimTransport>(new FLSimShmTransport(endpoint));
+        }
+        return nullptr;
+    }
+
+    FLSimSocketTransport::~FLSimSocketTransport() {
+        Close();
+        if (m_server_fd >= 0) {
+            close(m_server_fd);
+        }
+    }
+
+    ssize_t FLSimSocketTransport::Read(void *buf, size_t len) {
+        return read(m_new_socket, buf, len);
+    }
+
+    ssize_t FLSimSocketTransport::Writev(const struct iovec *iov, int iovcnt) {
+        return writev(m_new_socket, iov, iovcnt);
+    }
+
+    void FLSimSocketTransport::Close() {
+        if (m_new_socket >= 0) {
+            close(m_new_socket);
+            m_new_socket = -1;
+        }
+    }
+
+    bool FLSimTcpTransport::Accept() {
+        m_server_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_server_fd < 0) {
+            NS_LOG_UNCOND("Could not create a socket");
+            return false;
+        }
+        int opt = 1;
+        setsockopt(m_server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT,
+                   &opt, sizeof(opt));
+
+        struct sockaddr_in address;
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = INADDR_ANY;
+        address.sin_port = htons(m_port);
+
+        if (bind(m_server_fd, (struct sockaddr *) &address, sizeof(address)) == -1) {
+            NS_LOG_UNCOND("Could not bind to port");
+        }
+        listen(m_server_fd, 3);
+
+        socklen_t addrlen = sizeof(address);
+        m_new_socket = accept(m_server_fd, (struct sockaddr *) &address, &addrlen);
+
+        return m_new_socket >= 0;
+    }
+
+    FLSimUnixTransport::~FLSimUnixTransport() {
+        if (m_server_fd >= 0) {
+            unlink(m_path.c_str());
+        }
+    }
+
+    bool FLSimUnixTransport::Accept() {
+        struct sockaddr_un address;
+        if (m_path.size() >= sizeof(address.sun_path)) {
+            NS_LOG_UNCOND("Socket path too long: " << m_path);
+            return false;
+        }
+
+        m_server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_server_fd < 0) {
+            NS_LOG_UNCOND("Could not create a socket");
+            return false;
+        }
+
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+
+        // Left behind by a simulator that did not exit cleanly
+        unlink(m_path.c_str());
+        if (bind(m_server_fd, (struct sockaddr *) &address, sizeof(address)) == -1) {
+            NS_LOG_UNCOND("Could not bind to " << m_path);
+            return false;
+        }
+        listen(m_server_fd, 3);
+
+        m_new_socket = accept(m_server_fd, nullptr, nullptr);
+
+        return m_new_socket >= 0;
+    }
+
+    FLSimShmTransport::FLSimShmTransport(const std::string &name) : m_name("/" + name), m_header(nullptr) {
+    }
+
+    FLSimShmTransport::~FLSimShmTransport() {
+        Close();
+        if (m_header) {
+            sem_destroy(&m_header->connected);
+            sem_destroy(&m_header->toSim.dataSem);
+            sem_destroy(&m_header->toSim.spaceSem);
+            sem_destroy(&m_header->fromSim.dataSem);
+            sem_destroy(&m_header->fromSim.spaceSem);
+            munmap(m_header, sizeof(ShmHeader));
+            shm_unlink(m_name.c_str());
+        }
+    }
+
+    bool FLSimShmTransport::Accept() {
+        // Left behind by a simulator that did not exit cleanly
+        shm_unlink(m_name.c_str());
+
+        int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            NS_LOG_UNCOND("Could not create shared memory " << m_name << ": " << strerror(errno));
+            return false;
+        }
+        if (ftruncate(fd, sizeof(ShmHeader)) == -1) {
+            NS_LOG_UNCOND("Could not size shared memory " << m_name << ": " << strerror(errno));
+            close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, sizeof(ShmHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            NS_LOG_UNCOND("Could not map shared memory " << m_name << ": " << strerror(errno));
+            return false;
+        }
+
+        m_header = static_cast<ShmHeader *>(p);
+        m_header->capacity = RING_CAPACITY;
+        sem_init(&m_header->connected, 1, 0);
+        for (Ring *ring: {&m_header->toSim, &m_header->fromSim}) {
+            sem_init(&ring->dataSem, 1, 0);
+            sem_init(&ring->spaceSem, 1, 0);
+            ring->head.store(0);
+            ring->tail.store(0);
+            ring->closed.store(0);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header->magic = MAGIC;
+
+        while (sem_wait(&m_header->connected) == -1) {
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ssize_t FLSimShmTransport::Read(void *buf, size_t len) {
+        Ring &ring = m_header->toSim;
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint64_t head;
+        while ((head = ring.head.load(std::memory_order_acquire)) == tail) {
+            if (ring.closed.load() || m_header->fromSim.closed.load()) {
+                return 0;
+            }
+            if (sem_wait(&ring.dataSem) == -1 && errno != EINTR) {
+                return -1;
+            }
+        }
+
+        size_t n = std::min<uint64_t>(len, head - tail);
+        size_t offset = tail % RING_CAPACITY;
+        size_t first = std::min(n, (size_t) RING_CAPACITY - offset);
+        memcpy(buf, ring.data + offset, first);
+        memcpy((char *) buf + first, ring.data, n - first);
+
+        ring.tail.store(tail + n, std::memory_order_release);
+        sem_post(&ring.spaceSem);
+        return n;
+    }
+
+    ssize_t FLSimShmTransport::Writev(const struct iovec *iov, int iovcnt) {
+        Ring &ring = m_header->fromSim;
+        uint64_t head = ring.head.load(std::memory_order_relaxed);
+        uint64_t tail;
+        while ((tail = ring.tail.load(std::memory_order_acquire)) + RING_CAPACITY == head) {
+            if (ring.closed.load() || m_header->toSim.closed.load()) {
+                errno = EPIPE;
+                return -1;
+            }
+            if (sem_wait(&ring.spaceSem) == -1 && errno != EINTR) {
+                return -1;
+            }
+        }
+
+        size_t space = RING_CAPACITY - (head - tail);
+        size_t written = 0;
+        for (int i = 0; i < iovcnt && space; i++) {
+            const char *src = (const char *) iov[i].iov_base;
+            size_t n = std::min(iov[i].iov_len, space);
+            size_t offset = (head + written) % RING_CAPACITY;
+            size_t first = std::min(n, (size_t) RING_CAPACITY - offset);
+            memcpy(ring.data + offset, src, first);
+            memcpy(ring.data, src + first, n - first);
+            written += n;
+            space -= n;
+        }
+
+        ring.head.store(head + written, std::memory_order_release);
+        sem_post(&ring.dataSem);
+        return written;
+    }
+
+    void FLSimShmTransport::Close() {
+        if (!m_header || m_header->fromSim.closed.load()) {
+            return;
+        }
+        m_header->fromSim.closed.store(1);
+        // Wake up flsim if it is blocked on either ring
+        sem_post(&m_header->fromSim.dataSem);
+        sem_post(&m_header->toSim.spaceSem);
+    }
+}
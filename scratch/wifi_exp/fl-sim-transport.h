@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_SIM_TRANSPORT_H
+#define FL_SIM_TRANSPORT_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <semaphore.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-sim-interface
+    * \brief Byte stream between flsim and the simulator, used by FLSimProvider
+    *
+    * Read and Writev behave like read(2)/writev(2): they may transfer fewer bytes
+    * than requested and return -1 with errno set on error.
+    */
+    class FLSimTransport {
+    public:
+        virtual ~FLSimTransport() {}
+
+        /**
+         * \brief Wait for flsim to connect
+         * \return True once connected
+         */
+        virtual bool Accept() = 0;
+
+        /**
+         * \brief Read up to len bytes, blocking until at least one is available
+         * \param buf  Destination buffer
+         * \param len  Maximum number of bytes to read
+         * \return Number of bytes read, 0 if the peer closed, -1 on error
+         */
+        virtual ssize_t Read(void *buf, size_t len) = 0;
+
+        /**
+         * \brief Write a gather list, blocking until at least one byte is written
+         * \param iov     Buffers to write
+         * \param iovcnt  Number of buffers
+         * \return Number of bytes written, -1 on error
+         */
+        virtual ssize_t Writev(const struct iovec *iov, int iovcnt) = 0;
+
+        /**
+         * \brief Close the connection
+         */
+        virtual void Close() = 0;
+
+        /**
+         * \brief Create a transport
+         * \param type      "tcp", "unix" or "shm"
+         * \param endpoint  Port for tcp, socket path for unix, segment name for shm
+         * \return The transport, null if the type is unknown
+         */
+        static std::unique_ptr<FLSimTransport> Create(const std::string &type, const std::string &endpoint);
+    };
+
+    /**
+    * \ingroup fl-sim-interface
+    * \brief Transport over a connected stream socket
+    */
+    class FLSimSocketTransport : public FLSimTransport {
+    public:
+        FLSimSocketTransport() : m_server_fd(-1), m_new_socket(-1) {}
+        ~FLSimSocketTransport();
+
+        virtual ssize_t Read(void *buf, size_t len);
+        virtual ssize_t Writev(const struct iovec *iov, int iovcnt);
+        virtual void Close();
+
+    protected:
+        int m_server_fd;              //!< Listening socket file descriptor
+        int m_new_socket;             //!< Session socket file descriptor
+    };
+
+    /**
+    * \ingroup fl-sim-interface
+    * \brief Transport over TCP, flsim connects to the listening port
+    */
+    class FLSimTcpTransport : public FLSimSocketTransport {
+    public:
+        /**
+         * \param port Listening port
+         */
+        FLSimTcpTransport(uint16_t port) : m_port(port) {}
+
+        virtual bool Accept();
+
+    private:
+        uint16_t m_port;              //!< Listening port number
+    };
+
+    /**
+    * \ingroup fl-sim-interface
+    * \brief Transport over a Unix domain stream socket
+    */
+    class FLSimUnixTransport : public FLSimSocketTransport {
+    public:
+        /**
+         * \param path Path of the listening socket
+         */
+        FLSimUnixTransport(const std::string &path) : m_path(path) {}
+        ~FLSimUnixTransport();
+
+        virtual bool Accept();
+
+    private:
+        std::string m_path;           //!< Path of the listening socket
+    };
+
+    /**
+    * \ingroup fl-sim-interface
+    * \brief Transport over a POSIX shared-memory segment holding one ring buffer per direction
+    *
+    * The simulator creates the segment "/<name>" laid out as a ShmHeader, flsim maps it,
+    * posts ShmHeader::connected and then talks through the rings. Each ring is single
+    * producer / single consumer: head and tail only grow, the writer posts dataSem after
+    * advancing head and the reader posts spaceSem after advancing tail.
+    */
+    class FLSimShmTransport : public FLSimTransport {
+    public:
+        static constexpr uint32_t MAGIC = 0x464c534d;           //!< "FLSM", set once the segment is initialized
+        static constexpr uint32_t RING_CAPACITY = 1 << 20;      //!< Bytes per ring
+
+        /**
+         * \brief One direction of the shared-memory stream
+         */
+        struct Ring {
+            sem_t dataSem;                   //!< Posted by the writer after advancing head
+            sem_t spaceSem;                  //!< Posted by the reader after advancing tail
+            std::atomic<uint64_t> head;      //!< Total bytes written
+            std::atomic<uint64_t> tail;      //!< Total bytes read
+            std::atomic<uint32_t> closed;    //!< Set by either side on close
+            char data[RING_CAPACITY];        //!< Ring storage
+        };
+
+        /**
+         * \brief Layout of the shared-memory segment
+         */
+        struct ShmHeader {
+            uint32_t magic;                  //!< MAGIC once initialized
+            uint32_t capacity;               //!< RING_CAPACITY
+            sem_t connected;                 //!< Posted by flsim once it mapped the segment
+            Ring toSim;                      //!< flsim -> simulator
+            Ring fromSim;                    //!< simulator -> flsim
+        };
+
+        /**
+         * \param name Name of the shared-memory segment, without the leading '/'
+         */
+        FLSimShmTransport(const std::string &name);
+        ~FLSimShmTransport();
+
+        virtual bool Accept();
+        virtual ssize_t Read(void *buf, size_t len);
+        virtual ssize_t Writev(const struct iovec *iov, int iovcnt);
+        virtual void Close();
+
+    private:
+        std::string m_name;           //!< Segment name, with the leading '/'
+        ShmHeader *m_header;          //!< Mapped segment
+    };
+}
+#endif
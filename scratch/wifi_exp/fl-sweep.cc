@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-sweep.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+namespace ns3 {
+
+    SweepDriver::SweepDriver(uint32_t nWorkers, uint64_t maxWorkerMemory) :
+            m_nWorkers(nWorkers),
+            m_maxWorkerMemory(maxWorkerMemory) {
+        if (m_nWorkers == 0) {
+            long cores = sysconf(_SC_NPROCESSORS_ONLN);
+            m_nWorkers = (cores > 0) ? cores : 1;
+        }
+    }
+
+    std::vector<std::string> SweepDriver::ReadConfigs(const std::string &fileName) {
+        std::vector<std::string> configs;
+        std::ifstream in(fileName);
+        std::string line;
+        while (std::getline(in, line)) {
+            auto begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos || line[begin] == '#') {
+                continue;
+            }
+            configs.push_back(line.substr(begin));
+        }
+        return configs;
+    }
+
+    std::vector<std::string> SweepDriver::ToArgs(const std::string &program, const std::string &config) {
+        std::vector<std::string> args;
+        args.push_back(program);
+        std::istringstream tokens(config);
+        std::string token;
+        while (tokens >> token) {
+            if (token.compare(0, 2, "--") != 0) {
+                token = "--" + token;
+            }
+            args.push_back(token);
+        }
+        return args;
+    }
+
+    int SweepDriver::Run(const std::vector<std::string> &configs, Worker worker, FILE *out) {
+        struct Job {
+            size_t index;
+            FILE *fp;
+        };
+
+        std::map<pid_t, Job> running;
+        size_t next = 0;
+        int failures = 0;
+
+        NS_LOG_UNCOND("Sweep of " << configs.size() << " configurations on " << m_nWorkers << " workers");
+
+        while (next < configs.size() || !running.empty()) {
+            while (running.size() < m_nWorkers && next < configs.size()) {
+                FILE *fp = tmpfile();
+                if (!fp) {
+                    NS_LOG_UNCOND("Could not create temporary file for configuration " << next);
+                    failures++;
+                    next++;
+                    continue;
+                }
+
+                // Nothing buffered may be inherited, or it would be written twice
+                fflush(out);
+                std::cout.flush();
+                std::clog.flush();
+
+                pid_t pid = fork();
+                if (pid == 0) {
+                    if (m_maxWorkerMemory) {
+                        struct rlimit limit;
+                        limit.rlim_cur = m_maxWorkerMemory;
+                        limit.rlim_max = m_maxWorkerMemory;
+                        setrlimit(RLIMIT_AS, &limit);
+                    }
+                    int rc = worker(configs[next], fp);
+                    fflush(fp);
+                    std::cout.flush();
+                    std::clog.flush();
+                    _exit(rc);
+                } else if (pid < 0) {
+                    NS_LOG_UNCOND("Could not fork worker for configuration " << next);
+                    fclose(fp);
+                    failures++;
+                    next++;
+                    continue;
+                }
+
+                running[pid] = Job{next, fp};
+                next++;
+            }
+
+            int status;
+            pid_t pid = waitpid(-1, &status, 0);
+            if (pid < 0) {
+                break;
+            }
+            auto itr = running.find(pid);
+            if (itr == running.end()) {
+                continue;
+            }
+
+            Job job = itr->second;
+            running.erase(itr);
+
+            bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            if (!ok) {
+                NS_LOG_UNCOND("Configuration " << job.index << " failed: " << configs[job.index]);
+                failures++;
+            }
+
+            // Partial results of a failed worker are kept, they are still tagged with the configuration
+            char *line = nullptr;
+            size_t capacity = 0;
+            rewind(job.fp);
+            while (getline(&line, &capacity, job.fp) != -1) {
+                fprintf(out, "%zu,%s", job.index, line);
+            }
+            free(line);
+            fclose(job.fp);
+            fflush(out);
+        }
+
+        return failures;
+    }
+}
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_SWEEP_H
+#define FL_SWEEP_H
+
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-experiment
+    * \brief Runs a parameter sweep over a pool of forked worker processes
+    *
+    * The simulator is a process wide singleton, so every configuration runs in its own
+    * process. At most nWorkers run at once; each worker writes its CSV rows to a private
+    * temporary file that is appended to the output, prefixed by the configuration index,
+    * once the worker exits.
+    */
+    class SweepDriver {
+    public:
+        /**
+         * \brief Runs one configuration in a worker, returns the process exit code
+         */
+        typedef std::function<int(const std::string &config, FILE *fp)> Worker;
+
+        /**
+        * \brief Constructs SweepDriver
+        * \param nWorkers         Maximum number of concurrent workers, number of online cores if 0
+        * \param maxWorkerMemory  Address space limit of each worker in bytes, unlimited if 0
+        */
+        SweepDriver(uint32_t nWorkers, uint64_t maxWorkerMemory);
+
+        /**
+        * \brief Reads configurations, one per line; empty lines and lines starting with '#' are skipped
+        * \param fileName  Sweep file
+        * \return          Configurations
+        */
+        static std::vector<std::string> ReadConfigs(const std::string &fileName);
+
+        /**
+        * \brief Splits a configuration into command line arguments, "--" is prepended when missing
+        * \param program  Program name, first argument
+        * \param config   Configuration, e.g. "NumClients=20 TxGain=5"
+        * \return         Arguments
+        */
+        static std::vector<std::string> ToArgs(const std::string &program, const std::string &config);
+
+        /**
+        * \brief Runs every configuration and gathers the rows
+        * \param configs  Configurations
+        * \param worker   Runs one configuration, called in the forked process
+        * \param out      Output for the gathered rows
+        * \return         Number of configurations that failed
+        */
+        int Run(const std::vector<std::string> &configs, Worker worker, FILE *out);
+
+    private:
+        uint32_t m_nWorkers;          //!< Maximum number of concurrent workers
+        uint64_t m_maxWorkerMemory;   //!< Address space limit of each worker in bytes
+    };
+}
+
+#endif
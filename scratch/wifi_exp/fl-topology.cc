@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-topology.h"
+
+#include "ns3/data-rate.h"
+
+#include <sstream>
+
+namespace ns3 {
+
+    std::unique_ptr<TopologySpec> TopologySpec::Create(const std::string &spec) {
+        std::unique_ptr<TopologySpec> topology(new TopologySpec());
+        topology->nEdges = 0;
+        topology->bSharedBackhaul = false;
+        topology->backhaulRate = "1Gbps";
+        topology->backhaulDelay = MilliSeconds(2);
+
+        size_t colon = spec.find(':');
+        std::string kind = spec.substr(0, colon);
+        std::string params = (colon == std::string::npos) ? "" : spec.substr(colon + 1);
+
+        if (kind.compare("star") == 0 && params.empty()) {
+            return topology;
+        }
+        if (kind.compare("hierarchical") != 0) {
+            return nullptr;
+        }
+
+        topology->nEdges = 4;
+        std::stringstream ss(params);
+        for (std::string item; std::getline(ss, item, ',');) {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos) {
+                return nullptr;
+            }
+            std::string key = item.substr(0, eq);
+            std::istringstream value(item.substr(eq + 1));
+            if (key.compare("edges") == 0) {
+                value >> topology->nEdges;
+            } else if (key.compare("backhaul") == 0) {
+                std::string backhaul;
+                value >> backhaul;
+                if (backhaul.compare("p2p") != 0 && backhaul.compare("csma") != 0) {
+                    return nullptr;
+                }
+                topology->bSharedBackhaul = backhaul.compare("csma") == 0;
+            } else if (key.compare("rate") == 0) {
+                DataRate rate;
+                value >> rate;
+                if (rate.GetBitRate() == 0) {
+                    return nullptr;
+                }
+                topology->backhaulRate = item.substr(eq + 1);
+            } else if (key.compare("delay") == 0) {
+                value >> topology->backhaulDelay;
+            } else {
+                return nullptr;
+            }
+            if (value.fail()) {
+                return nullptr;
+            }
+        }
+        if (topology->nEdges < 1 || topology->nEdges > MAX_EDGES || topology->backhaulDelay.IsNegative()) {
+            return nullptr;
+        }
+        return topology;
+    }
+}
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_TOPOLOGY_H
+#define FL_TOPOLOGY_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-experiment
+    * \brief Shape of the network between the clients and the server
+    *
+    * Built from a specification:
+    *  - "star": every client shares one segment with the server (default).
+    *  - "hierarchical[:edges=4,backhaul=p2p,rate=1Gbps,delay=2ms]": the clients are split in
+    *    contiguous blocks over edge aggregators, each with its own Wi-Fi BSS or CSMA segment.
+    *    An edge sends the model of the root to its clients, aggregates their updates and
+    *    forwards the aggregate to the root over the backhaul, either a dedicated link per edge
+    *    ("p2p") or one segment shared by all edges ("csma").
+    */
+    struct TopologySpec {
+        uint32_t nEdges;            //!< Edge aggregators, 0 for the star
+        bool bSharedBackhaul;       //!< One segment for all edges instead of a link per edge
+        std::string backhaulRate;   //!< Rate of the backhaul
+        Time backhaulDelay;         //!< Propagation delay of the backhaul
+
+        /**
+        * \brief Get if the clients reach the server through edge aggregators
+        * \return True for the hierarchical topology
+        */
+        bool IsHierarchical() const {
+            return nEdges > 0;
+        }
+
+        /**
+        * \brief Create a topology
+        * \param spec  Specification, see the struct description
+        * \return The topology, null if the specification is invalid
+        */
+        static std::unique_ptr<TopologySpec> Create(const std::string &spec);
+
+        static constexpr uint32_t MAX_EDGES = 254;  //!< One /16 per BSS, 10.1.0.0 to 10.254.0.0
+    };
+}
+
+#endif
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#include "fl-update-codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace ns3 {
+
+    // Cost per processed parameter on the client (encode) and the server (decode), seconds.
+    // Top-k is a partial selection, quantization a scale and a rounding, delta an
+    // entropy coder; the client numbers are for the training devices, the server is faster.
+    static const double TOPK_ENCODE = 30e-9;
+    static const double TOPK_DECODE = 2e-9;
+    static const double QUANT_ENCODE = 4e-9;
+    static const double QUANT_DECODE = 1e-9;
+    static const double DELTA_ENCODE = 15e-9;
+    static const double DELTA_DECODE = 5e-9;
+
+    static const double QUANT_BUCKET = 256;
+
+    uint32_t EncodedUpdate::GetBytes() const {
+        double bytes = (values * valueBits / 8 + indexBytes + metaBytes) * scale;
+        return (uint32_t) std::max(1.0, std::ceil(bytes));
+    }
+
+    /**
+    * \brief Keeps the largest values
+    */
+    class TopKStage : public UpdateCodecStage {
+    public:
+        void Apply(EncodedUpdate &update, double ratio) const override {
+            update.encodeTime += update.values * TOPK_ENCODE;
+            update.decodeTime += update.values * TOPK_DECODE;
+
+            update.values = std::ceil(update.values * ratio);
+            // 32 bit indices or a bitmap over the dense model
+            update.indexBytes = std::min(update.values * 4, std::ceil(update.dense / 8));
+        }
+    };
+
+    /**
+    * \brief Narrows the values to 8, 4 or 1 bit
+    */
+    class QuantizeStage : public UpdateCodecStage {
+    public:
+        void Apply(EncodedUpdate &update, double ratio) const override {
+            double bits = 32 * ratio;
+            double width = bits >= 8 ? 8 : (bits >= 4 ? 4 : 1);
+            if (width >= update.valueBits) {
+                return;
+            }
+
+            update.encodeTime += update.values * QUANT_ENCODE;
+            update.decodeTime += update.values * QUANT_DECODE;
+
+            update.valueBits = width;
+            update.metaBytes += std::ceil(update.values / QUANT_BUCKET) * 4;
+        }
+    };
+
+    /**
+    * \brief Entropy codes the difference to the previous update
+    */
+    class DeltaStage : public UpdateCodecStage {
+    public:
+        void Apply(EncodedUpdate &update, double ratio) const override {
+            update.encodeTime += update.values * DELTA_ENCODE;
+            update.decodeTime += update.values * DELTA_DECODE;
+
+            update.scale *= ratio;
+        }
+    };
+
+    EncodedUpdate UpdateCodec::Encode(uint32_t modelBytes, double ratio) const {
+        EncodedUpdate update;
+        update.dense = std::ceil(modelBytes / 4.0);
+        update.values = update.dense;
+        update.valueBits = 32;
+        update.indexBytes = 0;
+        update.metaBytes = 0;
+        update.scale = 1;
+        update.encodeTime = 0;
+        update.decodeTime = 0;
+
+        for (size_t i = 0; i < m_stages.size(); i++) {
+            double r = (i == 0 && ratio > 0) ? std::min(ratio, 1.0) : m_ratios[i];
+            m_stages[i]->Apply(update, r);
+        }
+        return update;
+    }
+
+    std::unique_ptr<UpdateCodec> UpdateCodec::Create(const std::string &spec) {
+        std::unique_ptr<UpdateCodec> codec(new UpdateCodec());
+
+        std::stringstream ss(spec);
+        for (std::string item; std::getline(ss, item, '+');) {
+            size_t colon = item.find(':');
+            std::string kind = item.substr(0, colon);
+
+            double ratio;
+            if (kind.compare("topk") == 0) {
+                codec->m_stages.emplace_back(new TopKStage());
+                ratio = 0.1;
+            } else if (kind.compare("quant") == 0) {
+                codec->m_stages.emplace_back(new QuantizeStage());
+                ratio = 0.25;
+            } else if (kind.compare("delta") == 0) {
+                codec->m_stages.emplace_back(new DeltaStage());
+                ratio = 0.6;
+            } else {
+                return nullptr;
+            }
+
+            if (colon != std::string::npos) {
+                char *end;
+                std::string value = item.substr(colon + 1);
+                ratio = std::strtod(value.c_str(), &end);
+                if (value.empty() || *end != '\0') {
+                    return nullptr;
+                }
+            }
+            if (!(ratio > 0 && ratio <= 1)) {
+                return nullptr;
+            }
+            codec->m_ratios.push_back(ratio);
+        }
+
+        if (codec->m_stages.empty()) {
+            return nullptr;
+        }
+        return codec;
+    }
+}
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Emily Ekaireb
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Emily Ekaireb <eekaireb@ucsd.edu>
+ */
+
+#ifndef FL_UPDATE_CODEC_H
+#define FL_UPDATE_CODEC_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+    /**
+    * \ingroup fl-client
+    * \brief Size of a model update as it goes through the encoding stages
+    *
+    * The model is a dense vector of 32 bit floats. Stages drop values, narrow them, add
+    * the indices and scales needed to decode them, or compress the whole stream.
+    */
+    struct EncodedUpdate {
+        double dense;         //!< Parameters of the model
+        double values;        //!< Values sent
+        double valueBits;     //!< Bits per value sent
+        double indexBytes;    //!< Bytes locating the values sent, 0 if dense
+        double metaBytes;     //!< Scales and other side information
+        double scale;         //!< Factor of a stream compressor applied to everything
+        double encodeTime;    //!< Client time spent encoding (s)
+        double decodeTime;    //!< Server time spent decoding (s)
+
+        /**
+        * \brief Get bytes on the wire
+        * \return Encoded size, at least 1 byte
+        */
+        uint32_t GetBytes() const;
+    };
+
+    /**
+    * \ingroup fl-client
+    * \brief One stage of an update codec
+    *
+    * Each stage takes a ratio in (0, 1], the compression it would achieve on its own.
+    */
+    class UpdateCodecStage {
+    public:
+        virtual ~UpdateCodecStage() {}
+
+        /**
+        * \brief Apply the stage
+        * \param update  Update to encode, modified in place
+        * \param ratio   Ratio of the stage
+        */
+        virtual void Apply(EncodedUpdate &update, double ratio) const = 0;
+    };
+
+    /**
+    * \ingroup fl-client
+    * \brief Pipeline of stages encoding the update a client uploads
+    *
+    * Built from a specification of stages joined by '+', applied left to right, e.g.
+    * "delta+topk:0.01+quant:0.25". The stages are:
+    *  - "topk[:k]": keeps the fraction k (default 0.1) of the largest values and sends their
+    *    indices, as 32 bit integers or as a bitmap, whichever is smaller.
+    *  - "quant[:r]": quantizes the values to 8, 4 or 1 bit, the largest width at most 32 * r
+    *    (default 0.25, 8 bit), with one 32 bit scale per bucket of 256 values.
+    *  - "delta[:r]": sends the difference to the previous update through an entropy coder,
+    *    which shrinks the stream to r of its size (default 0.6).
+    * Every stage costs encoding time on the client and decoding time on the server, per
+    * parameter it processes.
+    */
+    class UpdateCodec {
+    public:
+        /**
+        * \brief Encode an update
+        * \param modelBytes  Size of the dense model
+        * \param ratio       Ratio of the first stage, 0 for the one of the specification
+        * \return The encoded update
+        */
+        EncodedUpdate Encode(uint32_t modelBytes, double ratio) const;
+
+        /**
+        * \brief Create a codec
+        * \param spec  Stages joined by '+', see the class description
+        * \return The codec, null if the specification is invalid
+        */
+        static std::unique_ptr<UpdateCodec> Create(const std::string &spec);
+
+    private:
+        std::vector<std::unique_ptr<UpdateCodecStage> > m_stages;   //!< Stages, in order
+        std::vector<double> m_ratios;                               //!< Ratio of each stage
+    };
+}
+
+#endif
@@ -19,8 +19,15 @@
  */
 
 #include "fl-experiment.h"
+#include "fl-sweep.h"
+#include "fl-energy.h"
+#include "fl-client-health.h"
+#include "fl-client-churn.h"
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <chrono>
+#include <sstream>
 
 using sysclock_t = std::chrono::system_clock;
 
@@ -34,9 +41,6 @@ int main(int argc, char *argv[]) {
 
    //LogComponentEnable("PropagationLossModel", LOG_LEVEL_ALL);
 
-    FLSimProvider *flSimProvider = &g_fLSimProvider;
-
-
     std::string dataRate = "250kbps";                  /* Application layer datarate. */
     int numClients = 20; //when numClients is 50 or greater, packets are not recieved by server
     std::string NetworkType = "wifi";
@@ -44,6 +48,49 @@ int main(int argc, char *argv[]) {
     double TxGain = 0.0; //dB + 30 = dBm
     double ModelSize = 1.500 * 10; // kb
     std::string learningModel = "sync";
+    bool pacing = true;
+    uint32_t pacingBurst = 0;
+    bool persistent = false;
+    std::string transport = "tcp";
+    std::string endpoint = "8080";
+    int rounds = 1;
+    std::string sweep = "";
+    std::string output = "sweep.csv";
+    uint32_t workers = 0;
+    uint32_t workerMemory = 0;
+    std::string engine = "packet";
+    std::string calibration = "";
+    std::string logFormat = "csv";
+    bool logThread = false;
+    std::string convertLog = "";
+    std::string deviceTypes = "400";
+    std::string dataset = "CIFAR-10";
+    double epochs = 5.0;
+    bool health = false;
+    std::string healthDevice = "RaspberryPi";
+    double ambientTemperature = 25.0;
+    double throttleTemperature = 60.0;
+    double throttleSlope = 0.02;
+    bool healthSelection = false;
+    double minReliability = 0.0;
+    std::string clientProfiles = "cycle";
+    std::string churn = "";
+    double roundTimeout = 0.0;
+    std::string convertAvailability = "";
+    double minBattery = 20.0;
+    bool broadcast = false;
+    double aggregationOverhead = 0.0;
+    std::string aggregationRate = "0bps";
+    std::string codec = "";
+    std::string topology = "star";
+    double asyncTimeBudget = 0.0;
+    double asyncWallBudget = 0.0;
+    uint32_t asyncMaxUpdates = 0;
+    uint32_t asyncMaxCycles = 3;
+    bool asyncStopAllCycled = true;
+    uint32_t asyncMaxStaleness = 0;
+    uint32_t asyncBufferSize = 1;
+    uint32_t asyncReportBatch = 1;
 
 
     CommandLine cmd(__FILE__);
@@ -55,112 +102,450 @@ int main(int argc, char *argv[]) {
     cmd.AddValue("ModelSize", "Size of model", ModelSize);
     cmd.AddValue("DataRate", "Application data rate", dataRate);
     cmd.AddValue("LearningModel", "Async or Sync federated learning", learningModel);
+    cmd.AddValue("Pacing", "Pace the model transfers at DataRate, otherwise only the TCP send buffer limits them",
+                 pacing);
+    cmd.AddValue("PacingBurst", "Bytes written at once when pacing, 0 for 16 MaxPacketSize packets", pacingBurst);
+    cmd.AddValue("Persistent", "Build the network once and keep it across rounds (sync only)", persistent);
+    cmd.AddValue("Transport", "Transport to flsim (tcp, unix or shm)", transport);
+    cmd.AddValue("Endpoint", "Port for tcp, socket path for unix, segment name for shm", endpoint);
+    cmd.AddValue("Rounds", "Number of rounds to run without flsim (sweep workers)", rounds);
+    cmd.AddValue("Sweep", "File with one configuration per line, e.g. \"NumClients=20 TxGain=5\"", sweep);
+    cmd.AddValue("Output", "CSV file gathering the rows of all sweep configurations", output);
+    cmd.AddValue("Workers", "Number of concurrent sweep workers, one per core if 0", workers);
+    cmd.AddValue("WorkerMemory", "Address space limit of each sweep worker in MB, unlimited if 0", workerMemory);
+    cmd.AddValue("Engine", "packet (simulate), analytic (closed form estimate, sync only) "
+                           "or calibrate (simulate and fit the analytic model)", engine);
+    cmd.AddValue("Calibration", "Analytic model parameters, read by analytic and written by calibrate", calibration);
+    cmd.AddValue("LogFormat", "Format of the round records, csv or binary", logFormat);
+    cmd.AddValue("LogThread", "Write the round records from a background thread", logThread);
+    cmd.AddValue("ConvertLog", "Convert a binary round record log to <ConvertLog>.csv and exit", convertLog);
+    cmd.AddValue("DeviceTypes", "Comma separated device types (4 or 400) assigned to clients in turn", deviceTypes);
+    cmd.AddValue("Dataset", "Dataset trained by the clients (MNIST, FashionMNIST or CIFAR-10)", dataset);
+    cmd.AddValue("Epochs", "Local epochs per round", epochs);
+    cmd.AddValue("Health", "Simulate the temperature and reliability of each client and derate its training time",
+                 health);
+    cmd.AddValue("HealthDevice", "Device type of the temperature model and idle power (see DeviceCoefficients)",
+                 healthDevice);
+    cmd.AddValue("AmbientTemperature", "Ambient temperature of the clients (C)", ambientTemperature);
+    cmd.AddValue("ThrottleTemperature", "Temperature above which training slows down (C)", throttleTemperature);
+    cmd.AddValue("ThrottleSlope", "Fraction of training time added per degree above ThrottleTemperature",
+                 throttleSlope);
+    cmd.AddValue("HealthSelection", "Leave throttled or worn clients out of the round", healthSelection);
+    cmd.AddValue("MinReliability", "Reliability below which HealthSelection considers a client worn",
+                 minReliability);
+    cmd.AddValue("ClientProfiles", "Link rate, compute speed and availability of the clients: cycle, "
+                                   "random[:rate=160kbps,rateSigma=0.5,computeSigma=0.3,availability=1] or "
+                                   "trace:<file> with rate,computeScale,availability lines; random draws "
+                                   "follow RngSeed and RngRun", clientProfiles);
+    cmd.AddValue("Churn", "Client availability: markov[:on=600,off=300] (mean seconds) or trace:<file> "
+                          "built by ConvertAvailability; always available if empty", churn);
+    cmd.AddValue("RoundTimeout", "Seconds from sending the model to receiving the update before a client "
+                                 "is dropped, 0 for none", roundTimeout);
+    cmd.AddValue("ConvertAvailability", "Convert a CSV availability trace to <ConvertAvailability>.flav and exit",
+                 convertAvailability);
+    cmd.AddValue("MinBattery", "Battery level (%) below which a client off the charger is unavailable "
+                               "(ConvertAvailability)", minBattery);
+    cmd.AddValue("Broadcast", "Send the model once per round over UDP broadcast with NACK repair instead of "
+                              "once per client connection (sync only)", broadcast);
+    cmd.AddValue("AggregationOverhead", "Fixed seconds the server spends aggregating the updates of a round "
+                                        "(each update for async)", aggregationOverhead);
+    cmd.AddValue("AggregationRate", "Rate at which the server aggregates update bytes, e.g. 800Mbps; "
+                                    "0bps for free", aggregationRate);
+    cmd.AddValue("Codec", "Encoding of the uploaded updates, stages joined by '+': topk[:k], quant[:r], "
+                          "delta[:r], e.g. delta+topk:0.01+quant:0.25; dense model if empty", codec);
+    cmd.AddValue("Topology", "star, or hierarchical[:edges=4,backhaul=p2p,rate=1Gbps,delay=2ms] where the "
+                             "clients are split over edge aggregators, each with its own BSS or segment, "
+                             "linked to the root by a dedicated (p2p) or shared (csma) backhaul", topology);
+    cmd.AddValue("AsyncTimeBudget", "Async: simulated seconds before stopping, 0 for none", asyncTimeBudget);
+    cmd.AddValue("AsyncWallBudget", "Async: wall clock seconds before stopping, 0 for none", asyncWallBudget);
+    cmd.AddValue("AsyncMaxUpdates", "Async: updates aggregated before stopping, 0 for none", asyncMaxUpdates);
+    cmd.AddValue("AsyncMaxCycles", "Async: stop once a client completed this many cycles, 0 for none",
+                 asyncMaxCycles);
+    cmd.AddValue("AsyncStopAllCycled", "Async: stop once every client completed a cycle", asyncStopAllCycled);
+    cmd.AddValue("AsyncMaxStaleness", "Async: discard updates trained on a model more than this many "
+                                      "aggregations old, 0 for no bound", asyncMaxStaleness);
+    cmd.AddValue("AsyncBufferSize", "Async: updates buffered per aggregation (FedBuff K); above 1 a client "
+                                    "does not wait for the aggregation of its update", asyncBufferSize);
+    cmd.AddValue("AsyncReportBatch", "Async: updates reported to flsim per message (needs a flsim reading "
+                                     "protocol version 5 for more than 1)", asyncReportBatch);
 
 
     cmd.Parse(argc, argv);
 
-    bool bAsync = false;
-    if (learningModel.compare("async") == 0) {
-        bAsync = true;
-    }
+    // Runs every round of one configuration; without flsim all clients are in
+    // round and Rounds rounds are run.
+    auto runExperiment = [&](FLSimProvider *flSimProvider, FILE *fp, RoundRecordWriter::Format format) -> int {
 
+        // Records are buffered and written once per round
+        RoundRecordWriter log(fp, format, logThread);
 
-    ModelSize = ModelSize * 1000; // conversion to bytes
+        bool bAsync = false;
+        if (learningModel.compare("async") == 0) {
+            bAsync = true;
+        }
 
-    NS_LOG_UNCOND(
-            "{NumClients:" << numClients << ","
-                                            "NetworkType:" << NetworkType << ","
-                                                                             "MaxPacketSize:" << MaxPacketSize << ","
-                                                                                                                  "TxGain:"
-                           << TxGain << "}"
-    );
-    //Experiment experiment(numClients,NetworkType,MaxPacketSize,TxGain);
+        Config::SetDefault("ns3::Server::Pacing", BooleanValue(pacing));
+        Config::SetDefault("ns3::Server::PacingBurst", UintegerValue(pacingBurst));
+        Config::SetDefault("ns3::ClientApplication::Pacing", BooleanValue(pacing));
+        Config::SetDefault("ns3::ClientApplication::PacingBurst", UintegerValue(pacingBurst));
+
+        AsyncPolicy asyncPolicy;
+        asyncPolicy.timeBudget = Seconds(asyncTimeBudget);
+        asyncPolicy.wallBudget = Seconds(asyncWallBudget);
+        asyncPolicy.maxUpdates = asyncMaxUpdates;
+        asyncPolicy.maxCycles = asyncMaxCycles;
+        asyncPolicy.bStopAllCycled = asyncStopAllCycled;
+        asyncPolicy.maxStaleness = asyncMaxStaleness;
+        asyncPolicy.bufferSize = asyncBufferSize;
+        asyncPolicy.reportBatch = asyncReportBatch;
+
+        if (bAsync && !asyncPolicy.HasStopCondition()) {
+            NS_LOG_UNCOND("Async learning needs a stop condition (AsyncTimeBudget, AsyncWallBudget, "
+                          "AsyncMaxUpdates, AsyncMaxCycles or AsyncStopAllCycled)");
+            return -1;
+        }
 
+        if (asyncBufferSize < 1 || asyncReportBatch < 1) {
+            NS_LOG_UNCOND("AsyncBufferSize and AsyncReportBatch must be at least 1");
+            return -1;
+        }
 
-    std::time_t now = sysclock_t::to_time_t(sysclock_t::now());
+        if (persistent && bAsync) {
+            NS_LOG_UNCOND("Persistent network is only supported for sync learning, rebuilding every round");
+            persistent = false;
+        }
 
-    char buf[80] = { 0 };
-    std::strftime(buf, sizeof(buf), "%Y-%m-%d_%H-%H-%S.csv", std::localtime(&now));
+        if (health && bAsync) {
+            NS_LOG_UNCOND("Client health is only supported for sync learning, disabling it");
+            health = false;
+        }
 
-    char strbuff[100];
-    snprintf(strbuff,99,"%s_%s_%.2f_%s",
-             learningModel.c_str(),
-             NetworkType.c_str(),
-             TxGain,
-             buf);
+        if (broadcast && bAsync) {
+            NS_LOG_UNCOND("Broadcast downlink is only supported for sync learning, sending per connection");
+            broadcast = false;
+        }
 
-    FILE *fp=fopen(strbuff,"w");
+        auto topologySpec = TopologySpec::Create(topology);
+        if (!topologySpec) {
+            NS_LOG_UNCOND("Invalid topology " << topology);
+            return -1;
+        }
 
+        if (topologySpec->IsHierarchical() && bAsync) {
+            NS_LOG_UNCOND("Hierarchical topology is only supported for sync learning, using the star");
+            topologySpec = TopologySpec::Create("star");
+        }
 
+        if (topologySpec->IsHierarchical() && persistent) {
+            NS_LOG_UNCOND("Hierarchical topology is rebuilt every round, disabling the persistent network");
+            persistent = false;
+        }
 
+        if (topologySpec->IsHierarchical() && engine.compare("packet") != 0) {
+            NS_LOG_UNCOND("Analytic engine does not model the hierarchical topology, simulating every round");
+            engine = "packet";
+        }
 
+        if (engine.compare("packet") != 0 && bAsync) {
+            NS_LOG_UNCOND("Analytic engine is only supported for sync learning, simulating every round");
+            engine = "packet";
+        }
 
-    std::default_random_engine generator;
-    std::uniform_real_distribution<double> r_dist(1.0, 4.0);
-    //std::uniform_real_distribution<double> t_dist(0,1.0);
+        FLAnalyticModel analyticModel(NetworkType.compare("wifi") == 0);
+        if (engine.compare("analytic") == 0 && !calibration.empty() && !analyticModel.Load(calibration)) {
+            NS_LOG_UNCOND("Could not read calibration " << calibration << ", using defaults");
+        }
 
-    //initialize structure for all clients
-    for (int j = 0; j < numClients; j++) {
 
-        //place the nodes at random spots from the base station
+        double modelBytes = ModelSize * 1000; // conversion to bytes, ModelSize is shared by the runs
 
-        double radius = (double) (5 << (j % 4 + 2));
-        //double theta = t_dist(generator);
-        double theta = (1.0 / numClients) * (j);
+        NS_LOG_UNCOND(
+                "{NumClients:" << numClients << ","
+                                                "NetworkType:" << NetworkType << ","
+                                                                                 "MaxPacketSize:" << MaxPacketSize << ","
+                                                                                                                      "TxGain:"
+                               << TxGain << "}"
+        );
+        //Experiment experiment(numClients,NetworkType,MaxPacketSize,TxGain);
 
-        NS_LOG_UNCOND("INIT:J=" << j << " r=" << radius << " th=" << theta);
-        g_clients[j] = std::shared_ptr<ClientSession>(new ClientSession(j, radius, theta));
-    }
 
-    ns3::Time timeOffset(0);
 
-    if (flSimProvider) {
-        g_fLSimProvider.waitForConnection();
-      }
 
-    int round = 0;
 
-    while (true) {
 
-        round ++;
 
-        if (flSimProvider) {
-            FLSimProvider::COMMAND::Type type = g_fLSimProvider.recv(g_clients);
 
-            if (type == FLSimProvider::COMMAND::Type::EXIT) {
-                g_fLSimProvider.Close();
-                break;
+        std::default_random_engine generator;
+        std::uniform_real_distribution<double> r_dist(1.0, 4.0);
+        //std::uniform_real_distribution<double> t_dist(0,1.0);
+
+        // Energy profiles are resolved once, clients pick device types in turn
+        std::vector<uint32_t> profiles;
+        std::stringstream deviceStream(deviceTypes);
+        for (std::string deviceType; std::getline(deviceStream, deviceType, ',');) {
+            profiles.push_back(FLEnergy::ResolveProfile(deviceType, dataset, epochs));
+            if (profiles.back() == FLEnergy::INVALID_PROFILE) {
+                NS_LOG_UNCOND("Invalid device type " << deviceType << " (4 or 400) or dataset " << dataset
+                              << " (MNIST, FashionMNIST or CIFAR-10)");
+                return -1;
+            }
+        }
+        if (profiles.empty()) {
+            profiles.push_back(FLEnergy::ResolveProfile("400", dataset, epochs));
+            if (profiles.back() == FLEnergy::INVALID_PROFILE) {
+                NS_LOG_UNCOND("Invalid dataset " << dataset << " (MNIST, FashionMNIST or CIFAR-10)");
+                return -1;
+            }
+        }
+
+        //initialize structure for all clients
+        for (int j = 0; j < numClients; j++) {
+
+            //place the nodes at random spots from the base station
+
+            double radius = (double) (5 << (j % 4 + 2));
+            //double theta = t_dist(generator);
+            double theta = (1.0 / numClients) * (j);
+
+            NS_LOG_UNCOND("INIT:J=" << j << " r=" << radius << " th=" << theta);
+            g_clients[j] = std::shared_ptr<ClientSession>(new ClientSession(j, radius, theta));
+            g_clients[j]->SetEnergyProfile(profiles[j % profiles.size()]);
+            if (health) {
+                g_clients[j]->SetHealth(std::make_shared<ClientHealth>(healthDevice, ambientTemperature,
+                                                                       throttleTemperature, throttleSlope));
             }
         }
 
-        auto experiment = Experiment(numClients,
+        auto profileGenerator = ClientProfileGenerator::Create(clientProfiles, NetworkType.compare("wifi") == 0);
+        ClientProfiles clientProfileTable;
+        if (!profileGenerator || !profileGenerator->Generate(numClients, clientProfileTable)) {
+            NS_LOG_UNCOND("Invalid client profiles " << clientProfiles);
+            return -1;
+        }
+
+        std::unique_ptr<ChurnModel> churnModel;
+        if (!churn.empty()) {
+            churnModel = ChurnModel::Create(churn, numClients);
+            if (!churnModel) {
+                NS_LOG_UNCOND("Invalid churn model " << churn);
+                return -1;
+            }
+        }
+        std::unique_ptr<UpdateCodec> updateCodec;
+        if (!codec.empty()) {
+            updateCodec = UpdateCodec::Create(codec);
+            if (!updateCodec) {
+                NS_LOG_UNCOND("Invalid codec " << codec);
+                return -1;
+            }
+        }
+        // Experiment time of the round start for the engines that restart the simulation every round
+        double churnClock = 0;
+
+        ns3::Time timeOffset(0);
+
+        if (flSimProvider) {
+            if (!flSimProvider->SetTransport(transport, endpoint)) {
+                NS_LOG_UNCOND("Invalid transport " << transport << " or endpoint " << endpoint);
+                return -1;
+            }
+            flSimProvider->waitForConnection();
+          }
+
+        int round = 0;
+
+        // Lives across rounds, whatever the engine: keeps the health selection and the
+        // calibration, and runs the rounds when the network persists across them
+        Experiment sessionExperiment(numClients,
                                      NetworkType,
                                      MaxPacketSize,
                                      TxGain,
-                                     ModelSize,
+                                     modelBytes,
                                      dataRate,
                                      bAsync,
                                      flSimProvider,
-                                      fp, round
-
+                                     &log, round
         );
-        auto roundStats = experiment.WeakNetwork(g_clients, timeOffset);
+        sessionExperiment.SetClientProfiles(&clientProfileTable);
+        sessionExperiment.SetBroadcast(broadcast);
+        sessionExperiment.SetAggregation(aggregationOverhead, DataRate(aggregationRate));
+        sessionExperiment.SetCodec(updateCodec.get());
+
+        while (true) {
+
+            round ++;
+
+            if (flSimProvider) {
+                FLSimProvider::COMMAND::Type type = flSimProvider->recv(g_clients);
+
+                if (type == FLSimProvider::COMMAND::Type::EXIT) {
+                    flSimProvider->Close();
+                    break;
+                }
+            }
+
+            // Without flsim the clients join the round according to their availability
+            if (!flSimProvider) {
+                clientProfileTable.DrawParticipation(g_clients);
+            }
+
+            double roundStart = (persistent || bAsync) ? timeOffset.GetSeconds() : churnClock;
+
+            if (health && healthSelection) {
+                sessionExperiment.SetRound(round);
+                sessionExperiment.SelectHealthy(g_clients, minReliability);
+            }
 
-        NS_LOG_UNCOND(">>>>>>>>>>>>>>>>>>>>>>>>>\nTIME_OFFSET:" << timeOffset << "\n" ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>");
+            std::map<int, FLSimProvider::Message> roundStats;
+            if (engine.compare("analytic") == 0) {
+                auto experiment = Experiment(numClients,
+                                             NetworkType,
+                                             MaxPacketSize,
+                                             TxGain,
+                                             modelBytes,
+                                             dataRate,
+                                             bAsync,
+                                             flSimProvider,
+                                             &log, round
+                );
+                experiment.SetClientProfiles(&clientProfileTable);
+                experiment.SetChurn(churnModel.get(), roundStart, roundTimeout);
+                experiment.SetBroadcast(broadcast);
+                experiment.SetAggregation(aggregationOverhead, DataRate(aggregationRate));
+                experiment.SetCodec(updateCodec.get());
+                roundStats = experiment.Analytic(g_clients, timeOffset, analyticModel);
+            } else if (persistent) {
+                sessionExperiment.SetRound(round);
+                sessionExperiment.SetChurn(churnModel.get(), roundStart, roundTimeout);
+                roundStats = sessionExperiment.RunRound(g_clients, timeOffset);
+            } else {
+                auto experiment = Experiment(numClients,
+                                             NetworkType,
+                                             MaxPacketSize,
+                                             TxGain,
+                                             modelBytes,
+                                             dataRate,
+                                             bAsync,
+                                             flSimProvider,
+                                              &log, round
+
+                );
+                experiment.SetClientProfiles(&clientProfileTable);
+                experiment.SetChurn(churnModel.get(), roundStart, roundTimeout);
+                experiment.SetBroadcast(broadcast);
+                experiment.SetAggregation(aggregationOverhead, DataRate(aggregationRate));
+                experiment.SetCodec(updateCodec.get());
+                experiment.SetTopology(topologySpec.get());
+                experiment.SetAsyncPolicy(asyncPolicy);
+                if (topologySpec->IsHierarchical()) {
+                    roundStats = experiment.Hierarchical(g_clients, timeOffset);
+                } else {
+                    roundStats = experiment.WeakNetwork(g_clients, timeOffset);
+                }
+            }
+
+            if (health) {
+                sessionExperiment.UpdateHealth(g_clients, roundStats);
+            }
+
+            if (churnModel && !persistent && !bAsync) {
+                // The next round starts once the slowest client uploaded, or when a client comes
+                // back if none could take part
+                double roundTime = 0;
+                for (auto &itr: roundStats) {
+                    roundTime = std::max(roundTime, itr.second.roundTime);
+                }
+                double next = roundStats.empty() ? churnModel->EarliestChange(numClients, churnClock)
+                                                 : churnClock + 1.0 + roundTime;
+                if (!std::isinf(next)) {
+                    churnClock = next;
+                }
+            }
+
+            if (engine.compare("calibrate") == 0) {
+                sessionExperiment.Calibrate(g_clients, roundStats, analyticModel);
+                if (!calibration.empty()) {
+                    analyticModel.Save(calibration);
+                }
+            }
+
+            NS_LOG_UNCOND(">>>>>>>>>>>>>>>>>>>>>>>>>\nTIME_OFFSET:" << timeOffset << "\n" ">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>");
+
+            if (flSimProvider && !bAsync) {
+                flSimProvider->send(roundStats);
+            }
+            if (!flSimProvider && round >= rounds) {
+                break;
+            }
 
-        if (flSimProvider && !bAsync) {
-            g_fLSimProvider.send(roundStats);
+            log.EndRound();
+
+        }
+
+        return 0;
+    };
+
+    if (!convertAvailability.empty()) {
+        return AvailabilityTrace::Convert(convertAvailability, convertAvailability + ".flav", minBattery) ? 0 : -1;
+    }
+
+    if (!convertLog.empty()) {
+        FILE *in = fopen(convertLog.c_str(), "rb");
+        FILE *out = fopen((convertLog + ".csv").c_str(), "w");
+        bool ok = in && out && RoundRecordWriter::ConvertToCsv(in, out);
+        if (in) {
+            fclose(in);
         }
-        if (!flSimProvider) {
-            break;
+        if (out) {
+            fclose(out);
+        }
+        if (!ok) {
+            NS_LOG_UNCOND("Could not convert " << convertLog);
+            return -1;
+        }
+        return 0;
+    }
+
+    if (!sweep.empty()) {
+        auto configs = SweepDriver::ReadConfigs(sweep);
+        FILE *out = fopen(output.c_str(), "w");
+        if (!out) {
+            NS_LOG_UNCOND("Could not open " << output);
+            return -1;
         }
 
-        fflush(fp);
+        SweepDriver driver(workers, (uint64_t) workerMemory * 1024 * 1024);
+        int failures = driver.Run(configs, [&](const std::string &config, FILE *fp) {
+            cmd.Parse(SweepDriver::ToArgs(argv[0], config));
+            return runExperiment(nullptr, fp, RoundRecordWriter::Format::CSV);
+        }, out);
 
+        fclose(out);
+        NS_LOG_UNCOND("Sweep done, " << failures << " configurations failed");
+        return failures ? 1 : 0;
     }
 
+    std::time_t now = sysclock_t::to_time_t(sysclock_t::now());
+
+    char buf[80] = { 0 };
+    bool bBinaryLog = logFormat.compare("binary") == 0;
+    std::strftime(buf, sizeof(buf), bBinaryLog ? "%Y-%m-%d_%H-%H-%S.bin" : "%Y-%m-%d_%H-%H-%S.csv",
+                  std::localtime(&now));
+
+    char strbuff[100];
+    snprintf(strbuff,99,"%s_%s_%.2f_%s",
+             learningModel.c_str(),
+             NetworkType.c_str(),
+             TxGain,
+             buf);
+
+    FILE *fp=fopen(strbuff, bBinaryLog ? "wb" : "w");
+
+    int rc = runExperiment(&g_fLSimProvider, fp,
+                           bBinaryLog ? RoundRecordWriter::Format::BINARY : RoundRecordWriter::Format::CSV);
+
     fclose(fp);
     NS_LOG_UNCOND("Exiting c++");
 
-    return 0;
+    return rc;
 }
@@ -27,6 +27,7 @@
 #include "pointer.h"
 #include "assert.h"
 #include "log.h"
+#include "string.h"
 
 #include <cmath>
 
@@ -53,6 +54,21 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("TraceFile",
+                   "Record the operations on the event list to this file, "
+                   "for utils/bench-scheduler-replay; empty for none",
+                   TypeId::ATTR_CONSTRUCT,
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileFile",
+                   "Write the CPU time of the events by context and function "
+                   "to this file, as flame graph folded stacks, when the "
+                   "simulator is destroyed; empty for none",
+                   TypeId::ATTR_CONSTRUCT,
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetProfileFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -72,7 +88,14 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
-  m_eventsWithContextEmpty = true;
+  m_eventsWithContextRing.reset (new EventSlot[CONTEXT_QUEUE_SIZE]);
+  for (uint64_t i = 0; i < CONTEXT_QUEUE_SIZE; ++i)
+    {
+      m_eventsWithContextRing[i].sequence.store (i, std::memory_order_relaxed);
+    }
+  m_eventsWithContextTail.store (0, std::memory_order_relaxed);
+  m_eventsWithContextHead = 0;
+  m_eventsWithContextOverflow.store (false, std::memory_order_relaxed);
   m_main = SystemThread::Self ();
 }
 
@@ -86,6 +109,12 @@ DefaultSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   ProcessEventsWithContext ();
+  m_trace.reset ();
+  if (m_profiler)
+    {
+      m_profiler->Write ();
+      m_profiler.reset ();
+    }
 
   while (!m_events->IsEmpty ())
     {
@@ -111,6 +140,34 @@ DefaultSimulatorImpl::Destroy ()
     }
 }
 
+void
+DefaultSimulatorImpl::SetTraceFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_trace.reset ();
+  if (filename.empty ())
+    {
+      return;
+    }
+  m_trace.reset (new SchedulerTraceWriter ());
+  if (!m_trace->Open (filename))
+    {
+      NS_LOG_WARN ("Could not open the event trace " << filename);
+      m_trace.reset ();
+    }
+}
+
+void
+DefaultSimulatorImpl::SetProfileFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_profiler.reset ();
+  if (!filename.empty ())
+    {
+      m_profiler.reset (new EventProfiler (filename));
+    }
+}
+
 void
 DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
 {
@@ -139,6 +196,10 @@ void
 DefaultSimulatorImpl::ProcessOneEvent (void)
 {
   Scheduler::Event next = m_events->RemoveNext ();
+  if (m_trace)
+    {
+      m_trace->Write (SchedulerTrace::REMOVE_NEXT, m_currentTs, next.key);
+    }
 
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
@@ -148,7 +209,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiler)
+    {
+      m_profiler->Invoke (next.impl, m_currentContext);
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -160,34 +228,61 @@ DefaultSimulatorImpl::IsFinished (void) const
   return m_events->IsEmpty () || m_stop;
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext (const EventWithContext &event)
+{
+  Scheduler::Event ev;
+  ev.impl = event.event;
+  ev.key.m_ts = m_currentTs + event.timestamp;
+  ev.key.m_context = event.context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  if (m_trace)
+    {
+      m_trace->Write (SchedulerTrace::INSERT, m_currentTs, ev.key);
+    }
+}
+
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  // Take the ring up to the first slot not published yet
+  uint64_t head = m_eventsWithContextHead;
+  while (true)
     {
-      return;
+      EventSlot &slot = m_eventsWithContextRing[head & (CONTEXT_QUEUE_SIZE - 1)];
+      if (slot.sequence.load (std::memory_order_acquire) != head + 1)
+        {
+          break;
+        }
+      InsertEventWithContext (slot.event);
+      slot.sequence.store (head + CONTEXT_QUEUE_SIZE, std::memory_order_release);
+      head++;
     }
+  m_eventsWithContextHead = head;
 
-  // swap queues
-  EventsWithContext eventsWithContext;
+  if (!m_eventsWithContextOverflow.load (std::memory_order_acquire))
+    {
+      return;
+    }
   {
     CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap (eventsWithContext);
-    m_eventsWithContextEmpty = true;
+    // A thread may have reserved a slot before switching to the overflow,
+    // its event must go first
+    if (m_eventsWithContextTail.load (std::memory_order_relaxed) != head)
+      {
+        return;
+      }
+    m_eventsWithContext.swap (m_eventsWithContextDrain);
+    m_eventsWithContextOverflow.store (false, std::memory_order_relaxed);
   }
-  while (!eventsWithContext.empty ())
+  for (const EventWithContext &event : m_eventsWithContextDrain)
     {
-      EventWithContext event = eventsWithContext.front ();
-      eventsWithContext.pop_front ();
-      Scheduler::Event ev;
-      ev.impl = event.event;
-      ev.key.m_ts = m_currentTs + event.timestamp;
-      ev.key.m_context = event.context;
-      ev.key.m_uid = m_uid;
-      m_uid++;
-      m_unscheduledEvents++;
-      m_events->Insert (ev);
+      InsertEventWithContext (event);
     }
+  m_eventsWithContextDrain.clear ();
 }
 
 void
@@ -243,6 +338,10 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_trace)
+    {
+      m_trace->Write (SchedulerTrace::INSERT, m_currentTs, ev.key);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -262,6 +361,10 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
+      if (m_trace)
+        {
+          m_trace->Write (SchedulerTrace::INSERT, m_currentTs, ev.key);
+        }
     }
   else
     {
@@ -270,11 +373,47 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back (ev);
-        m_eventsWithContextEmpty = false;
-      }
+
+      // Reserve a ring slot, unless the ring is full or overflowed
+      uint64_t pos = m_eventsWithContextTail.load (std::memory_order_relaxed);
+      EventSlot *slot = 0;
+      if (!m_eventsWithContextOverflow.load (std::memory_order_acquire))
+        {
+          while (true)
+            {
+              slot = &m_eventsWithContextRing[pos & (CONTEXT_QUEUE_SIZE - 1)];
+              int64_t diff = (int64_t)(slot->sequence.load (std::memory_order_acquire) - pos);
+              if (diff == 0)
+                {
+                  if (m_eventsWithContextTail.compare_exchange_weak (pos, pos + 1,
+                                                                     std::memory_order_relaxed))
+                    {
+                      break;
+                    }
+                }
+              else if (diff < 0)
+                {
+                  slot = 0;
+                  break;
+                }
+              else
+                {
+                  pos = m_eventsWithContextTail.load (std::memory_order_relaxed);
+                }
+            }
+        }
+
+      if (slot != 0)
+        {
+          slot->event = ev;
+          slot->sequence.store (pos + 1, std::memory_order_release);
+        }
+      else
+        {
+          CriticalSection cs (m_eventsWithContextMutex);
+          m_eventsWithContext.push_back (ev);
+          m_eventsWithContextOverflow.store (true, std::memory_order_release);
+        }
     }
 }
 
@@ -291,6 +430,10 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_trace)
+    {
+      m_trace->Write (SchedulerTrace::INSERT, m_currentTs, ev.key);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -351,6 +494,10 @@ DefaultSimulatorImpl::Remove (const EventId &id)
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
   m_events->Remove (event);
+  if (m_trace)
+    {
+      m_trace->Write (SchedulerTrace::REMOVE, m_currentTs, event.key);
+    }
   event.impl->Cancel ();
   // whenever we remove an event from the event list, we have to unref it.
   event.impl->Unref ();
@@ -364,6 +511,14 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
   if (!IsExpired (id))
     {
       id.PeekEventImpl ()->Cancel ();
+      if (m_trace)
+        {
+          Scheduler::EventKey key;
+          key.m_ts = id.GetTs ();
+          key.m_uid = id.GetUid ();
+          key.m_context = id.GetContext ();
+          m_trace->Write (SchedulerTrace::CANCEL, m_currentTs, key);
+        }
     }
 }
 
@@ -26,10 +26,15 @@
 #include "event-impl.h"
 #include "system-thread.h"
 #include "system-mutex.h"
+#include "scheduler-trace.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
+#include <vector>
 
 /**
  * \file
@@ -97,18 +102,69 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
+  /**
+   * Slot of the queue of events from a different context.
+   *
+   * The queue is a bounded multiple producer, single consumer ring.
+   * A thread reserves the slot at m_eventsWithContextTail when its
+   * sequence equals that position, fills it and publishes it by setting
+   * the sequence to the position plus one.  The main thread takes the
+   * published slots in order and frees each for the next lap by setting
+   * its sequence to the position plus CONTEXT_QUEUE_SIZE.
+   */
+  struct EventSlot
+  {
+    /** Position the slot is free or published for, see above. */
+    std::atomic<uint64_t> sequence;
+    /** The event. */
+    EventWithContext event;
+  };
+  /** Slots in the ring, a power of two. */
+  static const uint64_t CONTEXT_QUEUE_SIZE = 1024;
+  /** The ring of events from a different context. */
+  std::unique_ptr<EventSlot[]> m_eventsWithContextRing;
+  /** Next ring position reserved by the other threads. */
+  std::atomic<uint64_t> m_eventsWithContextTail;
+  /** Next ring position taken by the main thread. */
+  uint64_t m_eventsWithContextHead;
+
   /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
+  typedef std::vector<struct EventWithContext> EventsWithContext;
+  /** The events which did not fit in the ring. */
   EventsWithContext m_eventsWithContext;
+  /** Events moved out of m_eventsWithContext, kept for its capacity. */
+  EventsWithContext m_eventsWithContextDrain;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * Flag \c true if m_eventsWithContext holds events.  The other threads
+   * then append there too, to keep the order of their events, until the
+   * main thread takes them.
    */
-  bool m_eventsWithContextEmpty;
-  /** Mutex to control access to the list of events with context. */
+  std::atomic<bool> m_eventsWithContextOverflow;
+  /** Mutex to control access to m_eventsWithContext. */
   SystemMutex m_eventsWithContextMutex;
 
+  /**
+   * Record the operations on the event list to a file, see SchedulerTrace.
+   * \param [in] filename The file, empty to stop recording.
+   */
+  void SetTraceFile (std::string filename);
+  /** Records the operations on the event list, null if not recording. */
+  std::unique_ptr<SchedulerTraceWriter> m_trace;
+
+  /**
+   * Profile the CPU time of the events to a file, see EventProfiler.
+   * \param [in] filename The file, empty to stop profiling.
+   */
+  void SetProfileFile (std::string filename);
+  /** Times the events, null if not profiling. */
+  std::unique_ptr<EventProfiler> m_profiler;
+
+  /**
+   * Insert an event from a different context in the event queue.
+   * \param [in] event The event, relative to the current time.
+   */
+  void InsertEventWithContext (const EventWithContext &event);
+
   /** Container type for the events to run at Simulator::Destroy() */
   typedef std::list<EventId> DestroyEvents;
   /** The container of events to run at Destroy. */
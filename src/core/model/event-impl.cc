@@ -21,6 +21,9 @@
 #include "event-impl.h"
 #include "log.h"
 
+#include <mutex>
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -31,6 +34,222 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/**
+ * \ingroup events
+ * Size class allocator backing EventImpl::operator new.
+ *
+ * Each thread keeps one free list per size class, so that allocating
+ * and freeing an event takes no lock.  Blocks are carved out of slabs
+ * which are never returned to the heap; a thread whose free list grows
+ * past FLUSH_COUNT blocks (an event freed by another thread than the
+ * allocating one) or which exits hands them back to a shared list,
+ * from which the threads refill before carving a new slab.
+ */
+class EventPool
+{
+public:
+  /** Size class granularity, in bytes, also the block alignment. */
+  static const size_t GRANULE = 16;
+  /** Number of size classes. */
+  static const size_t CLASSES = ns3::EventImpl::MAX_POOLED_SIZE / GRANULE;
+  /** Bytes allocated from the heap at once. */
+  static const size_t SLAB_SIZE = 64 * 1024;
+  /** Blocks moved at once between a thread and the shared lists. */
+  static const uint32_t BATCH = 256;
+  /** Free blocks a thread keeps before handing BATCH of them back. */
+  static const uint32_t FLUSH_COUNT = 4 * BATCH;
+
+  /**
+   * Get the size class of a size.
+   * \param [in] size The size, at most MAX_POOLED_SIZE.
+   * \returns The size class.
+   */
+  static size_t GetClass (size_t size)
+  {
+    return (size + GRANULE - 1) / GRANULE - 1;
+  }
+  /**
+   * Allocate a block.
+   * \param [in] cls The size class.
+   * \returns The block.
+   */
+  static void * Allocate (size_t cls);
+  /**
+   * Free a block.
+   * \param [in] p The block.
+   * \param [in] cls The size class.
+   */
+  static void Free (void *p, size_t cls);
+
+private:
+  /** A free block. */
+  struct Block
+  {
+    Block *next;  /**< Next free block. */
+  };
+  /** Free lists of one thread. */
+  struct Local
+  {
+    Block *head[CLASSES] = {};   /**< First free block of each class. */
+    uint32_t count[CLASSES] = {};  /**< Free blocks of each class. */
+    /** Hand the free blocks back to the shared lists. */
+    ~Local ();
+  };
+  /** Lists shared by the threads. */
+  struct Shared
+  {
+    std::mutex mutex;                  /**< Protects the lists. */
+    Block *head[CLASSES] = {};         /**< First free block of each class. */
+    uint32_t count[CLASSES] = {};      /**< Free blocks of each class. */
+  };
+
+  /**
+   * Get the shared lists.
+   * They are never destroyed, since events may be freed by static
+   * destructors running after them.
+   * \returns The shared lists.
+   */
+  static Shared & GetShared (void)
+  {
+    static Shared *shared = new Shared;
+    return *shared;
+  }
+  /**
+   * Refill the free list of the calling thread.
+   * \param [in,out] local The free lists of the thread.
+   * \param [in] cls The size class, whose list is empty.
+   */
+  static void Refill (Local &local, size_t cls);
+  /**
+   * Move blocks to a shared list.
+   * \param [in,out] local The free lists of the thread.
+   * \param [in] cls The size class.
+   * \param [in] n The number of blocks to move, at most the count of the class.
+   */
+  static void Release (Local &local, size_t cls, uint32_t n);
+
+  /** The free lists of the calling thread. */
+  static thread_local Local g_local;
+};
+
+thread_local EventPool::Local EventPool::g_local;
+
+EventPool::Local::~Local ()
+{
+  for (size_t cls = 0; cls < CLASSES; ++cls)
+    {
+      if (count[cls] > 0)
+        {
+          Release (*this, cls, count[cls]);
+        }
+    }
+}
+
+void *
+EventPool::Allocate (size_t cls)
+{
+  Local &local = g_local;
+  if (local.head[cls] == nullptr)
+    {
+      Refill (local, cls);
+    }
+  Block *block = local.head[cls];
+  local.head[cls] = block->next;
+  --local.count[cls];
+  return block;
+}
+
+void
+EventPool::Free (void *p, size_t cls)
+{
+  Local &local = g_local;
+  Block *block = static_cast<Block *> (p);
+  block->next = local.head[cls];
+  local.head[cls] = block;
+  if (++local.count[cls] > FLUSH_COUNT)
+    {
+      Release (local, cls, BATCH);
+    }
+}
+
+void
+EventPool::Refill (Local &local, size_t cls)
+{
+  Shared &shared = GetShared ();
+  {
+    std::lock_guard<std::mutex> lock (shared.mutex);
+    if (shared.head[cls] != nullptr)
+      {
+        local.head[cls] = shared.head[cls];
+        local.count[cls] = shared.count[cls];
+        shared.head[cls] = nullptr;
+        shared.count[cls] = 0;
+        return;
+      }
+  }
+
+  size_t blockSize = (cls + 1) * GRANULE;
+  size_t n = SLAB_SIZE / blockSize;
+  char *slab = static_cast<char *> (::operator new (n * blockSize));
+  Block *head = nullptr;
+  for (size_t i = n; i > 0; --i)
+    {
+      Block *block = reinterpret_cast<Block *> (slab + (i - 1) * blockSize);
+      block->next = head;
+      head = block;
+    }
+  local.head[cls] = head;
+  local.count[cls] = n;
+}
+
+void
+EventPool::Release (Local &local, size_t cls, uint32_t n)
+{
+  Block *first = local.head[cls];
+  Block *last = first;
+  for (uint32_t i = 1; i < n; ++i)
+    {
+      last = last->next;
+    }
+  local.head[cls] = last->next;
+  local.count[cls] -= n;
+
+  Shared &shared = GetShared ();
+  std::lock_guard<std::mutex> lock (shared.mutex);
+  last->next = shared.head[cls];
+  shared.head[cls] = first;
+  shared.count[cls] += n;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (size_t size)
+{
+  if (size > MAX_POOLED_SIZE)
+    {
+      return ::operator new (size);
+    }
+  return EventPool::Allocate (EventPool::GetClass (size));
+}
+
+void
+EventImpl::operator delete (void *p, size_t size)
+{
+  if (p == nullptr)
+    {
+      return;
+    }
+  if (size > MAX_POOLED_SIZE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  EventPool::Free (p, EventPool::GetClass (size));
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
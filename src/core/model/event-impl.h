@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,33 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate an event.
+   *
+   * Events are allocated and freed once per Simulator::Schedule, so
+   * the ones up to MAX_POOLED_SIZE bytes, which covers all the
+   * MakeEvent() events with their bound arguments, come from per-thread
+   * free lists of fixed size blocks carved out of larger slabs instead
+   * of the general purpose heap.  Larger events use ::operator new.
+   *
+   * \param [in] size The size of the event.
+   * \returns The memory for the event.
+   */
+  static void * operator new (size_t size);
+  /**
+   * Free an event allocated by operator new.
+   *
+   * The block goes back to the free list of the calling thread, which
+   * may differ from the allocating one.
+   *
+   * \param [in] p The event memory.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *p, size_t size);
+
+  /** Largest event size served from the pools, in bytes. */
+  static const size_t MAX_POOLED_SIZE = 128;
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "event-profiler.h"
+#include "log.h"
+#include "simulator.h"
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+EventProfiler::EventProfiler (const std::string &filename)
+  : m_filename (filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+}
+
+void
+EventProfiler::Invoke (EventImpl *event, uint32_t context)
+{
+  Key key;
+  key.type = &typeid (*event);
+  key.context = context;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  event->Invoke ();
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - start;
+  m_time[key] += std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ();
+}
+
+std::string
+EventProfiler::GetName (const std::type_info &type)
+{
+  std::string name = type.name ();
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (name.c_str (), NULL, NULL, &status);
+  if (status == 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+
+  // The events of MakeEvent() are classes local to the function, named
+  // "ns3::MakeEvent<...>(FUNCTION, ...)::EventMemberImpl1": keep FUNCTION
+  std::string::size_type pos = name.find ("MakeEvent");
+  if (pos == std::string::npos)
+    {
+      return name;
+    }
+  pos += 9;
+  int depth = 0;
+  std::string::size_type begin = std::string::npos;
+  for (; pos < name.size (); pos++)
+    {
+      char c = name[pos];
+      if (depth == 0 && begin == std::string::npos && c == '(')
+        {
+          begin = pos + 1;
+          continue;
+        }
+      if (depth == 0 && begin != std::string::npos && (c == ',' || c == ')'))
+        {
+          return name.substr (begin, pos - begin);
+        }
+      if (c == '<' || c == '(')
+        {
+          depth++;
+        }
+      else if (c == '>' || c == ')')
+        {
+          depth--;
+        }
+    }
+  return name;
+}
+
+bool
+EventProfiler::Write (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Several instantiations may bind the same signature
+  std::map<std::string, uint64_t> stacks;
+  for (const auto &entry : m_time)
+    {
+      std::ostringstream stack;
+      if (entry.first.context == Simulator::NO_CONTEXT)
+        {
+          stack << "no context";
+        }
+      else
+        {
+          stack << "node " << entry.first.context;
+        }
+      stack << ";" << GetName (*entry.first.type);
+      stacks[stack.str ()] += entry.second;
+    }
+
+  // The first instance of the process truncates the file
+  static std::set<std::string> written;
+  bool first = written.insert (m_filename).second;
+  std::ofstream file (m_filename.c_str (), first ? std::ios::trunc : std::ios::app);
+  if (!file.is_open ())
+    {
+      NS_LOG_WARN ("Could not open the event profile " << m_filename);
+      return false;
+    }
+  for (const auto &stack : stacks)
+    {
+      file << stack.first << " " << stack.second << std::endl;
+    }
+  m_time.clear ();
+  return true;
+}
+
+} // namespace ns3
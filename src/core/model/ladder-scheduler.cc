@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include "uinteger.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("BucketThreshold",
+                   "Events above which a bucket is spread over a new rung "
+                   "instead of being sorted into the bottom",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::SetThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_rungs (MAX_RUNGS),
+    m_nRungs (0),
+    m_threshold (50),
+    m_bottomLimit (50)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::SetThreshold (uint32_t threshold)
+{
+  NS_LOG_FUNCTION (this << threshold);
+  m_threshold = threshold;
+  m_bottomLimit = threshold;
+}
+
+uint64_t
+LadderScheduler::Spawn (uint64_t start, uint64_t span, Events &events)
+{
+  NS_LOG_FUNCTION (this << start << span << events.size ());
+  NS_ASSERT (m_nRungs < MAX_RUNGS && !events.empty () && span > 0);
+
+  uint64_t n = events.size ();
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.start = start;
+  rung.width = (span + n - 1) / n;
+  rung.nBuckets = (span + rung.width - 1) / rung.width;
+  rung.current = 0;
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      rung.buckets.resize (rung.nBuckets);
+    }
+  for (const Scheduler::Event &ev : events)
+    {
+      rung.buckets[(ev.key.m_ts - start) / rung.width].push_back (ev);
+    }
+  events.clear ();
+  return start + rung.nBuckets * rung.width;
+}
+
+void
+LadderScheduler::RefillBottom (void)
+{
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              return;
+            }
+          m_topStart = Spawn (m_topMin, m_topMax - m_topMin + 1, m_top);
+          m_topMin = std::numeric_limits<uint64_t>::max ();
+          m_topMax = 0;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+
+      Events &bucket = rung.buckets[rung.current];
+      uint64_t start = rung.CurrentStart ();
+      rung.current++;
+      if (bucket.size () > m_threshold && rung.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+          Spawn (start, rung.width, bucket);
+        }
+      else
+        {
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end (), std::greater<Scheduler::Event> ());
+          m_bottomLimit = m_threshold;
+        }
+    }
+}
+
+void
+LadderScheduler::InsertBottom (const Scheduler::Event &ev)
+{
+  m_bottom.insert (std::upper_bound (m_bottom.begin (), m_bottom.end (), ev,
+                                     std::greater<Scheduler::Event> ()),
+                   ev);
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  uint32_t i = 0;
+  while (i < m_nRungs && ts < m_rungs[i].CurrentStart ())
+    {
+      i++;
+    }
+  return i;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+
+  if (m_bottom.empty ())
+    {
+      // The queue is empty, the event is the next one
+      m_bottom.push_back (ev);
+      m_topStart = ts + 1;
+      m_topMin = std::numeric_limits<uint64_t>::max ();
+      m_topMax = 0;
+      return;
+    }
+
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      return;
+    }
+
+  uint32_t i = FindRung (ts);
+  if (i < m_nRungs)
+    {
+      Rung &rung = m_rungs[i];
+      rung.buckets[(ts - rung.start) / rung.width].push_back (ev);
+      return;
+    }
+
+  InsertBottom (ev);
+  if (m_bottom.size () > m_bottomLimit && m_nRungs < MAX_RUNGS
+      && m_bottom.front ().key.m_ts != m_bottom.back ().key.m_ts)
+    {
+      // Spread the bottom over a rung below the others.  If the earliest
+      // bucket is still large, wait for the bottom to double before
+      // spreading it again.
+      uint64_t limit = (m_nRungs > 0) ? m_rungs[m_nRungs - 1].CurrentStart () : m_topStart;
+      uint64_t start = m_bottom.back ().key.m_ts;
+      Spawn (start, limit - start, m_bottom);
+      RefillBottom ();
+      m_bottomLimit = std::max<uint32_t> (m_threshold, 2 * m_bottom.size ());
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_bottom.empty ();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  RefillBottom ();
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+
+  Events *events = &m_top;
+  if (ts < m_topStart)
+    {
+      uint32_t i = FindRung (ts);
+      if (i == m_nRungs)
+        {
+          Events::iterator it = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev,
+                                                  std::greater<Scheduler::Event> ());
+          NS_ASSERT (it != m_bottom.end () && *it == ev);
+          m_bottom.erase (it);
+          RefillBottom ();
+          return;
+        }
+      Rung &rung = m_rungs[i];
+      events = &rung.buckets[(ts - rung.start) / rung.width];
+    }
+
+  // Buckets and the top are unsorted, fill the hole with the last event
+  Events::iterator it = std::find (events->begin (), events->end (), ev);
+  NS_ASSERT (it != events->end ());
+  *it = events->back ();
+  events->pop_back ();
+}
+
+} // namespace ns3
@@ -0,0 +1,250 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "scheduler-trace.h"
+#include "log.h"
+#include <cstring>
+#include <set>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::SchedulerTraceWriter and ns3::SchedulerTraceReader implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SchedulerTrace");
+
+const char SchedulerTrace::MAGIC[8] = {'n', 's', '3', 'e', 'v', 't', 'r', '\n'};
+
+namespace {
+
+/** Size of the writer buffer before it is written to the file. */
+const size_t FLUSH_SIZE = 64 * 1024;
+
+/**
+ * Get the files already opened by a writer of this process.
+ * \returns The file names.
+ */
+std::set<std::string> &
+GetOpenedFiles (void)
+{
+  static std::set<std::string> files;
+  return files;
+}
+
+} // unnamed namespace
+
+SchedulerTraceWriter::SchedulerTraceWriter ()
+  : m_file (0),
+    m_lastNow (0),
+    m_lastUid (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SchedulerTraceWriter::~SchedulerTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+SchedulerTraceWriter::Open (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  bool first = GetOpenedFiles ().insert (filename).second;
+  m_file = std::fopen (filename.c_str (), first ? "wb" : "ab");
+  if (m_file == 0)
+    {
+      return false;
+    }
+  m_lastNow = 0;
+  m_lastUid = 0;
+  m_buffer.reserve (FLUSH_SIZE + 64);
+  m_buffer.insert (m_buffer.end (), SchedulerTrace::MAGIC,
+                   SchedulerTrace::MAGIC + sizeof (SchedulerTrace::MAGIC));
+  uint32_t version = SchedulerTrace::VERSION;
+  for (int i = 0; i < 4; ++i)
+    {
+      m_buffer.push_back ((version >> (8 * i)) & 0xff);
+    }
+  return true;
+}
+
+void
+SchedulerTraceWriter::PutVarint (uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      m_buffer.push_back ((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+  m_buffer.push_back (value);
+}
+
+void
+SchedulerTraceWriter::Write (SchedulerTrace::Op op, uint64_t now, const Scheduler::EventKey &key)
+{
+  m_buffer.push_back (op);
+  PutVarint (now - m_lastNow);
+  PutVarint (key.m_ts - now);
+  int64_t uidDelta = (int64_t) key.m_uid - (int64_t) m_lastUid;
+  PutVarint ((uint64_t) ((uidDelta << 1) ^ (uidDelta >> 63)));
+  PutVarint ((uint32_t) (key.m_context + 1));
+  m_lastNow = now;
+  m_lastUid = key.m_uid;
+  if (m_buffer.size () >= FLUSH_SIZE)
+    {
+      Flush ();
+    }
+}
+
+void
+SchedulerTraceWriter::Flush (void)
+{
+  if (m_file != 0 && !m_buffer.empty ())
+    {
+      std::fwrite (&m_buffer[0], 1, m_buffer.size (), m_file);
+    }
+  m_buffer.clear ();
+}
+
+void
+SchedulerTraceWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file == 0)
+    {
+      return;
+    }
+  Flush ();
+  std::fclose (m_file);
+  m_file = 0;
+}
+
+SchedulerTraceReader::SchedulerTraceReader ()
+  : m_file (0),
+    m_lastNow (0),
+    m_lastUid (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SchedulerTraceReader::~SchedulerTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file != 0)
+    {
+      std::fclose (m_file);
+    }
+}
+
+bool
+SchedulerTraceReader::Open (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (m_file != 0)
+    {
+      std::fclose (m_file);
+    }
+  m_file = std::fopen (filename.c_str (), "rb");
+  if (m_file == 0)
+    {
+      return false;
+    }
+  return std::fgetc (m_file) == SchedulerTrace::MAGIC[0] && ReadHeader ();
+}
+
+bool
+SchedulerTraceReader::ReadHeader (void)
+{
+  char magic[sizeof (SchedulerTrace::MAGIC) - 1];
+  uint8_t version[4];
+  if (std::fread (magic, 1, sizeof (magic), m_file) != sizeof (magic)
+      || std::memcmp (magic, SchedulerTrace::MAGIC + 1, sizeof (magic)) != 0
+      || std::fread (version, 1, sizeof (version), m_file) != sizeof (version))
+    {
+      return false;
+    }
+  uint32_t v = version[0] | (version[1] << 8) | (version[2] << 16) | ((uint32_t) version[3] << 24);
+  m_lastNow = 0;
+  m_lastUid = 0;
+  return v == SchedulerTrace::VERSION;
+}
+
+bool
+SchedulerTraceReader::GetVarint (uint64_t &value)
+{
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7)
+    {
+      int c = std::fgetc (m_file);
+      if (c == EOF)
+        {
+          return false;
+        }
+      value |= (uint64_t) (c & 0x7f) << shift;
+      if ((c & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+SchedulerTraceReader::Read (SchedulerTrace::Record &record)
+{
+  if (m_file == 0)
+    {
+      return false;
+    }
+  int op = std::fgetc (m_file);
+  if (op == SchedulerTrace::MAGIC[0])
+    {
+      record.op = SchedulerTrace::SEGMENT;
+      record.now = 0;
+      record.key.m_ts = 0;
+      record.key.m_uid = 0;
+      record.key.m_context = 0;
+      return ReadHeader ();
+    }
+  if (op < SchedulerTrace::INSERT || op > SchedulerTrace::CANCEL)
+    {
+      return false;
+    }
+
+  uint64_t now, ts, uid, context;
+  if (!GetVarint (now) || !GetVarint (ts) || !GetVarint (uid) || !GetVarint (context))
+    {
+      return false;
+    }
+  int64_t uidDelta = (int64_t) (uid >> 1) ^ -(int64_t) (uid & 1);
+  record.op = (SchedulerTrace::Op) op;
+  record.now = m_lastNow + now;
+  record.key.m_ts = record.now + ts;
+  record.key.m_uid = (uint32_t) (m_lastUid + uidDelta);
+  record.key.m_context = (uint32_t) (context - 1);
+  m_lastNow = record.now;
+  m_lastUid = record.key.m_uid;
+  return true;
+}
+
+} // namespace ns3
@@ -24,6 +24,18 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/scheduler-trace.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/uinteger.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
 
 using namespace ns3;
 
@@ -465,6 +477,409 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Check the events allocated from the EventImpl pools, below and above
+ * EventImpl::MAX_POOLED_SIZE, keep their bound arguments and that the
+ * freed blocks are reused.
+ */
+class EventImplPoolTestCase : public TestCase
+{
+public:
+  EventImplPoolTestCase ();
+
+  /** Argument making the event big enough to skip the pools. */
+  struct Large
+  {
+    uint8_t bytes[2 * EventImpl::MAX_POOLED_SIZE];  //!< Payload
+  };
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Count a small event.
+   * \param value The bound argument, checked against the event count.
+   */
+  void Small (uint32_t value);
+  /**
+   * Count a large event.
+   * \param large The bound argument, filled with the event count.
+   */
+  void Big (Large large);
+  /** Does nothing, used to allocate an event. */
+  void Nop (void) {}
+
+  uint32_t m_small;  //!< Small events run
+  uint32_t m_big;    //!< Large events run
+  bool m_bArgs;      //!< All the arguments arrived intact
+};
+
+EventImplPoolTestCase::EventImplPoolTestCase ()
+  : TestCase ("Check the pooled EventImpl allocation")
+{}
+
+void
+EventImplPoolTestCase::Small (uint32_t value)
+{
+  m_bArgs = m_bArgs && value == m_small;
+  m_small++;
+}
+
+void
+EventImplPoolTestCase::Big (Large large)
+{
+  for (uint8_t byte : large.bytes)
+    {
+      m_bArgs = m_bArgs && byte == (uint8_t) m_big;
+    }
+  m_big++;
+}
+
+void
+EventImplPoolTestCase::DoRun (void)
+{
+  m_small = 0;
+  m_big = 0;
+  m_bArgs = true;
+
+  // A freed event is handed back by the next allocation of its size
+  Ptr<EventImpl> event = Ptr<EventImpl> (MakeEvent (&EventImplPoolTestCase::Nop, this), false);
+  EventImpl *first = PeekPointer (event);
+  event = 0;
+  event = Ptr<EventImpl> (MakeEvent (&EventImplPoolTestCase::Nop, this), false);
+  NS_TEST_EXPECT_MSG_EQ (PeekPointer (event), first, "Freed event not reused");
+  event = 0;
+
+  // Enough events to go through several slabs and the shared lists
+  const uint32_t n = 20000;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &EventImplPoolTestCase::Small, this, i);
+    }
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Large large;
+      memset (large.bytes, i, sizeof (large.bytes));
+      Simulator::Schedule (NanoSeconds (i), &EventImplPoolTestCase::Big, this, large);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_small, n, "Small events lost");
+  NS_TEST_EXPECT_MSG_EQ (m_big, 100, "Large events lost");
+  NS_TEST_EXPECT_MSG_EQ (m_bArgs, true, "Bound arguments corrupted");
+}
+
+/**
+ * Check that the LadderScheduler hands out events in the same order as
+ * the MapScheduler, on clustered timestamps which go through the top,
+ * several rungs and the bottom, with removals in every tier.
+ */
+class LadderSchedulerTestCase : public TestCase
+{
+public:
+  LadderSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase ()
+  : TestCase ("Check the LadderScheduler order against the MapScheduler")
+{}
+
+void
+LadderSchedulerTestCase::DoRun (void)
+{
+  ObjectFactory factory ("ns3::LadderScheduler");
+  factory.Set ("BucketThreshold", UintegerValue (8));
+  Ptr<Scheduler> ladder = factory.Create<Scheduler> ();
+  Ptr<Scheduler> map = CreateObject<MapScheduler> ();
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  std::vector<Scheduler::Event> pending;
+  std::set<uint32_t> run;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  uint32_t mismatches = 0;
+
+  for (uint32_t step = 0; step < 20000; step++)
+    {
+      uint32_t action = rng->GetInteger (0, 9);
+      if (action < 4 || map->IsEmpty ())
+        {
+          // Bursts of equal timestamps, near slots and the far future
+          uint32_t burst = rng->GetInteger (1, 16);
+          uint64_t delay = rng->GetInteger (0, 3) == 0 ? rng->GetInteger (0, 1000000)
+                                                       : 9 * rng->GetInteger (0, 20);
+          for (uint32_t i = 0; i < burst; i++)
+            {
+              Scheduler::Event ev;
+              ev.impl = 0;
+              ev.key.m_ts = now + delay;
+              ev.key.m_uid = uid++;
+              ev.key.m_context = 0;
+              ladder->Insert (ev);
+              map->Insert (ev);
+              pending.push_back (ev);
+            }
+        }
+      else if (action < 9)
+        {
+          Scheduler::Event a = ladder->RemoveNext ();
+          Scheduler::Event b = map->RemoveNext ();
+          if (a.key.m_uid != b.key.m_uid)
+            {
+              mismatches++;
+            }
+          now = b.key.m_ts;
+          run.insert (b.key.m_uid);
+        }
+      else
+        {
+          // Drop the events already run from the candidates
+          uint32_t i = rng->GetInteger (0, pending.size () - 1);
+          while (run.count (pending[i].key.m_uid) > 0)
+            {
+              pending[i] = pending.back ();
+              pending.pop_back ();
+              if (pending.empty ())
+                {
+                  break;
+                }
+              i = rng->GetInteger (0, pending.size () - 1);
+            }
+          if (pending.empty ())
+            {
+              continue;
+            }
+          ladder->Remove (pending[i]);
+          map->Remove (pending[i]);
+          pending[i] = pending.back ();
+          pending.pop_back ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), map->IsEmpty (), "Emptiness differs at step " << step);
+      if (!map->IsEmpty ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (ladder->PeekNext ().key.m_uid, map->PeekNext ().key.m_uid,
+                                 "Next event differs at step " << step);
+        }
+    }
+  while (!map->IsEmpty ())
+    {
+      if (ladder->RemoveNext ().key.m_uid != map->RemoveNext ().key.m_uid)
+        {
+          mismatches++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (mismatches, 0, "Events out of order");
+  NS_TEST_EXPECT_MSG_EQ (ladder->IsEmpty (), true, "Events left in the LadderScheduler");
+}
+
+/**
+ * Check that the events scheduled with context from other threads all
+ * run, in the order each thread scheduled them, including when they
+ * outnumber the lock-free ring of DefaultSimulatorImpl and go through
+ * its overflow.
+ */
+class SimulatorInjectionTestCase : public TestCase
+{
+public:
+  SimulatorInjectionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Schedule events from a producer thread.
+   * \param test The test case.
+   * \param thread The producer index, used as the context.
+   */
+  static void Produce (SimulatorInjectionTestCase *test, uint32_t thread);
+  /**
+   * Record an injected event.
+   * \param thread The producer index.
+   * \param seq The index of the event in the producer.
+   */
+  void Injected (uint32_t thread, uint32_t seq);
+
+  static const uint32_t PRODUCERS = 4;  //!< Producer threads
+  static const uint32_t EVENTS = 5000;  //!< Events per producer
+  uint32_t m_next[PRODUCERS];           //!< Next expected event of each producer
+  bool m_bOrder;                        //!< Events ran in the order of their producer
+};
+
+SimulatorInjectionTestCase::SimulatorInjectionTestCase ()
+  : TestCase ("Check the events scheduled with context from other threads")
+{}
+
+void
+SimulatorInjectionTestCase::Produce (SimulatorInjectionTestCase *test, uint32_t thread)
+{
+  for (uint32_t i = 0; i < EVENTS; i++)
+    {
+      Simulator::ScheduleWithContext (thread, Seconds (0), &SimulatorInjectionTestCase::Injected,
+                                      test, thread, i);
+    }
+}
+
+void
+SimulatorInjectionTestCase::Injected (uint32_t thread, uint32_t seq)
+{
+  m_bOrder = m_bOrder && seq == m_next[thread] && Simulator::GetContext () == thread;
+  m_next[thread]++;
+}
+
+void
+SimulatorInjectionTestCase::DoRun (void)
+{
+  m_bOrder = true;
+  for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+      m_next[i] = 0;
+    }
+
+  // Create the simulator in this thread, the main one
+  Simulator::Now ();
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+      threads.push_back (std::thread (&SimulatorInjectionTestCase::Produce, this, i));
+    }
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_next[i], EVENTS, "Events of thread " << i << " lost");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_bOrder, true, "Events out of the order of their thread");
+}
+
+/**
+ * Check that DefaultSimulatorImpl records the operations on its event
+ * list with the TraceFile attribute, one segment per simulator instance.
+ */
+class SchedulerTraceTestCase : public TestCase
+{
+public:
+  SchedulerTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Read the next record and check it.
+   * \param reader The trace.
+   * \param op The expected operation.
+   * \param now The expected current time, in seconds.
+   * \param ts The expected event timestamp, in seconds.
+   * \param uid The expected event uid.
+   */
+  void Expect (SchedulerTraceReader &reader, SchedulerTrace::Op op,
+               double now, double ts, uint32_t uid);
+};
+
+SchedulerTraceTestCase::SchedulerTraceTestCase ()
+  : TestCase ("Check the event list trace")
+{}
+
+void
+SchedulerTraceTestCase::Expect (SchedulerTraceReader &reader, SchedulerTrace::Op op,
+                                double now, double ts, uint32_t uid)
+{
+  SchedulerTrace::Record record;
+  NS_TEST_ASSERT_MSG_EQ (reader.Read (record), true, "Missing record");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) record.op, (uint32_t) op, "Wrong operation");
+  NS_TEST_EXPECT_MSG_EQ (record.now, (uint64_t) Seconds (now).GetTimeStep (), "Wrong current time");
+  NS_TEST_EXPECT_MSG_EQ (record.key.m_ts, (uint64_t) Seconds (ts).GetTimeStep (), "Wrong timestamp");
+  NS_TEST_EXPECT_MSG_EQ (record.key.m_uid, uid, "Wrong uid");
+}
+
+void
+SchedulerTraceTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("scheduler.evtr");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::TraceFile", StringValue (filename));
+
+  // Two simulator instances, recorded in two segments of the file
+  EventId a = Simulator::Schedule (Seconds (1), &foo0);
+  EventId b = Simulator::Schedule (Seconds (2), &foo0);
+  EventId c = Simulator::Schedule (Seconds (3), &foo0);
+  Simulator::Cancel (b);
+  Simulator::Remove (c);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Simulator::ScheduleWithContext (7, Seconds (5), &foo0);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::TraceFile", StringValue (""));
+
+  // The first event of an instance has uid 4
+  SchedulerTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace");
+  Expect (reader, SchedulerTrace::INSERT, 0, 1, 4);
+  Expect (reader, SchedulerTrace::INSERT, 0, 2, 5);
+  Expect (reader, SchedulerTrace::INSERT, 0, 3, 6);
+  Expect (reader, SchedulerTrace::CANCEL, 0, 2, 5);
+  Expect (reader, SchedulerTrace::REMOVE, 0, 3, 6);
+  Expect (reader, SchedulerTrace::REMOVE_NEXT, 0, 1, 4);
+  Expect (reader, SchedulerTrace::REMOVE_NEXT, 1, 2, 5);
+  Expect (reader, SchedulerTrace::SEGMENT, 0, 0, 0);
+  Expect (reader, SchedulerTrace::INSERT, 0, 5, 4);
+  Expect (reader, SchedulerTrace::REMOVE_NEXT, 0, 5, 4);
+
+  SchedulerTrace::Record record;
+  NS_TEST_EXPECT_MSG_EQ (reader.Read (record), false, "Unexpected record");
+}
+
+/**
+ * Check that DefaultSimulatorImpl writes the folded stacks of its events
+ * with the ProfileFile attribute, named after the function bound by
+ * MakeEvent() and under their context.
+ */
+class EventProfilerTestCase : public TestCase
+{
+public:
+  EventProfilerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check the event profile")
+{}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("events.folded");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (filename));
+  Simulator::ScheduleWithContext (3, Seconds (1), &foo0);
+  Simulator::ScheduleWithContext (3, Seconds (2), &foo0);
+  Simulator::Schedule (Seconds (3), &foo1, 0);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (""));
+
+  std::ifstream file (filename.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "Cannot read the profile");
+  std::map<std::string, uint64_t> stacks;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::string::size_type space = line.rfind (' ');
+      NS_TEST_ASSERT_MSG_NE (space, std::string::npos, "Malformed line " << line);
+      stacks[line.substr (0, space)] = std::stoull (line.substr (space + 1));
+    }
+  NS_TEST_EXPECT_MSG_EQ (stacks.size (), 2u, "Wrong number of stacks");
+  NS_TEST_EXPECT_MSG_EQ (stacks.count ("node 3;void (*)()"), 1u, "Missing event with context");
+  NS_TEST_EXPECT_MSG_EQ (stacks.count ("no context;void (*)(int)"), 1u, "Missing event without context");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -483,5 +898,12 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerTestCase (), TestCase::QUICK);
+    AddTestCase (new EventImplPoolTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorInjectionTestCase (), TestCase::QUICK);
+    AddTestCase (new SchedulerTraceTestCase (), TestCase::QUICK);
+    AddTestCase (new EventProfilerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
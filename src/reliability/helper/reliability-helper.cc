@@ -20,6 +20,7 @@
 #include "reliability-helper.h"
 #include <ns3/log.h>
 #include "ns3/names.h"
+#include "ns3/boolean.h"
 #include <vector>
 namespace ns3 {
 
@@ -160,6 +161,20 @@ ReliabilityHelper::SetAmbientTemperature(double Tenv)
   m_Tenv = Tenv;
 }
 
+void
+ReliabilityHelper::SetLazy (bool lazy)
+{
+  TypeId::AttributeInformation info;
+  if (m_power.GetTypeId ().LookupAttributeByName ("Lazy", &info))
+    {
+      m_power.Set ("Lazy", BooleanValue (lazy));
+    }
+  if (m_reliability.GetTypeId ().LookupAttributeByName ("Lazy", &info))
+    {
+      m_reliability.Set ("Lazy", BooleanValue (lazy));
+    }
+}
+
 void
 ReliabilityHelper::Install (Ptr<Node> node)
 {
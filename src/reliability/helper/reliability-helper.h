@@ -117,6 +117,15 @@ public:
   void SetApplication(std::string n0, const DoubleValue &v0, const DoubleValue &v1);
   void SetDeviceType(std::string devicetype);
   void SetAmbientTemperature(double Tenv);
+
+  /**
+   * \brief Lazy mode: power and reliability models with a "Lazy" attribute stop
+   * scheduling periodic updates and advance the temperature and reliability only when
+   * they are read (ReliabilityModel::GetReliability, TemperatureModel::Update) or the
+   * application starts or ends.
+   * \param lazy Enable the lazy mode.
+   */
+  void SetLazy (bool lazy);
   
 private:
   ObjectFactory m_power; //!< Object factory to create power model objects
@@ -19,10 +19,12 @@
 #include "ns3/traced-value.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/pointer.h"
 #include "ns3/app-power-model.h"
+#include "ns3/device-coefficients.h"
 #include <ns3/performance-model.h>
 #include <iterator>
 #include <string>
@@ -81,6 +83,13 @@ AppPowerModel::GetTypeId (void)
                    MakeDoubleAccessor (&AppPowerModel::SetIdlePowerW,
                                        &AppPowerModel::GetIdlePowerW),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("Lazy",
+                   "Step the temperature only when it is read (TemperatureModel::Update) or "
+                   "the application starts or ends, instead of every 10 ms.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&AppPowerModel::SetLazy,
+                                        &AppPowerModel::GetLazy),
+                   MakeBooleanChecker ())
     .AddTraceSource ("CpuPower",
                      "CPU power consumption of the device.",
                      MakeTraceSourceAccessor (&AppPowerModel::m_cpupower),
@@ -98,7 +107,10 @@ AppPowerModel::AppPowerModel ()
   m_performanceModel = NULL;      // PerformanceModel
   m_currentState = 0;
   m_cpupower = 0;
-  Simulator::Schedule (m_powerUpdateInterval,&AppPowerModel::IsIdle,this);
+  m_lazy = false;
+  m_powerFit = false;
+  m_nextTick = Simulator::Now () + m_powerUpdateInterval;
+  m_idleEvent = Simulator::Schedule (m_powerUpdateInterval,&AppPowerModel::IsIdle,this);
 
 }
 
@@ -112,6 +124,10 @@ void
 AppPowerModel::RegisterTemperatureModel (Ptr<TemperatureModel> temperatureModel)
 {
   m_temperatureModel = temperatureModel;
+  if (m_lazy)
+    {
+      m_temperatureModel->SetAdvanceCallback (MakeCallback (&AppPowerModel::Advance, this));
+    }
 }
 
 void
@@ -206,35 +222,15 @@ AppPowerModel::SetAppName(const std::string &appname)
   NS_LOG_FUNCTION (this << appname);
   m_appName = appname;
 
-  if(m_appName == "LinearRegression")
-  {
-    m_A = 0.0;
-    m_B = 1.83*pow(10,-1);
-    m_C = (9.72)*pow(10,1);
-  }
-  else if(m_appName == "AdaBoost")
-  {
-    m_A = 0.0;
-    m_B = 8.13*pow(10,-4);
-    m_C = (1.94)*pow(10,1);
-  }
-  else if(m_appName == "MedianFilter")
-  {
-    m_A = 0.0;
-    m_B = 8.13*pow(10,-4);
-    m_C = (1.94)*pow(10,1);
-  }
-  else if(m_appName == "NeuralNetwork")
-  {
-    m_A = 0.0;
-    m_B = 8.13*pow(10,-4);
-    m_C = (1.94)*pow(10,1);
-  }
-  else
-  {
-    NS_FATAL_ERROR ("AppPowerModel:Undefined application: " << m_appName);
-  }
-
+  uint32_t app = DeviceCoefficients::FindApplication ("", m_appName);
+  if (app == DeviceCoefficients::NONE)
+    {
+      NS_FATAL_ERROR ("AppPowerModel:Undefined application: " << m_appName);
+    }
+  const DeviceCoefficients::Application &coefficients = DeviceCoefficients::GetApplication (app);
+  m_A = coefficients.powerA;
+  m_B = coefficients.powerB;
+  m_C = coefficients.powerC;
 }
 
 std::string
@@ -249,170 +245,15 @@ AppPowerModel::SetApplication(std::string appname, const DoubleValue &v0)
 {
   m_appName = appname;
   m_dataSize = v0.Get();
-  if(m_deviceType == "RaspberryPi")
-  {
-    if(m_appName == "AdaBoost")
-    {
-      m_A = 0.0;
-      m_B = 1.83*pow(10,-1);
-      m_C = 9.72*pow(10,1);
-    }
-    else if(m_appName == "DecisionTree")
-    {
-      m_A = 0.0;
-      m_B = 1.40*pow(10,-2);
-      m_C = 2.03*pow(10,1);
-    }
-    else if(m_appName == "RandomForest")
-    {
-      m_A = 1.40*pow(10,-7);
-      m_B = 4.64*pow(10,-2);
-      m_C = 2.40*pow(10,1);
-    }
-    else if(m_appName == "kNN")
-    {
-      m_A = 0.0;
-      m_B = 3.30*pow(10,-2);
-      m_C = 3.04*pow(10,1);
-    }
-      else if(m_appName == "LinearSVM")
-    {
-      m_A = 1.08*pow(10,-2);
-      m_B = 1.91*pow(10,0);
-      m_C = 1.47*pow(10,1);
-    }
-    else if(m_appName == "AffinityPropagation")
-    {
-      m_A = 2.16*pow(10,0);
-      m_B = -6.15*pow(10,0);
-      m_C = 2.80*pow(10,1);
-    }
-    else if(m_appName == "Birch")
-    {
-      m_A = 3.78*pow(10,-2);
-      m_B = -4.57*pow(10,-1);
-      m_C = 2.80*pow(10,1);
-    }
-    else if(m_appName == "k-means")
-    {
-      m_A = 3.74*pow(10,-2);
-      m_B = -4.75*pow(10,-1);
-      m_C = 2.77*pow(10,1);
-    }
-    else if(m_appName == "BayesianRegression")
-    {
-      m_A = 5.01*pow(10,-9);
-      m_B = 5.44*pow(10,-5);
-      m_C = 2.63*pow(10,1);
-    }
-    else if(m_appName == "LinearRegression")
-    {
-      m_A = 0.0;
-      m_B = 1.014*pow(10,-5);
-      m_C = 3.172;
-    }
-    else
-    {
-      NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
-    }
-  }
-  else if(m_deviceType == "Server")
-  {
-    if(m_appName == "AdaBoost")
-    {
-      m_A = 0.0;
-      m_B = 8.54*pow(10,-1);
-      m_C = 6.67*pow(10,2);
-    }
-    else if(m_appName == "DecisionTree")
-    {
-      m_A = 0.0;
-      m_B = 7.76*pow(10,-2);
-      m_C = 3.41*pow(10,2);
-    }
-    else if(m_appName == "RandomForest")
-    {
-      m_A = 4.13*pow(10,-6);
-      m_B = 2.04*pow(10,-1);
-      m_C = 3.94*pow(10,2);
-    }
-    else if(m_appName == "kNN")
-    {
-      m_A = 0.0;
-      m_B = 1.64*pow(10,-1);
-      m_C = 4.97*pow(10,2);
-    }
-      else if(m_appName == "LinearSVM")
-    {
-      m_A = 3.66*pow(10,-2);
-      m_B = 5.75*pow(10,0);
-      m_C = 3.87*pow(10,2);
-    }
-    else if(m_appName == "AffinityPropagation")
-    {
-      m_A = 1.59*pow(10,1);
-      m_B = 3.33*pow(10,1);
-      m_C = 2.04*pow(10,2);
-    }
-    else if(m_appName == "Birch")
-    {
-      m_A = 2.00*pow(10,-1);
-      m_B = -8.36*pow(10,-1);
-      m_C = 4.11*pow(10,2);
-    }
-    else if(m_appName == "k-means")
-    {
-      m_A = 2.47*pow(10,-1);
-      m_B = -8.38*pow(10,0);
-      m_C = 5.12*pow(10,2);
-    }
-    else if(m_appName == "BayesianRegression")
-    {
-      m_A = 2.55*pow(10,-6);
-      m_B = -4.49*pow(10,-2);
-      m_C = 8.04*pow(10,2);
-    }
-    else if(m_appName == "LinearRegression")
-    {
-      m_A = 0.0;
-      m_B = 1.94*pow(10,-1);
-      m_C = -9.51*pow(10,2);
-    }
-    else
+  uint32_t app = DeviceCoefficients::FindApplication (m_deviceType, m_appName);
+  if (app == DeviceCoefficients::NONE)
     {
       NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
     }
-  }
-  else if(m_deviceType == "Arduino")
-  {
-    if(m_appName == "MedianFilter")
-    {
-      m_A = 0.0;
-      m_B = 0.5*pow(10,-1);
-      m_C = 0.35*pow(10,0);
-    }
-    else
-    {
-      NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
-    }
-  }
-  else if(m_deviceType == "RaspberryPi0")
-  {
-    if(m_appName == "LinearRegression")
-    {
-      m_A = 0.0;
-      m_B = 6.337*pow(10,-7);
-      m_C = 1.304;
-    }
-    else
-    {
-      NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
-    }
-  }
-  else
-  {
-    NS_FATAL_ERROR ("AppPowerModel:Undefined device type: " << m_deviceType);
-  }
+  const DeviceCoefficients::Application &coefficients = DeviceCoefficients::GetApplication (app);
+  m_A = coefficients.powerA;
+  m_B = coefficients.powerB;
+  m_C = coefficients.powerC;
 
   m_performanceModel->SetApplication(m_appName,m_dataSize);
 }
@@ -421,34 +262,39 @@ void
 AppPowerModel::SetDeviceType(std::string devicetype)
 {
   m_deviceType = devicetype;
-  if(m_deviceType == "RaspberryPi")
-  {
-    m_idlePowerW = 2.0;
-    m_cpupower = m_idlePowerW;
-  }
-  else if (m_deviceType == "RaspberryPi0")
-  {
-    m_idlePowerW = 0.85;
-    m_cpupower = m_idlePowerW;
-  }
-  else if (m_deviceType == "Arduino")
-  {
-    m_idlePowerW = 0.4;
-    m_cpupower = m_idlePowerW;
-  }
-  else if (m_deviceType == "Server")
-  {
-    m_idlePowerW = 100;
-    m_cpupower = m_idlePowerW;
-  }
-  else
-  {
-    NS_FATAL_ERROR ("TemperatureSimpleModel:Undefined device type: " << m_deviceType);
-  }
+  uint32_t device = DeviceCoefficients::FindDevice (m_deviceType);
+  if (device == DeviceCoefficients::NONE)
+    {
+      NS_FATAL_ERROR ("TemperatureSimpleModel:Undefined device type: " << m_deviceType);
+    }
+  m_idlePowerW = DeviceCoefficients::GetDevice (device).idlePowerW;
+  m_powerFit = DeviceCoefficients::GetDevice (device).powerFit;
+  m_cpupower = m_idlePowerW;
 
   m_performanceModel->SetDeviceType(m_deviceType);
 }
 
+void
+AppPowerModel::SetLazy (bool lazy)
+{
+  NS_LOG_FUNCTION (this << lazy);
+  m_lazy = lazy;
+  if (m_lazy)
+    {
+      Simulator::Cancel (m_idleEvent);
+      if (m_temperatureModel)
+        {
+          m_temperatureModel->SetAdvanceCallback (MakeCallback (&AppPowerModel::Advance, this));
+        }
+    }
+}
+
+bool
+AppPowerModel::GetLazy (void) const
+{
+  return m_lazy;
+}
+
 void
 AppPowerModel::SetState (int state)
 {
@@ -477,19 +323,48 @@ AppPowerModel::IsIdle()
  if (m_currentState == 0){
   m_cpupower = m_idlePowerW; 
   m_temperatureModel->UpdateTemperature (m_cpupower);
-  Simulator::Schedule (m_powerUpdateInterval,&AppPowerModel::IsIdle,this);
+  m_idleEvent = Simulator::Schedule (m_powerUpdateInterval,&AppPowerModel::IsIdle,this);
  }
 }
 
+void
+AppPowerModel::Advance (Time t)
+{
+  if (t <= m_nextTick)
+    {
+      return;
+    }
+  int64_t interval = m_powerUpdateInterval.GetTimeStep ();
+  int64_t steps = ((t - m_nextTick).GetTimeStep () + interval - 1) / interval;
+  m_temperatureModel->UpdateTemperature (m_currentState == 1 ? m_cpupower.Get () : m_idlePowerW, steps);
+  m_nextTick += TimeStep (steps * interval);
+}
+
 
 void
 AppPowerModel::RunApp()
 {
   Time now = Simulator::Now ();
+  if (m_lazy)
+    {
+      m_temperatureModel->Update (now);
+    }
   m_performanceModel->SetApplication(m_appName,m_dataSize);
   m_currentState = 1;
-  m_powerUpdateEvent = Simulator::Schedule (Seconds(0.0),&AppPowerModel::UpdatePower,this);
   m_exectime = m_performanceModel->GetExecTime();
+  if (m_lazy)
+    {
+      // The step UpdatePower would take now, the next ones are applied by Advance
+      SetBusyPower ();
+      m_temperatureModel->UpdateTemperature (m_cpupower);
+      m_nextTick = now + m_powerUpdateInterval;
+    }
+  else
+    {
+      // A run started while the previous one's update chain is still going replaces it
+      m_powerUpdateEvent.Cancel ();
+      m_powerUpdateEvent = Simulator::Schedule (Seconds(0.0),&AppPowerModel::UpdatePower,this);
+    }
   Simulator::Schedule (Seconds(m_exectime),&AppPowerModel::TerminateApp,this);
   m_performanceModel->SetThroughput(m_dataSize/m_exectime);
   HandleAppRunEvent();
@@ -501,6 +376,10 @@ void
 AppPowerModel::TerminateApp()
 {
  //m_powerUpdateEvent.Cancel ();
+ if (m_lazy)
+   {
+     m_temperatureModel->Update (Simulator::Now ());
+   }
  m_cpupower = m_idlePowerW;
  m_currentState = 0;
  //SetIdle();
@@ -521,11 +400,7 @@ AppPowerModel::UpdatePower ()
     }
   //m_powerUpdateEvent.Cancel ();
   if(m_currentState == 1){
-    m_energy = m_A*pow(m_dataSize,2)/1000000 + m_B*m_dataSize/1000 + m_C;
-    m_cpupower = m_energy/m_exectime;
-    if((m_deviceType == "RaspberryPi") || (m_deviceType == "RaspberryPi0")){
-      m_cpupower = m_A*pow(m_dataSize,2)/1000000 + m_B*m_dataSize/1000 + m_C;
-    }
+    SetBusyPower ();
   }
   else
   {
@@ -538,10 +413,22 @@ AppPowerModel::UpdatePower ()
   m_powerUpdateEvent = Simulator::Schedule (m_powerUpdateInterval,&AppPowerModel::UpdatePower,this);
 }
 
+void
+AppPowerModel::SetBusyPower (void)
+{
+  m_energy = m_A*pow(m_dataSize,2)/1000000 + m_B*m_dataSize/1000 + m_C;
+  // Fits of the power-fit devices give the power directly
+  m_cpupower = m_powerFit ? m_energy : m_energy/m_exectime;
+}
+
 void
 AppPowerModel::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_lazy && m_temperatureModel)
+    {
+      m_temperatureModel->SetAdvanceCallback (MakeNullCallback<void, Time> ());
+    }
   m_temperatureModel = NULL;      // TemperatureModel
   m_performanceModel = NULL;      // PerformanceModel
 
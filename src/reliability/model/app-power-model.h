@@ -70,6 +70,8 @@ public:
   virtual void SetState (int state);
   virtual void SetApplication(std::string appname, const DoubleValue &v0);
   virtual void SetDeviceType(std::string devicetype);
+  void SetLazy (bool lazy);
+  bool GetLazy (void) const;
   
   /**
    * \returns Current power.
@@ -117,6 +119,19 @@ private:
    */
   void HandleAppTerminateEvent (void);
 
+  /**
+   * Sets the power of a running application (m_energy and m_cpupower).
+   */
+  void SetBusyPower (void);
+
+  /**
+   * \param t Time to bring the temperature to.
+   *
+   * Lazy mode: applies at once the temperature steps IsIdle/UpdatePower would have
+   * applied strictly before t, at the current power.
+   */
+  void Advance (Time t);
+
 private:
 
   Ptr<TemperatureModel> m_temperatureModel;
@@ -132,6 +147,7 @@ private:
   int m_currentState;
   std::string m_appName;
   std::string m_deviceType;
+  bool m_powerFit;                // the application fit of this device gives power, not energy
   double m_dataSize;
   double m_idlePowerW;
   // This variable keeps track of the total energy consumed by this model.
@@ -140,6 +156,9 @@ private:
   EventId m_powerUpdateEvent;            // energy update event
   Time m_lastUpdateTime;          // time stamp of previous energy update
   Time m_powerUpdateInterval;            // energy update interval
+  EventId m_idleEvent;            // idle temperature update event
+  bool m_lazy;                    // step the temperature only when it is read or the state changes
+  Time m_nextTick;                // lazy mode: time of the next temperature step
 
 };
 
@@ -0,0 +1,367 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "device-coefficients.h"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+
+NS_LOG_COMPONENT_DEFINE ("DeviceCoefficients");
+
+namespace ns3 {
+
+static GlobalValue g_deviceCoefficientsFile ("DeviceCoefficientsFile",
+                                             "CSV file of device and application coefficients "
+                                             "added to the built-in ones, see DeviceCoefficients",
+                                             StringValue (""),
+                                             MakeStringChecker ());
+
+namespace {
+
+struct DeviceRow
+{
+  const char *name;
+  DeviceCoefficients::Device coefficients;
+};
+
+struct ApplicationRow
+{
+  const char *device;
+  const char *app;
+  double timeA, timeB, timeC, timeDivisor;
+  double powerA, powerB, powerC;
+};
+
+// Built-in calibrations
+const DeviceRow g_devices[] = {
+  // name            idle    power   thermal A  thermal B  thermal C    thermal D
+  { "RaspberryPi",  { 2.0,   true,   0.14434,   0.98885,   0.04894698,  -3.14462264 } },
+  { "RaspberryPi0", { 0.85,  true,   0.14434,   0.98885,   0.04894698,  -3.14462264 } },
+  { "Arduino",      { 0.4,   false,  0.763094,  0.010693,  -0.000679,   9.795560 } },
+  { "Server",       { 100,   false,  0.763094,  0.010693,  -0.000679,   9.795560 } },
+};
+
+const ApplicationRow g_applications[] = {
+  // device          app                    time A    time B     time C    divisor  power A   power B    power C
+  { "RaspberryPi",  "AdaBoost",             0.0,      5.32e-2,   2.40e1,   1000,    0.0,      1.83e-1,   9.72e1 },
+  { "RaspberryPi",  "DecisionTree",         0.0,      4.14e-3,   -9.82e-1, 1000,    0.0,      1.40e-2,   2.03e1 },
+  { "RaspberryPi",  "RandomForest",         3.99e-8,  1.37e-2,   6.80e-2,  1000,    1.40e-7,  4.64e-2,   2.40e1 },
+  { "RaspberryPi",  "kNN",                  0.0,      9.32e-3,   4.52e0,   1000,    0.0,      3.30e-2,   3.04e1 },
+  { "RaspberryPi",  "LinearSVM",            3.09e-3,  5.86e-1,   -3.07e0,  1000,    1.08e-2,  1.91e0,    1.47e1 },
+  { "RaspberryPi",  "AffinityPropagation",  6.02e-1,  -1.81e0,   1.57e0,   1000,    2.16e0,   -6.15e0,   2.80e1 },
+  { "RaspberryPi",  "Birch",                1.13e-2,  -1.38e-1,  1.59e0,   1000,    3.78e-2,  -4.57e-1,  2.80e1 },
+  { "RaspberryPi",  "k-means",              1.12e-2,  -1.51e-1,  1.49e0,   1000,    3.74e-2,  -4.75e-1,  2.77e1 },
+  { "RaspberryPi",  "BayesianRegression",   1.20e-9,  4.72e-5,   7.61e-1,  1000,    5.01e-9,  5.44e-5,   2.63e1 },
+  { "RaspberryPi",  "LinearRegression",     0.0,      6.154e-6,  0.12,     1,       0.0,      1.014e-5,  3.172 },
+  { "Server",       "AdaBoost",             0.0,      4.60e-3,   1.58e0,   1000,    0.0,      8.54e-1,   6.67e2 },
+  { "Server",       "DecisionTree",         0.0,      4.21e-4,   -3.76e-1, 1000,    0.0,      7.76e-2,   3.41e2 },
+  { "Server",       "RandomForest",         1.96e-8,  1.15e-3,   -1.19e-1, 1000,    4.13e-6,  2.04e-1,   3.94e2 },
+  { "Server",       "kNN",                  0.0,      9.21e-4,   -3.19e-1, 1000,    0.0,      1.64e-1,   4.97e2 },
+  { "Server",       "LinearSVM",            2.01e-4,  2.95e-2,   -5.44e-2, 1000,    3.66e-2,  5.75e0,    3.87e2 },
+  { "Server",       "AffinityPropagation",  8.27e-2,  2.69e-1,   -1.40e0,  1000,    1.59e1,   3.33e1,    2.04e2 },
+  { "Server",       "Birch",                1.13e-3,  -4.84e-3,  9.26e-2,  1000,    2.00e-1,  -8.36e-1,  4.11e2 },
+  { "Server",       "k-means",              1.40e-3,  -4.86e-2,  7.50e-1,  1000,    2.47e-1,  -8.38e0,   5.12e2 },
+  { "Server",       "BayesianRegression",   1.33e-8,  -2.69e-4,  1.38e0,   1000,    2.55e-6,  -4.49e-2,  8.04e2 },
+  { "Server",       "LinearRegression",     0.0,      6.154e-6,  0.12,     1,       0.0,      1.94e-1,   -9.51e2 },
+  { "Arduino",      "MedianFilter",         0.0,      1.0e-1,    0.5,      1000,    0.0,      0.5e-1,    0.35 },
+  { "RaspberryPi0", "LinearRegression",     0.0,      5.76e-6,   -0.06,    1,       0.0,      6.337e-7,  1.304 },
+  // Device independent power fits of AppPowerModel::SetAppName
+  { "",             "LinearRegression",     0.0,      0.0,       0.0,      1000,    0.0,      1.83e-1,   9.72e1 },
+  { "",             "AdaBoost",             0.0,      0.0,       0.0,      1000,    0.0,      8.13e-4,   1.94e1 },
+  { "",             "MedianFilter",         0.0,      0.0,       0.0,      1000,    0.0,      8.13e-4,   1.94e1 },
+  { "",             "NeuralNetwork",        0.0,      0.0,       0.0,      1000,    0.0,      8.13e-4,   1.94e1 },
+};
+
+class Registry
+{
+public:
+  Registry ();
+
+  uint32_t AddDevice (const std::string &device, const DeviceCoefficients::Device &coefficients);
+  uint32_t AddApplication (const std::string &device, const std::string &app,
+                           const DeviceCoefficients::Application &coefficients);
+  void Load (const std::string &path);
+
+  // Deques so that references returned by GetDevice/GetApplication survive additions
+  std::deque<DeviceCoefficients::Device> m_devices;
+  std::deque<DeviceCoefficients::Application> m_applications;
+  std::unordered_map<std::string, uint32_t> m_deviceIndex;
+  std::unordered_map<std::string, uint32_t> m_applicationIndex;   // keyed on device '\n' app
+};
+
+std::string
+ApplicationKey (const std::string &device, const std::string &app)
+{
+  return device + '\n' + app;
+}
+
+Registry::Registry ()
+{
+  for (const DeviceRow &row : g_devices)
+    {
+      AddDevice (row.name, row.coefficients);
+    }
+  for (const ApplicationRow &row : g_applications)
+    {
+      DeviceCoefficients::Application a = { row.timeA, row.timeB, row.timeC, row.timeDivisor,
+                                            row.powerA, row.powerB, row.powerC,
+                                            DeviceCoefficients::NONE };
+      AddApplication (row.device, row.app, a);
+    }
+}
+
+uint32_t
+Registry::AddDevice (const std::string &device, const DeviceCoefficients::Device &coefficients)
+{
+  auto it = m_deviceIndex.find (device);
+  if (it != m_deviceIndex.end ())
+    {
+      m_devices[it->second] = coefficients;
+      return it->second;
+    }
+  uint32_t idx = m_devices.size ();
+  m_devices.push_back (coefficients);
+  m_deviceIndex.emplace (device, idx);
+  return idx;
+}
+
+uint32_t
+Registry::AddApplication (const std::string &device, const std::string &app,
+                          const DeviceCoefficients::Application &coefficients)
+{
+  DeviceCoefficients::Application a = coefficients;
+  a.device = DeviceCoefficients::NONE;
+  if (!device.empty ())
+    {
+      auto dev = m_deviceIndex.find (device);
+      if (dev == m_deviceIndex.end ())
+        {
+          NS_FATAL_ERROR ("DeviceCoefficients:Undefined device type: " << device);
+        }
+      a.device = dev->second;
+    }
+
+  std::string key = ApplicationKey (device, app);
+  auto it = m_applicationIndex.find (key);
+  if (it != m_applicationIndex.end ())
+    {
+      m_applications[it->second] = a;
+      return it->second;
+    }
+  uint32_t idx = m_applications.size ();
+  m_applications.push_back (a);
+  m_applicationIndex.emplace (key, idx);
+  return idx;
+}
+
+void
+Registry::Load (const std::string &path)
+{
+  std::ifstream file (path);
+  if (!file)
+    {
+      NS_FATAL_ERROR ("DeviceCoefficients:Cannot read " << path);
+    }
+
+  std::string line;
+  uint32_t lineNo = 0;
+  while (std::getline (file, line))
+    {
+      lineNo++;
+      std::vector<std::string> fields;
+      std::istringstream ss (line);
+      std::string field;
+      while (std::getline (ss, field, ','))
+        {
+          size_t begin = field.find_first_not_of (" \t\r");
+          size_t end = field.find_last_not_of (" \t\r");
+          fields.push_back (begin == std::string::npos ? "" : field.substr (begin, end - begin + 1));
+        }
+      if (fields.empty () || (fields.size () == 1 && fields[0].empty ()) || fields[0][0] == '#')
+        {
+          continue;
+        }
+
+      std::vector<double> values;
+      size_t first = fields[0] == "device" ? 2 : 3;
+      for (size_t i = first; i < fields.size (); i++)
+        {
+          if (fields[0] == "device" && i == 3)
+            {
+              continue;
+            }
+          char *end;
+          double v = strtod (fields[i].c_str (), &end);
+          if (fields[i].empty () || *end != '\0')
+            {
+              NS_FATAL_ERROR ("DeviceCoefficients:" << path << ":" << lineNo << ": bad number " << fields[i]);
+            }
+          values.push_back (v);
+        }
+
+      if (fields[0] == "device" && fields.size () == 8
+          && (fields[3] == "power" || fields[3] == "energy"))
+        {
+          DeviceCoefficients::Device d = { values[0], fields[3] == "power",
+                                           values[1], values[2], values[3], values[4] };
+          AddDevice (fields[1], d);
+        }
+      else if (fields[0] == "app" && fields.size () == 10)
+        {
+          DeviceCoefficients::Application a = { values[0], values[1], values[2], values[3],
+                                                values[4], values[5], values[6],
+                                                DeviceCoefficients::NONE };
+          AddApplication (fields[1], fields[2], a);
+        }
+      else
+        {
+          NS_FATAL_ERROR ("DeviceCoefficients:" << path << ":" << lineNo << ": malformed row");
+        }
+    }
+  NS_LOG_INFO ("Loaded " << path << ", " << m_devices.size () << " devices, "
+                         << m_applications.size () << " applications");
+}
+
+Registry &
+GetRegistry (void)
+{
+  static Registry registry;
+  static bool loaded = false;
+  if (!loaded)
+    {
+      loaded = true;
+      StringValue path;
+      g_deviceCoefficientsFile.GetValue (path);
+      if (!path.Get ().empty ())
+        {
+          registry.Load (path.Get ());
+        }
+    }
+  return registry;
+}
+
+} // anonymous namespace
+
+const uint32_t DeviceCoefficients::NONE;
+
+uint32_t
+DeviceCoefficients::FindDevice (const std::string &device)
+{
+  Registry &r = GetRegistry ();
+  auto it = r.m_deviceIndex.find (device);
+  return it == r.m_deviceIndex.end () ? NONE : it->second;
+}
+
+uint32_t
+DeviceCoefficients::FindApplication (const std::string &device, const std::string &app)
+{
+  Registry &r = GetRegistry ();
+  auto it = r.m_applicationIndex.find (ApplicationKey (device, app));
+  return it == r.m_applicationIndex.end () ? NONE : it->second;
+}
+
+const DeviceCoefficients::Device &
+DeviceCoefficients::GetDevice (uint32_t idx)
+{
+  return GetRegistry ().m_devices.at (idx);
+}
+
+const DeviceCoefficients::Application &
+DeviceCoefficients::GetApplication (uint32_t idx)
+{
+  return GetRegistry ().m_applications.at (idx);
+}
+
+uint32_t
+DeviceCoefficients::AddDevice (const std::string &device, const Device &coefficients)
+{
+  NS_LOG_FUNCTION (device);
+  return GetRegistry ().AddDevice (device, coefficients);
+}
+
+uint32_t
+DeviceCoefficients::AddApplication (const std::string &device, const std::string &app,
+                                    const Application &coefficients)
+{
+  NS_LOG_FUNCTION (device << app);
+  return GetRegistry ().AddApplication (device, app, coefficients);
+}
+
+void
+DeviceCoefficients::Load (const std::string &path)
+{
+  NS_LOG_FUNCTION (path);
+  GetRegistry ().Load (path);
+}
+
+double
+DeviceCoefficients::ExecTime (uint32_t app, double dataSize)
+{
+  const Application &a = GetApplication (app);
+  return std::max (0.1, (a.timeA * dataSize * dataSize / 1000000 + a.timeB * dataSize / a.timeDivisor) + a.timeC);
+}
+
+double
+DeviceCoefficients::Energy (uint32_t app, double dataSize)
+{
+  const Application &a = GetApplication (app);
+  return a.powerA * dataSize * dataSize / 1000000 + a.powerB * dataSize / 1000 + a.powerC;
+}
+
+double
+DeviceCoefficients::Power (uint32_t app, double dataSize, double execTime)
+{
+  const Application &a = GetApplication (app);
+  double energy = Energy (app, dataSize);
+  if (a.device != NONE && GetDevice (a.device).powerFit)
+    {
+      return energy;
+    }
+  return energy / execTime;
+}
+
+void
+DeviceCoefficients::EvalBatch (uint32_t app, uint32_t n, const double *dataSize,
+                               double *execTime, double *power)
+{
+  const Application &a = GetApplication (app);
+  bool powerFit = a.device != NONE && GetDevice (a.device).powerFit;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double d = dataSize[i];
+      double t = std::max (0.1, (a.timeA * d * d / 1000000 + a.timeB * d / a.timeDivisor) + a.timeC);
+      if (execTime)
+        {
+          execTime[i] = t;
+        }
+      if (power)
+        {
+          double energy = a.powerA * d * d / 1000000 + a.powerB * d / 1000 + a.powerC;
+          power[i] = powerFit ? energy : energy / t;
+        }
+    }
+}
+
+} // namespace ns3
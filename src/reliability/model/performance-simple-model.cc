@@ -20,6 +20,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/pointer.h"
 #include "performance-simple-model.h"
+#include "device-coefficients.h"
 
 
 NS_LOG_COMPONENT_DEFINE ("PerformanceSimpleModel");
@@ -177,194 +178,20 @@ PerformanceSimpleModel::SetApplication (std::string m_appName, const DoubleValue
   NS_LOG_FUNCTION (this);
   m_datasize = v0.Get() ;
 
-  
-  if(m_deviceType == "RaspberryPi")
-  {
-    if(m_appName == "AdaBoost")
-    {
-      m_A = 0.0;
-      m_B = 5.32*pow(10,-2);
-      m_C = 2.40*pow(10,1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "DecisionTree")
-    {
-      m_A = 0.0;
-      m_B = 4.14*pow(10,-3);
-      m_C = -9.82*pow(10,-1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "RandomForest")
-    {
-      m_A = 3.99*pow(10,-8);
-      m_B = 1.37*pow(10,-2);
-      m_C = 6.80*pow(10,-2);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "kNN")
-    {
-      m_A = 0.0;
-      m_B = 9.32*pow(10,-3);
-      m_C = 4.52*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-      else if(m_appName == "LinearSVM")
-    {
-      m_A = 3.09*pow(10,-3);
-      m_B = 5.86*pow(10,-1);
-      m_C = -3.07*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "AffinityPropagation")
-    {
-      m_A = 6.02*pow(10,-1);
-      m_B = -1.81*pow(10,0);
-      m_C = 1.57*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "Birch")
-    {
-      m_A = 1.13*pow(10,-2);
-      m_B = -1.38*pow(10,-1);
-      m_C = 1.59*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "k-means")
-    {
-      m_A = 1.12*pow(10,-2);
-      m_B = -1.51*pow(10,-1);
-      m_C = 1.49*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "BayesianRegression")
-    {
-      m_A = 1.20*pow(10,-9);
-      m_B = 4.72*pow(10,-5);
-      m_C = 7.61*pow(10,-1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "LinearRegression")
-    {
-      m_A = 0.0;
-      m_B = 6.154*pow(10,-6);
-      m_C = 0.12*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize) + m_C);
-    }
-    else
-    {
-      NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
-    }
-  }
-  else if(m_deviceType == "Server")
-  {
-    if(m_appName == "AdaBoost")
-    {
-      m_A = 0.0;
-      m_B = 4.60*pow(10,-3);
-      m_C = 1.58*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "DecisionTree")
-    {
-      m_A = 0.0;
-      m_B = 4.21*pow(10,-4);
-      m_C = -3.76*pow(10,-1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "RandomForest")
-    {
-      m_A = 1.96*pow(10,-8);
-      m_B = 1.15*pow(10,-3);
-      m_C = -1.19*pow(10,-1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "kNN")
-    {
-      m_A = 0.0;
-      m_B = 9.21*pow(10,-4);
-      m_C = -3.19*pow(10,-1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-      else if(m_appName == "LinearSVM")
-    {
-      m_A = 2.01*pow(10,-4);
-      m_B = 2.95*pow(10,-2);
-      m_C = -5.44*pow(10,-2);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "AffinityPropagation")
-    {
-      m_A = 8.27*pow(10,-2);
-      m_B = 2.69*pow(10,-1);
-      m_C = -1.40*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "Birch")
-    {
-      m_A = 1.13*pow(10,-3);
-      m_B = -4.84*pow(10,-3);
-      m_C = 9.26*pow(10,-2);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "k-means")
-    {
-      m_A = 1.40*pow(10,-3);
-      m_B = -4.86*pow(10,-2);
-      m_C = 7.50*pow(10,-1);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "BayesianRegression")
-    {
-      m_A = 1.33*pow(10,-8);
-      m_B = -2.69*pow(10,-4);
-      m_C = 1.38*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize/1000) + m_C);
-    }
-    else if(m_appName == "LinearRegression")
-    {
-      m_A = 0.0;
-      m_B = 6.154*pow(10,-6);
-      m_C = 0.12*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize) + m_C);
-    }
-    else
-    {
-      NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
-    }
-  }
-  else if(m_deviceType == "Arduino")
-  {
-    if(m_appName == "MedianFilter")
-    {
-      m_A = 0.0;
-      m_B = 1.0*pow(10,-1);
-      m_C = 0.5*pow(10,0);
-      m_exectime = std::max(0.1,(m_B*m_datasize)/1000 + m_C);
-    }
-    else
+  uint32_t app = DeviceCoefficients::FindApplication (m_deviceType, m_appName);
+  if (app == DeviceCoefficients::NONE)
     {
+      if (DeviceCoefficients::FindDevice (m_deviceType) == DeviceCoefficients::NONE)
+        {
+          NS_FATAL_ERROR ("AppPowerModel:Undefined device type: " << m_deviceType);
+        }
       NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
     }
-  }
-  else if(m_deviceType == "RaspberryPi0")
-  {
-    if(m_appName == "LinearRegression")
-    {
-      m_A = 0.0;
-      m_B = 5.76*pow(10,-6);
-      m_C = -0.06*pow(10,0);
-      m_exectime = std::max(0.1,(m_A*pow(m_datasize,2)/1000000+ m_B*m_datasize) + m_C);
-    }
-    else
-    {
-      NS_FATAL_ERROR ("AppPowerModel:Undefined application for this device: " << m_appName);
-    }
-  }
-  else
-  {
-    NS_FATAL_ERROR ("AppPowerModel:Undefined device type: " << m_deviceType);
-  }
-
+  const DeviceCoefficients::Application &coefficients = DeviceCoefficients::GetApplication (app);
+  m_A = coefficients.timeA;
+  m_B = coefficients.timeB;
+  m_C = coefficients.timeC;
+  m_exectime = DeviceCoefficients::ExecTime (app, m_datasize);
 }
 
 void
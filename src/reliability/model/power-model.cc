@@ -113,6 +113,10 @@ PowerModel::NotifyAppRun (void)
   //       (*i)->HandleEnergyDepletion ();
   //     }
   //   }
+  if (m_models.GetN () == 0)
+    {
+      return;
+    }
   Ptr<DeviceEnergyModel> model = m_models.Get(0);
   model->HandleEnergyDepletion ();
   
@@ -133,6 +137,10 @@ PowerModel::NotifyAppTerminate (void)
   //       (*i)->HandleEnergyRecharged ();
   //     }
   //   }
+  if (m_models.GetN () == 0)
+    {
+      return;
+    }
   Ptr<DeviceEnergyModel> model = m_models.Get(0);
   model->HandleEnergyRecharged ();
 }
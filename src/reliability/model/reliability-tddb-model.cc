@@ -17,14 +17,17 @@
 
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/pointer.h"
 #include "ns3/traced-value.h"
 #include "reliability-tddb-model.h"
+#include <algorithm>
 #include <math.h>
 #include <float.h> 
 #include <limits.h>
+#include <cstring>
 
 NS_LOG_COMPONENT_DEFINE ("ReliabilityTDDBModel");
 
@@ -32,6 +35,67 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (ReliabilityTDDBModel);
 
+std::map<std::pair<double, long long>, ReliabilityTDDBModel::RcTable> ReliabilityTDDBModel::m_rcTables;
+size_t ReliabilityTDDBModel::m_rcNodes = 0;
+
+namespace {
+
+// Spacing of the Rc table nodes in L; the quintic interpolation between them is
+// within 1e-10 of the integral
+const double RC_GRID_STEP = 0.125;
+
+// Nodes of all Rc tables above which they are cleared
+const size_t MAX_RC_NODES = 1 << 16;
+
+// Arguments of ExpNonPositive are clamped to this, exp (-708) standing for the
+// subnormal or zero results, negligible next to the other terms of the integral
+const double EXP_MIN_ARG = -708.0;
+
+/*
+ * exp (x) for EXP_MIN_ARG <= x <= 0, to about 1 ulp. Branch free and without
+ * calls, so that the compiler vectorizes the loops using it. The clamp is left to
+ * a loop of its own: here the compiler would thread the clamped case through the
+ * whole function, and the branch keeps the loop from vectorizing.
+ */
+inline double
+ExpNonPositive (double x)
+{
+  const double SHIFT = 6755399441055744.0; // 1.5 * 2^52, rounds to an integer
+  const double LN2_HI = 6.93147180369123816490e-01;
+  const double LN2_LO = 1.90821492927058770002e-10;
+  // x = k ln2 + r, |r| <= ln2 / 2; k is in the low bits of t
+  double t = x * 1.44269504088896338700 + SHIFT;
+  double k = t - SHIFT;
+  double r = (x - k * LN2_HI) - k * LN2_LO;
+
+  // Taylor series of exp (r), the terms past r^12 / 12! are below 1e-17
+  double p = 1.0 / 479001600;
+  p = p * r + 1.0 / 39916800;
+  p = p * r + 1.0 / 3628800;
+  p = p * r + 1.0 / 362880;
+  p = p * r + 1.0 / 40320;
+  p = p * r + 1.0 / 5040;
+  p = p * r + 1.0 / 720;
+  p = p * r + 1.0 / 120;
+  p = p * r + 1.0 / 24;
+  p = p * r + 1.0 / 6;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+
+  // 2^k from the bits of t
+  uint64_t tBits;
+  uint64_t shiftBits;
+  std::memcpy (&tBits, &t, sizeof (t));
+  std::memcpy (&shiftBits, &SHIFT, sizeof (SHIFT));
+  uint64_t scaleBits = (tBits - shiftBits + 1023) << 52;
+  double scale;
+  std::memcpy (&scale, &scaleBits, sizeof (scale));
+  return p * scale;
+}
+
+} // unnamed namespace
+
 TypeId
 ReliabilityTDDBModel::GetTypeId (void)
 {
@@ -57,6 +121,21 @@ ReliabilityTDDBModel::GetTypeId (void)
                    MakeDoubleAccessor (&ReliabilityTDDBModel::SetArea,
                                        &ReliabilityTDDBModel::GetArea),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("TemperatureQuantum",
+                   "Round the temperature to a multiple of this step (Celsius) and "
+                   "interpolate the reliability integral in a table of each rounded "
+                   "temperature, shared by all models, instead of integrating at every "
+                   "update. 0 disables it.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&ReliabilityTDDBModel::m_temperatureQuantum),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Lazy",
+                   "Run the 30 s updates only when the reliability is read, bringing the "
+                   "temperature to each update time first, instead of scheduling them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ReliabilityTDDBModel::SetLazy,
+                                        &ReliabilityTDDBModel::GetLazy),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Reliability",
                      "Reliability of the device.",
                      MakeTraceSourceAccessor (&ReliabilityTDDBModel::m_reliability),
@@ -71,6 +150,8 @@ ReliabilityTDDBModel::ReliabilityTDDBModel ()
   m_lastUpdateTime = Seconds (0.0);
   m_reliabilityUpdateInterval = Seconds(30);
   m_reliability = 1.0;
+  m_lazy = false;
+  m_nextUpdate = Simulator::Now () + m_reliabilityUpdateInterval;
   m_reliabilityUpdateEvent = Simulator::Schedule (m_reliabilityUpdateInterval,&ReliabilityModel::UpdateReliability,this);
  
   voltage = 1.1;
@@ -104,6 +185,11 @@ ReliabilityTDDBModel::ReliabilityTDDBModel ()
   t_life = 5*365*24*60*60;
   Rd = 1;
 
+  m_lastRc = 0;
+  m_lastScale = 0;
+  m_lastShape = 0;
+  m_lastIndex = 0;
+  m_temperatureBin = 0;
 
 }
 
@@ -117,6 +203,10 @@ void
 ReliabilityTDDBModel::RegisterTemperatureModel (Ptr<TemperatureModel> temperatureModel)
 {
   m_temperatureModel = temperatureModel;
+  if (m_lazy)
+    {
+      m_temperatureModel->SetCheckpoint (m_nextUpdate, MakeCallback (&ReliabilityTDDBModel::Checkpoint, this));
+    }
 }
 
 void
@@ -161,10 +251,35 @@ ReliabilityTDDBModel::GetArea (void) const
   return m_area;
 }
 
+void
+ReliabilityTDDBModel::SetLazy (bool lazy)
+{
+  NS_LOG_FUNCTION (this << lazy);
+  m_lazy = lazy;
+  if (m_lazy)
+    {
+      Simulator::Cancel (m_reliabilityUpdateEvent);
+      if (m_temperatureModel)
+        {
+          m_temperatureModel->SetCheckpoint (m_nextUpdate, MakeCallback (&ReliabilityTDDBModel::Checkpoint, this));
+        }
+    }
+}
+
+bool
+ReliabilityTDDBModel::GetLazy (void) const
+{
+  return m_lazy;
+}
+
 double
 ReliabilityTDDBModel::GetReliability (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_lazy && m_temperatureModel)
+    {
+      m_temperatureModel->Update (Simulator::Now ());
+    }
   return m_reliability;
 }
 
@@ -244,70 +359,271 @@ ReliabilityTDDBModel::shape_par(double T , double V , double mult_b , double tau
 
 
 
+void
+ReliabilityTDDBModel::BuildWeights (void)
+{
+  m_uMid.resize (u_num_step);
+  m_vMid.resize (v_num_step);
+  m_weights.resize (u_num_step * v_num_step);
+
+  for (int i = 0; i < u_num_step; i++)
+    {
+      m_uMid[i] = u_min + i * subdomain_step_u + 0.5 * subdomain_step_u;
+    }
+  for (int j = 0; j < v_num_step; j++)
+    {
+      m_vMid[j] = v_min + j * subdomain_step_v + 0.5 * subdomain_step_v;
+    }
+  for (int i = 0; i < u_num_step; i++)
+    {
+      double pdf_u_value = pdf_u (m_uMid[i], pdf_u_mean, pdf_u_sigma);
+      for (int j = 0; j < v_num_step; j++)
+        {
+          double pdf_v_value = pdf_v (m_vMid[j], pdf_v_offset, pdf_v_mult, pdf_v_degrees);
+          m_weights[i * v_num_step + j] = pdf_u_value * pdf_v_value * subdomain_area;
+        }
+    }
+}
+
+double
+ReliabilityTDDBModel::Integrate (double t_0, double scale_p, double shape_p) const
+{
+  double L = log (t_0 / scale_p) * shape_p;
+
+  std::vector<double> g_v (v_num_step);
+  for (int j = 0; j < v_num_step; j++)
+    {
+      g_v[j] = exp (L * shape_p * m_vMid[j]);
+    }
+
+  // The cells are computed apart from their in order sum, which would keep
+  // the loop from vectorizing
+  std::vector<double> cell (v_num_step);
+  double Rc = 0;
+  for (int i = 0; i < u_num_step; i++)
+    {
+      double a = -A * exp (L * m_uMid[i]);
+      const double *w = &m_weights[i * v_num_step];
+      for (int j = 0; j < v_num_step; j++)
+        {
+          cell[j] = std::max (a * g_v[j], EXP_MIN_ARG);
+        }
+      for (int j = 0; j < v_num_step; j++)
+        {
+          cell[j] = w[j] * ExpNonPositive (cell[j]);
+        }
+      double sum = 0;
+      for (int j = 0; j < v_num_step; j++)
+        {
+          sum += cell[j];
+        }
+      Rc += sum;
+    }
+  return Rc;
+}
+
+void
+ReliabilityTDDBModel::Tabulate (double L, double shape_p, double *node) const
+{
+  // With c = u + shape * v, g = exp (L * c), dg/dL = c * g
+  std::vector<double> g_v (v_num_step);
+  std::vector<double> c_v (v_num_step);
+  for (int j = 0; j < v_num_step; j++)
+    {
+      g_v[j] = A * exp (L * shape_p * m_vMid[j]);
+      c_v[j] = shape_p * m_vMid[j];
+    }
+
+  std::vector<double> cell (v_num_step);
+  std::vector<double> cell1 (v_num_step);
+  std::vector<double> cell2 (v_num_step);
+  node[0] = node[1] = node[2] = 0;
+  for (int i = 0; i < u_num_step; i++)
+    {
+      double g_u = exp (L * m_uMid[i]);
+      const double *w = &m_weights[i * v_num_step];
+      for (int j = 0; j < v_num_step; j++)
+        {
+          cell[j] = std::max (-g_u * g_v[j], EXP_MIN_ARG);
+        }
+      for (int j = 0; j < v_num_step; j++)
+        {
+          // Clamped as well, A * g squared would overflow where exp (-A * g) is 0
+          double Ag = -cell[j];
+          double c = m_uMid[i] + c_v[j];
+          double e = w[j] * ExpNonPositive (cell[j]);
+          cell[j] = e;
+          cell1[j] = -e * Ag * c;
+          cell2[j] = e * c * c * (Ag * Ag - Ag);
+        }
+      for (int j = 0; j < v_num_step; j++)
+        {
+          node[0] += cell[j];
+          node[1] += cell1[j];
+          node[2] += cell2[j];
+        }
+    }
+}
+
+double
+ReliabilityTDDBModel::InterpolateRc (double t_0)
+{
+  double L = log (t_0 / scale_parameter) * shape_parameter;
+  double x = L / RC_GRID_STEP;
+  long long m = (long long) floor (x);
+  x -= m;
+
+  if (m_rcNodes >= MAX_RC_NODES)
+    {
+      m_rcTables.clear ();
+      m_rcNodes = 0;
+    }
+
+  // Nodes m and m + 1, computed the first time they are needed
+  RcTable &table = m_rcTables[std::make_pair (m_temperatureQuantum, m_temperatureBin)];
+  if (table.nodes.empty ())
+    {
+      table.first = m;
+    }
+  if (m < table.first)
+    {
+      m_rcNodes += table.first - m;
+      table.nodes.insert (table.nodes.begin (), (table.first - m) * 3, -1.0);
+      table.first = m;
+    }
+  size_t end = (m - table.first + 2) * 3;
+  if (end > table.nodes.size ())
+    {
+      m_rcNodes += (end - table.nodes.size ()) / 3;
+      table.nodes.resize (end, -1.0);
+    }
+  double *n0 = &table.nodes[(m - table.first) * 3];
+  double *n1 = n0 + 3;
+  if (n0[0] < 0)
+    {
+      Tabulate (m * RC_GRID_STEP, shape_parameter, n0);
+    }
+  if (n1[0] < 0)
+    {
+      Tabulate ((m + 1) * RC_GRID_STEP, shape_parameter, n1);
+    }
+
+  // Quintic Hermite interpolation from the values and two derivatives at both ends
+  double h = RC_GRID_STEP;
+  double x2 = x * x;
+  double x3 = x2 * x;
+  double x4 = x3 * x;
+  double x5 = x4 * x;
+  return (1 - 10 * x3 + 15 * x4 - 6 * x5) * n0[0]
+         + (x - 6 * x3 + 8 * x4 - 3 * x5) * h * n0[1]
+         + (0.5 * x2 - 1.5 * x3 + 1.5 * x4 - 0.5 * x5) * h * h * n0[2]
+         + (0.5 * x3 - x4 + 0.5 * x5) * h * h * n1[2]
+         + (-4 * x3 + 7 * x4 - 3 * x5) * h * n1[1]
+         + (10 * x3 - 15 * x4 + 6 * x5) * n1[0];
+}
+
+double
+ReliabilityTDDBModel::EvaluateRc (double t_0)
+{
+  if (m_temperatureQuantum > 0)
+    {
+      return InterpolateRc (t_0);
+    }
+  return Integrate (t_0, scale_parameter, shape_parameter);
+}
+
+double
+ReliabilityTDDBModel::ComputeDamage (void)
+{
+  if (m_weights.empty ())
+    {
+      BuildWeights ();
+    }
+
+  double t_0 = LI_index * delta_LI;
+  double Rc = EvaluateRc (t_0);
+  double Rc_prec;
+
+  if (LI_index > 1)
+    {
+      if (m_lastIndex == LI_index - 1 && m_lastScale == scale_parameter && m_lastShape == shape_parameter)
+        {
+          Rc_prec = m_lastRc;
+        }
+      else
+        {
+          Rc_prec = EvaluateRc (t_0 - delta_LI);
+        }
+    }
+  else
+    {
+      Rc_prec = 1;
+    }
+
+  m_lastRc = Rc;
+  m_lastScale = scale_parameter;
+  m_lastShape = shape_parameter;
+  m_lastIndex = LI_index;
+
+  return Rc_prec - Rc;
+}
+
 void
 ReliabilityTDDBModel::UpdateReliability ()
 {
-  NS_LOG_FUNCTION (this << m_reliability << Simulator::Now ().GetSeconds ());
+  Step (Simulator::Now ());
+  m_reliabilityUpdateEvent = Simulator::Schedule (m_reliabilityUpdateInterval,&ReliabilityModel::UpdateReliability,this);
+}
+
+void
+ReliabilityTDDBModel::Checkpoint (void)
+{
+  Step (m_nextUpdate);
+  m_nextUpdate += m_reliabilityUpdateInterval;
+  m_temperatureModel->SetCheckpoint (m_nextUpdate, MakeCallback (&ReliabilityTDDBModel::Checkpoint, this));
+}
+
+void
+ReliabilityTDDBModel::Step (Time now)
+{
+  NS_LOG_FUNCTION (this << m_reliability << now.GetSeconds ());
   double temperature = m_temperatureModel->GetAvgTemperature();
 
-  Time duration = Simulator::Now () - m_lastUpdateTime;
+  Time duration = now - m_lastUpdateTime;
   NS_ASSERT (duration.GetNanoSeconds () >= 0); // check if duration is valid
 
+  if (m_temperatureQuantum > 0)
+    {
+      m_temperatureBin = llround (temperature / m_temperatureQuantum);
+      temperature = m_temperatureBin * m_temperatureQuantum;
+    }
 
   scale_parameter = 365*24*60*60*scale_par(temperature,voltage,offset_a,mult_a,tau_a,tauvolt_a);
   shape_parameter = shape_par(temperature,voltage,mult_b,tau_b,offset_b,multvolt_b); 
 
-	int i, j;
-  double u , v , t_0 , g_value , exponential_value , pdf_u_value , pdf_v_value , 
-  joint_pdf_value , integral_subdomain , g_value_prec , exponential_value_prec , 
-  integral_subdomain_prec , damage;
-	double Rc  , Rc_prec ;	
-
   LI_index++;
-  u = u_min;
-	v = v_min;
-	t_0 = LI_index * delta_LI ; 
-
-	for (i=0 ; i < u_num_step ; i++){
-		for (j=0 ; j < v_num_step ; j++){
-
-
-			g_value = g(u + 0.5*subdomain_step_u ,v + 0.5*subdomain_step_v ,t_0 , scale_parameter , shape_parameter);
-			exponential_value = exp( -A*g_value);
-			pdf_u_value = pdf_u( u + 0.5*subdomain_step_u , pdf_u_mean , pdf_u_sigma);
-			pdf_v_value = pdf_v(  v + 0.5*subdomain_step_v ,  pdf_v_offset ,  pdf_v_mult ,  pdf_v_degrees);     
-			joint_pdf_value = pdf_u_value*pdf_v_value ;
-			integral_subdomain= exponential_value*joint_pdf_value*subdomain_area;
-			Rc = Rc + integral_subdomain;
-
-			if (LI_index > 1){
-				g_value_prec = g(u + 0.5*subdomain_step_u ,	v + 0.5*subdomain_step_v ,t_0 - delta_LI , scale_parameter , shape_parameter);
-				exponential_value_prec = exp( -A*g_value_prec);
-				integral_subdomain_prec = exponential_value_prec*joint_pdf_value*subdomain_area;
-				Rc_prec = Rc_prec + integral_subdomain_prec;
-			}
-			else{
-				Rc_prec = 1 ;
-			}
-      v = v + subdomain_step_v;
-    }//for (j=0 ; j<v_num_step ; j++)
-  v = v_min;
-	u = u + subdomain_step_u;
-	} //for (i=0 ; i < u_num_step ; i++)
-  damage = Rc_prec - Rc ;
+
+  double damage = ComputeDamage ();
   m_reliability = m_reliability - damage ; 
 
   // update last update time stamp
-  m_lastUpdateTime = Simulator::Now ();
-  m_reliabilityUpdateEvent = Simulator::Schedule (m_reliabilityUpdateInterval,&ReliabilityModel::UpdateReliability,this);
-
+  m_lastUpdateTime = now;
+}
 
+size_t
+ReliabilityTDDBModel::GetRcTableSize (void)
+{
+  return m_rcNodes;
 }
 
 void
 ReliabilityTDDBModel::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_lazy && m_temperatureModel)
+    {
+      m_temperatureModel->SetCheckpoint (Time (), MakeNullCallback<void> ());
+    }
   //m_source = NULL;
 }
 
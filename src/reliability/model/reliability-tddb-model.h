@@ -24,6 +24,9 @@
 #include "ns3/traced-value.h"
 #include "ns3/reliability-model.h"
 #include "ns3/temperature-model.h"
+#include <map>
+#include <utility>
+#include <vector>
 
 
 namespace ns3 {
@@ -52,6 +55,8 @@ public:
   virtual void SetB (double B);
   virtual double GetArea (void) const;
   virtual void SetArea (double area);
+  void SetLazy (bool lazy);
+  bool GetLazy (void) const;
 
   /**
    * \returns Current reliability
@@ -75,9 +80,73 @@ public:
    */
   virtual void UpdateReliability ();
 
+  /**
+   * \returns Nodes of the Rc tables shared by the models with a TemperatureQuantum.
+   */
+  static size_t GetRcTableSize (void);
+
 private:
   virtual void DoDispose (void);
 
+  /**
+   * Fills the constant part of the double integral: the subdomain midpoints and the
+   * pdf_u * pdf_v * subdomain_area weight of every subdomain, row major in u.
+   */
+  void BuildWeights (void);
+
+  /**
+   * \param t_0 Time at which the integral is evaluated.
+   * \param scale_p Scale parameter.
+   * \param shape_p Shape parameter.
+   * \returns Integral of exp (-A * g) weighted by the joint pdf.
+   *
+   * g is separable, exp (r + f) = exp (L * u) * exp (L * shape * v), so only
+   * u_num_step + v_num_step exponentials are needed for g; the inner loop over v
+   * runs on contiguous arrays and evaluates exp (-A * g) with an inline, branch
+   * free exponential, so that it vectorizes.
+   */
+  double Integrate (double t_0, double scale_p, double shape_p) const;
+
+  /**
+   * \param L log (t_0 / scale) * shape.
+   * \param shape_p Shape parameter.
+   * \param node Rc and its first and second derivatives in L.
+   *
+   * For a given shape, the integral depends on t_0 and the scale through L only.
+   */
+  void Tabulate (double L, double shape_p, double *node) const;
+
+  /**
+   * \param t_0 Time at which the integral is evaluated.
+   * \returns Integral at the current temperature bin, interpolated between the
+   * nodes of its Rc table around L, computing the missing ones.
+   */
+  double InterpolateRc (double t_0);
+
+  /**
+   * \param t_0 Time at which the integral is evaluated.
+   * \returns InterpolateRc with a TemperatureQuantum, Integrate otherwise.
+   */
+  double EvaluateRc (double t_0);
+
+  /**
+   * \returns Damage of the current step, scale_parameter and shape_parameter being set.
+   */
+  double ComputeDamage (void);
+
+  /**
+   * \param now Time of the update.
+   *
+   * One reliability step from the current average temperature.
+   */
+  void Step (Time now);
+
+  /**
+   * Lazy mode: the step the update event would have run at m_nextUpdate, called by
+   * the temperature model once the temperature is brought to that time.
+   */
+  void Checkpoint (void);
+
 private:
 
   double m_A;
@@ -123,6 +192,37 @@ private:
   double t_life;
   double Rd;
 
+  std::vector<double> m_uMid;       // midpoint of each u subdomain
+  std::vector<double> m_vMid;       // midpoint of each v subdomain
+  std::vector<double> m_weights;    // joint pdf * subdomain area, u_num_step x v_num_step
+
+  // Integral of the previous step, reused as the next step's "prec" integral
+  // while the temperature (hence scale and shape) does not change.
+  double m_lastRc;
+  double m_lastScale;
+  double m_lastShape;
+  int m_lastIndex;
+
+  // Rc at the nodes k * RC_GRID_STEP of L, from node first on; Rc, dRc/dL and
+  // d2Rc/dL2 per node, Rc < 0 for nodes not computed yet.
+  struct RcTable
+  {
+    long long first;
+    std::vector<double> nodes;
+  };
+
+  // Temperature quantization step of the Rc tables, 0 to disable them.
+  double m_temperatureQuantum;
+  // Quantized temperature of the current step, in quanta.
+  long long m_temperatureBin;
+  // Rc tables shared by every model, keyed on (quantum, quantized temperature).
+  // The step is not part of the key: a lone model reuses the nodes of its earlier
+  // updates, and several steps fall between two nodes as L grows with log (t_0).
+  // The tables do not depend on the simulation; they are all cleared when their
+  // nodes reach MAX_RC_NODES.
+  static std::map<std::pair<double, long long>, RcTable> m_rcTables;
+  static size_t m_rcNodes;
+
 
 
   Ptr<TemperatureModel> m_temperatureModel;
@@ -133,6 +233,8 @@ private:
   Time m_reliabilityUpdateInterval;
   // State variables.
   Time m_lastUpdateTime;          // time stamp of previous energy update
+  bool m_lazy;                    // update only when the reliability is read
+  Time m_nextUpdate;              // lazy mode: time of the next update
 
 };
 
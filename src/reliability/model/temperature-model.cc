@@ -67,10 +67,55 @@ TemperatureModel::UpdateTemperature (double cpupower)
   NS_LOG_FUNCTION (this);
 }
 
+void
+TemperatureModel::UpdateTemperature (double cpupower, uint64_t steps)
+{
+  NS_LOG_FUNCTION (this << cpupower << steps);
+  for (uint64_t i = 0; i < steps; i++)
+    {
+      UpdateTemperature (cpupower);
+    }
+}
+
+void
+TemperatureModel::Update (Time t)
+{
+  NS_LOG_FUNCTION (this << t);
+  while (!m_checkpoint.IsNull () && m_checkpointTime <= t)
+    {
+      if (!m_advance.IsNull ())
+        {
+          m_advance (m_checkpointTime);
+        }
+      Callback<void> checkpoint = m_checkpoint;
+      m_checkpoint = MakeNullCallback<void> ();
+      checkpoint ();
+    }
+  if (!m_advance.IsNull ())
+    {
+      m_advance (t);
+    }
+}
+
+void
+TemperatureModel::SetAdvanceCallback (Callback<void, Time> advance)
+{
+  m_advance = advance;
+}
+
+void
+TemperatureModel::SetCheckpoint (Time t, Callback<void> checkpoint)
+{
+  m_checkpointTime = t;
+  m_checkpoint = checkpoint;
+}
+
 void
 TemperatureModel::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_advance = MakeNullCallback<void, Time> ();
+  m_checkpoint = MakeNullCallback<void> ();
 }
 
 
@@ -22,6 +22,8 @@
 #include "ns3/ptr.h"
 #include "ns3/type-id.h"
 #include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
 
 namespace ns3 {
 
@@ -40,6 +42,39 @@ public:
    */
   virtual void UpdateTemperature (double cpupower);
 
+  /**
+   * \param cpupower CPU power during the steps.
+   * \param steps Number of steps.
+   *
+   * Same as calling UpdateTemperature (cpupower) steps times.
+   */
+  virtual void UpdateTemperature (double cpupower, uint64_t steps);
+
+  /**
+   * \param t Time to bring the temperature to.
+   *
+   * Lazy mode: applies the temperature steps of the power model that fall before t
+   * and runs the checkpoints due at or before t, in time order. Call it before reading
+   * the temperature; without a lazy power model or checkpoint it does nothing.
+   */
+  void Update (Time t);
+
+  /**
+   * \param advance Applies the power model steps that fall before a given time.
+   *
+   * Set by a lazy power model that no longer steps the temperature periodically.
+   */
+  void SetAdvanceCallback (Callback<void, Time> advance);
+
+  /**
+   * \param t Time of the checkpoint.
+   * \param checkpoint Called by Update once the temperature is brought to t.
+   *
+   * Set by a lazy model reading the temperature at fixed times (e.g. reliability).
+   * The checkpoint sets the next one; a null callback removes it.
+   */
+  void SetCheckpoint (Time t, Callback<void> checkpoint);
+
   /**
    * \returns Current temperature.
    */
@@ -56,7 +91,9 @@ public:
 private:
   virtual void DoDispose (void);
 
-
+  Callback<void, Time> m_advance;   // lazy power model steps
+  Callback<void> m_checkpoint;      // lazy reader of the temperature
+  Time m_checkpointTime;            // time of the pending checkpoint
 };
 
 } // namespace ns3
@@ -22,6 +22,8 @@
 #include "ns3/pointer.h"
 #include "ns3/traced-value.h"
 #include "temperature-simple-model.h"
+#include "device-coefficients.h"
+#include <cmath>
 
 
 NS_LOG_COMPONENT_DEFINE ("TemperatureSimpleModel");
@@ -188,40 +190,16 @@ void
 TemperatureSimpleModel::SetDeviceType(std::string devicetype)
 {
   m_deviceType = devicetype;
-  if(m_deviceType == "RaspberryPi")
-  {
-  m_A = 0.14434;
-  //m_A = 0.104;
-  m_B = 0.98885;
-  m_C = 0.04894698;
-  m_D = -3.14462264;
-  }
-  else if(m_deviceType == "RaspberryPi0")
-  {
-  m_A = 0.14434;
-  //m_A = 0.104;
-  m_B = 0.98885;
-  m_C = 0.04894698;
-  m_D = -3.14462264;
-  }
-  else if (m_deviceType == "Arduino")
-  {
-  m_A = 0.763094;
-  m_B = 0.010693;
-  m_C = -0.000679;
-  m_D = 9.795560;
-  }
-  else if (m_deviceType == "Server")
-  {
-  m_A = 0.763094;
-  m_B = 0.010693;
-  m_C = -0.000679;
-  m_D = 9.795560;
-  }
-  else
-  {
-    NS_FATAL_ERROR ("TemperatureSimpleModel:Undefined device type: " << m_deviceType);
-  }
+  uint32_t device = DeviceCoefficients::FindDevice (m_deviceType);
+  if (device == DeviceCoefficients::NONE)
+    {
+      NS_FATAL_ERROR ("TemperatureSimpleModel:Undefined device type: " << m_deviceType);
+    }
+  const DeviceCoefficients::Device &coefficients = DeviceCoefficients::GetDevice (device);
+  m_A = coefficients.thermalA;
+  m_B = coefficients.thermalB;
+  m_C = coefficients.thermalC;
+  m_D = coefficients.thermalD;
 }
 
 void
@@ -234,6 +212,45 @@ TemperatureSimpleModel::UpdateTemperature (double cpupower)
   m_avgTemp = (alpha * m_temperatureCPU) + (1.0 - alpha) * m_avgTemp;
 }
 
+void
+TemperatureSimpleModel::UpdateTemperature (double cpupower, uint64_t steps)
+{
+  NS_LOG_FUNCTION (this << cpupower << steps);
+  double alpha = 0.01;
+  double beta = 1.0 - alpha;
+  double T = m_temperatureCPU;
+  double avg = m_avgTemp;
+
+  if (m_B != 1.0 && m_B != beta)
+    {
+      // T_r = B^r (T - T*) + T*, avg_r = beta^r avg + alpha sum_k beta^(r-k) T_k
+      double Tstar = (m_A*m_Tenv + m_C*cpupower + m_D) / (1.0 - m_B);
+      double Br = pow (m_B, (double) steps);
+      double betar = pow (beta, (double) steps);
+      avg = betar * avg + alpha * (T - Tstar) * m_B * (betar - Br) / (beta - m_B) + Tstar * (1.0 - betar);
+      T = Br * (T - Tstar) + Tstar;
+    }
+  else
+    {
+      // No fixed point (B = 1) or a double root of the sum (B = beta): step,
+      // until the temperature and its average stop changing
+      for (uint64_t i = 0; i < steps; i++)
+        {
+          double next = m_A*m_Tenv + m_B*T + m_C*cpupower + m_D;
+          double nextAvg = (alpha * next) + beta * avg;
+          if (next == T && nextAvg == avg)
+            {
+              break;
+            }
+          T = next;
+          avg = nextAvg;
+        }
+    }
+
+  m_temperatureCPU = T;
+  m_avgTemp = avg;
+}
+
 void
 TemperatureSimpleModel::DoDispose (void)
 {
@@ -56,6 +56,16 @@ public:
    */
   virtual void UpdateTemperature (double cpupower);
 
+  /**
+   * \brief Applies steps updates at a constant CPU power.
+   *
+   * Uses the closed form of the recurrence, in constant time, which matches stepping
+   * one at a time up to rounding. When B is 1 or 1 - alpha the closed form does not
+   * hold, and the steps are applied one by one until the recurrence reaches its
+   * fixed point, after which further steps change nothing.
+   */
+  virtual void UpdateTemperature (double cpupower, uint64_t steps);
+
   /**
    * \returns Current state.
    */
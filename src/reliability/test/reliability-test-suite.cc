@@ -5,6 +5,16 @@
 
 // An essential include is test.h
 #include "ns3/test.h"
+#include "ns3/reliability-tddb-model.h"
+#include "ns3/temperature-simple-model.h"
+#include "ns3/performance-simple-model.h"
+#include "ns3/app-power-model.h"
+#include "ns3/device-coefficients.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include <cmath>
+#include <fstream>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
@@ -46,6 +56,283 @@ ReliabilityTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+// Temperature model returning a temperature set by the test
+class FixedTemperatureModel : public TemperatureModel
+{
+public:
+  FixedTemperatureModel () : m_temperature (0) {}
+  void SetTemperature (double temperature) { m_temperature = temperature; }
+  virtual double GetAvgTemperature (void) const { return m_temperature; }
+  virtual void SetDeviceType (std::string devicetype) {}
+  virtual void SetTenv (double Tenv) {}
+private:
+  double m_temperature;
+};
+
+// Checks the TDDB update against the direct evaluation of the double integral
+class ReliabilityTDDBTestCase : public TestCase
+{
+public:
+  ReliabilityTDDBTestCase ();
+
+private:
+  virtual void DoRun (void);
+  double Reference (Ptr<ReliabilityTDDBModel> model, double temperature, int index) const;
+};
+
+ReliabilityTDDBTestCase::ReliabilityTDDBTestCase ()
+  : TestCase ("TDDB reliability update matches the direct double integral")
+{
+}
+
+double
+ReliabilityTDDBTestCase::Reference (Ptr<ReliabilityTDDBModel> model, double temperature, int index) const
+{
+  double scale = 365*24*60*60*model->scale_par (temperature, 1.1, 3, 95, 0.01, 3);
+  double shape = model->shape_par (temperature, 1.1, 3, 0.01, 10, 7);
+  double delta = 30 * 24 * 60 * 60;
+  double Rc = 0, Rc_prec = 0;
+  for (int i = 0; i < 41; i++)
+    {
+      for (int j = 0; j < 41; j++)
+        {
+          double u = 0.6 + i * 0.0025 + 0.5 * 0.0025;
+          double v = j * 0.000010 + 0.5 * 0.000010;
+          double w = model->pdf_u (u, 0.65, 0.0087) * model->pdf_v (v, 1.8502e-005, 1.4500e-005, 8.77) * 0.000000025;
+          Rc += exp (-model->g (u, v, index * delta, scale, shape)) * w;
+          Rc_prec += exp (-model->g (u, v, (index - 1) * delta, scale, shape)) * w;
+        }
+    }
+  return (index > 1 ? Rc_prec : 1) - Rc;
+}
+
+void
+ReliabilityTDDBTestCase::DoRun (void)
+{
+  Ptr<FixedTemperatureModel> temperature = CreateObject<FixedTemperatureModel> ();
+  Ptr<ReliabilityTDDBModel> model = CreateObject<ReliabilityTDDBModel> ();
+  model->RegisterTemperatureModel (temperature);
+
+  // Same temperature (reuses the previous integral), then a change
+  double temperatures[] = {60, 60, 60, 85, 85, 40};
+  double expected = 1.0;
+  for (int k = 0; k < 6; k++)
+    {
+      temperature->SetTemperature (temperatures[k]);
+      model->UpdateReliability ();
+      expected -= Reference (model, temperatures[k], k + 1);
+      NS_TEST_ASSERT_MSG_EQ_TOL (model->GetReliability (), expected, 1e-9, "Reliability differs at step " << k + 1);
+    }
+
+  // A quantum of 1 leaves integer temperatures unchanged
+  Ptr<ReliabilityTDDBModel> quantized = CreateObject<ReliabilityTDDBModel> ();
+  quantized->SetAttribute ("TemperatureQuantum", DoubleValue (1.0));
+  quantized->RegisterTemperatureModel (temperature);
+  expected = 1.0;
+  for (int k = 0; k < 6; k++)
+    {
+      temperature->SetTemperature (temperatures[k]);
+      quantized->UpdateReliability ();
+      expected -= Reference (quantized, temperatures[k], k + 1);
+      NS_TEST_ASSERT_MSG_EQ_TOL (quantized->GetReliability (), expected, 1e-9, "Quantized reliability differs at step " << k + 1);
+    }
+
+  // A lone model interpolates between the nodes of its earlier updates
+  Ptr<ReliabilityTDDBModel> lone = CreateObject<ReliabilityTDDBModel> ();
+  lone->SetAttribute ("TemperatureQuantum", DoubleValue (0.5));
+  lone->RegisterTemperatureModel (temperature);
+  temperature->SetTemperature (70);
+  expected = 1.0;
+  size_t nodes = 0;
+  for (int k = 0; k < 200; k++)
+    {
+      if (k == 100)
+        {
+          nodes = ReliabilityTDDBModel::GetRcTableSize ();
+        }
+      lone->UpdateReliability ();
+      expected -= Reference (lone, 70, k + 1);
+      NS_TEST_ASSERT_MSG_EQ_TOL (lone->GetReliability (), expected, 1e-9, "Interpolated reliability differs at step " << k + 1);
+    }
+  NS_TEST_ASSERT_MSG_LT (ReliabilityTDDBModel::GetRcTableSize () - nodes, 30u,
+                         "Updates 100 to 200 should mostly reuse the nodes");
+
+  Simulator::Destroy ();
+}
+
+// Checks that the lazy stack ends in the same state as the periodic one
+class ReliabilityLazyTestCase : public TestCase
+{
+public:
+  ReliabilityLazyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ReliabilityLazyTestCase::ReliabilityLazyTestCase ()
+  : TestCase ("Lazy power, temperature and reliability updates match the periodic ones")
+{
+}
+
+void
+ReliabilityLazyTestCase::DoRun (void)
+{
+  Ptr<TemperatureSimpleModel> temperature[2];
+  Ptr<AppPowerModel> power[2];
+  Ptr<ReliabilityTDDBModel> reliability[2];
+  for (int k = 0; k < 2; k++)
+    {
+      Ptr<PerformanceSimpleModel> performance = CreateObject<PerformanceSimpleModel> ();
+      temperature[k] = CreateObject<TemperatureSimpleModel> ();
+      power[k] = CreateObjectWithAttributes<AppPowerModel> ("Lazy", BooleanValue (k == 1));
+      reliability[k] = CreateObjectWithAttributes<ReliabilityTDDBModel> ("Lazy", BooleanValue (k == 1));
+
+      temperature[k]->SetTenv (25.0);
+      reliability[k]->RegisterTemperatureModel (temperature[k]);
+      power[k]->RegisterPerformanceModel (performance);
+      power[k]->RegisterTemperatureModel (temperature[k]);
+      power[k]->SetDeviceType ("RaspberryPi");
+      temperature[k]->SetDeviceType ("RaspberryPi");
+      power[k]->SetApplication ("kNN", DoubleValue (100000));
+      performance->SetPacketSize (DoubleValue (1024));
+
+      // Off the 10 ms grid so no update shares its time with another event
+      Simulator::Schedule (Seconds (100.003), &AppPowerModel::RunApp, power[k]);
+      Simulator::Schedule (Seconds (250.004), &AppPowerModel::RunApp, power[k]);
+    }
+
+  Simulator::Stop (Seconds (400.0075));
+  Simulator::Run ();
+
+  double lazyReliability = reliability[1]->GetReliability ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (temperature[1]->GetTemperature (), temperature[0]->GetTemperature (), 1e-9,
+                             "Temperature differs");
+  NS_TEST_ASSERT_MSG_EQ_TOL (temperature[1]->GetAvgTemperature (), temperature[0]->GetAvgTemperature (), 1e-9,
+                             "Average temperature differs");
+  NS_TEST_ASSERT_MSG_EQ_TOL (lazyReliability, reliability[0]->GetReliability (), 1e-12,
+                             "Reliability differs");
+
+  Simulator::Destroy ();
+}
+
+// Checks the closed form of the stepped temperature update against single steps
+class TemperatureStepsTestCase : public TestCase
+{
+public:
+  TemperatureStepsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TemperatureStepsTestCase::TemperatureStepsTestCase ()
+  : TestCase ("Stepped temperature update matches single steps")
+{
+}
+
+void
+TemperatureStepsTestCase::DoRun (void)
+{
+  Ptr<TemperatureSimpleModel> stepped = CreateObject<TemperatureSimpleModel> ();
+  Ptr<TemperatureSimpleModel> single = CreateObject<TemperatureSimpleModel> ();
+  stepped->SetTenv (25.0);
+  single->SetTenv (25.0);
+  stepped->SetDeviceType ("RaspberryPi");
+  single->SetDeviceType ("RaspberryPi");
+
+  // Heat up, then cool down over more steps than reach the fixed point
+  uint64_t steps[] = { 1, 7, 300, 100000 };
+  double powers[] = { 4.0, 4.0, 2.0, 2.5 };
+  for (int k = 0; k < 4; k++)
+    {
+      stepped->UpdateTemperature (powers[k], steps[k]);
+      for (uint64_t i = 0; i < steps[k]; i++)
+        {
+          single->UpdateTemperature (powers[k]);
+        }
+      NS_TEST_ASSERT_MSG_EQ_TOL (stepped->GetTemperature (), single->GetTemperature (), 1e-9,
+                                 "Temperature differs after " << steps[k] << " steps");
+      NS_TEST_ASSERT_MSG_EQ_TOL (stepped->GetAvgTemperature (), single->GetAvgTemperature (), 1e-9,
+                                 "Average temperature differs after " << steps[k] << " steps");
+    }
+
+  Simulator::Destroy ();
+}
+
+// Checks the built-in coefficients and devices added from a file
+class DeviceCoefficientsTestCase : public TestCase
+{
+public:
+  DeviceCoefficientsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+DeviceCoefficientsTestCase::DeviceCoefficientsTestCase ()
+  : TestCase ("Coefficient registry lookups, file loading and batch evaluation")
+{
+}
+
+void
+DeviceCoefficientsTestCase::DoRun (void)
+{
+  uint32_t knn = DeviceCoefficients::FindApplication ("RaspberryPi", "kNN");
+  NS_TEST_ASSERT_MSG_NE (knn, DeviceCoefficients::NONE, "Built-in application missing");
+  NS_TEST_ASSERT_MSG_EQ_TOL (DeviceCoefficients::ExecTime (knn, 100000), 9.32e-3 * 100 + 4.52, 1e-12,
+                             "Execution time differs");
+  // RaspberryPi fits give the power directly
+  NS_TEST_ASSERT_MSG_EQ_TOL (DeviceCoefficients::Power (knn, 100000, 1.0), 3.30e-2 * 100 + 3.04e1, 1e-12,
+                             "Power differs");
+  NS_TEST_ASSERT_MSG_EQ (DeviceCoefficients::FindApplication ("Arduino", "kNN"), DeviceCoefficients::NONE,
+                         "Unexpected application");
+
+  std::string path = CreateTempDirFilename ("coefficients.csv");
+  {
+    std::ofstream file (path);
+    file << "# test device\n"
+         << "device, Jetson, 5.0, energy, 0.5, 0.9, 0.01, 1.0\n"
+         << "\n"
+         << "app, Jetson, kNN, 1e-6, 2e-3, 0.5, 1000, 0, 0.1, 20\n";
+  }
+  DeviceCoefficients::Load (path);
+
+  uint32_t jetson = DeviceCoefficients::FindApplication ("Jetson", "kNN");
+  NS_TEST_ASSERT_MSG_NE (jetson, DeviceCoefficients::NONE, "Loaded application missing");
+  NS_TEST_ASSERT_MSG_EQ_TOL (DeviceCoefficients::GetDevice (DeviceCoefficients::FindDevice ("Jetson")).idlePowerW,
+                             5.0, 1e-12, "Idle power differs");
+
+  // The models pick up the new device
+  Ptr<PerformanceSimpleModel> performance = CreateObject<PerformanceSimpleModel> ();
+  Ptr<TemperatureSimpleModel> temperature = CreateObject<TemperatureSimpleModel> ();
+  Ptr<AppPowerModel> power = CreateObject<AppPowerModel> ();
+  power->RegisterPerformanceModel (performance);
+  power->RegisterTemperatureModel (temperature);
+  power->SetDeviceType ("Jetson");
+  temperature->SetDeviceType ("Jetson");
+  power->SetApplication ("kNN", DoubleValue (2000));
+  double expected = 1e-6 * 4 + 2e-3 * 2 + 0.5;
+  NS_TEST_ASSERT_MSG_EQ_TOL (performance->GetExecTime (), expected, 1e-12, "Loaded execution time differs");
+  NS_TEST_ASSERT_MSG_EQ_TOL (power->GetIdlePowerW (), 5.0, 1e-12, "Loaded idle power differs");
+
+  // Energy fits are divided by the execution time
+  NS_TEST_ASSERT_MSG_EQ_TOL (DeviceCoefficients::Power (jetson, 2000, expected), (0.1 * 2 + 20) / expected, 1e-12,
+                             "Loaded power differs");
+
+  double sizes[] = { 10, 1000, 50000, 200000 };
+  double execTime[4];
+  double powers[4];
+  DeviceCoefficients::EvalBatch (knn, 4, sizes, execTime, powers);
+  for (int i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (execTime[i], DeviceCoefficients::ExecTime (knn, sizes[i]), "Batch execution time differs");
+      NS_TEST_ASSERT_MSG_EQ (powers[i], DeviceCoefficients::Power (knn, sizes[i], execTime[i]), "Batch power differs");
+    }
+
+  Simulator::Destroy ();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +348,10 @@ ReliabilityTestSuite::ReliabilityTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new ReliabilityTestCase1, TestCase::QUICK);
+  AddTestCase (new ReliabilityTDDBTestCase, TestCase::QUICK);
+  AddTestCase (new ReliabilityLazyTestCase, TestCase::QUICK);
+  AddTestCase (new TemperatureStepsTestCase, TestCase::QUICK);
+  AddTestCase (new DeviceCoefficientsTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,378 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "ns3/core-module.h"
+#include "ns3/scheduler-trace.h"
+
+using namespace ns3;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/// Counts the cache misses of the calling process, where the kernel allows it
+class CacheMissCounter
+{
+public:
+  CacheMissCounter ()
+    : m_fd (-1)
+  {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    std::memset (&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~CacheMissCounter ()
+  {
+    if (m_fd >= 0)
+      {
+        close (m_fd);
+      }
+  }
+
+  /**
+   * Get if the cache misses can be counted
+   * \return true if the counter is available
+   */
+  bool IsValid (void) const
+  {
+    return m_fd >= 0;
+  }
+
+  /// Reset and start counting
+  void Start (void)
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl (m_fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+
+  /**
+   * Stop counting
+   * \return the cache misses since Start
+   */
+  uint64_t Stop (void)
+  {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read (m_fd, &count, sizeof (count)) != sizeof (count))
+          {
+            count = 0;
+          }
+      }
+#endif
+    return count;
+  }
+
+private:
+  int m_fd; ///< perf event file descriptor, -1 if not available
+};
+
+/**
+ * Get the peak resident set size of the process
+ * \return the peak resident set size in kB
+ */
+long
+GetPeakRss (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * Replay the operations against a scheduler, a new one for each
+ * simulator instance of the trace
+ * \param records the operations
+ * \param factory the scheduler factory
+ * \param [out] mismatches the events the scheduler removed in another order than the recorded run
+ * \return the number of scheduler operations
+ */
+uint64_t
+Replay (const std::vector<SchedulerTrace::Record> &records, ObjectFactory &factory,
+        uint64_t &mismatches)
+{
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  uint64_t ops = 0;
+  mismatches = 0;
+  Scheduler::Event ev;
+  ev.impl = 0;
+  for (const SchedulerTrace::Record &record : records)
+    {
+      switch (record.op)
+        {
+        case SchedulerTrace::INSERT:
+          ev.key = record.key;
+          scheduler->Insert (ev);
+          ops++;
+          break;
+        case SchedulerTrace::REMOVE_NEXT:
+          if (scheduler->RemoveNext ().key.m_uid != record.key.m_uid)
+            {
+              mismatches++;
+            }
+          ops++;
+          break;
+        case SchedulerTrace::REMOVE:
+          ev.key = record.key;
+          scheduler->Remove (ev);
+          ops++;
+          break;
+        case SchedulerTrace::SEGMENT:
+          // The previous simulator instance was destroyed with these events
+          while (!scheduler->IsEmpty ())
+            {
+              scheduler->RemoveNext ();
+              ops++;
+            }
+          scheduler = factory.Create<Scheduler> ();
+          break;
+        default:
+          break;
+        }
+    }
+  while (!scheduler->IsEmpty ())
+    {
+      scheduler->RemoveNext ();
+      ops++;
+    }
+  return ops;
+}
+
+/**
+ * Replay the operations against a scheduler type in a child process, so
+ * that the peak memory and the cache state are its own, and print a row
+ * \param records the operations
+ * \param type the scheduler TypeId name
+ * \param runs the number of replays, the fastest one is reported
+ */
+void
+Bench (const std::vector<SchedulerTrace::Record> &records, const std::string &type, uint32_t runs)
+{
+  std::cout.flush ();
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      LOGME ("fork failed, skipping " << type);
+      return;
+    }
+  if (pid > 0)
+    {
+      int status;
+      waitpid (pid, &status, 0);
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          LOG (std::left << std::setw (g_fwidth + 16) << type << "failed");
+        }
+      return;
+    }
+
+  ObjectFactory factory (type);
+  CacheMissCounter counter;
+  long rss = GetPeakRss ();
+  double best = 0;
+  uint64_t ops = 0;
+  uint64_t misses = 0;
+  uint64_t mismatches = 0;
+  for (uint32_t run = 0; run < runs; run++)
+    {
+      auto start = std::chrono::steady_clock::now ();
+      counter.Start ();
+      ops = Replay (records, factory, mismatches);
+      uint64_t runMisses = counter.Stop ();
+      double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+      if (run == 0 || seconds < best)
+        {
+          best = seconds;
+          misses = runMisses;
+        }
+    }
+  rss = GetPeakRss () - rss;
+
+  std::ostringstream missesText;
+  std::ostringstream perOpText;
+  if (counter.IsValid ())
+    {
+      missesText << misses;
+      perOpText << (double) misses / ops;
+    }
+  else
+    {
+      missesText << "n/a";
+      perOpText << "n/a";
+    }
+  LOG (std::left << std::setw (g_fwidth + 16) << type <<
+       std::setw (g_fwidth) << best <<
+       std::setw (g_fwidth) << (ops / best) <<
+       std::setw (g_fwidth) << missesText.str () <<
+       std::setw (g_fwidth) << perOpText.str () <<
+       std::setw (g_fwidth) << rss <<
+       mismatches);
+  std::cout.flush ();
+  _exit (0);
+}
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "";
+  std::string schedulers = "map,heap,cal,list,pri,ladder";
+  uint32_t runs = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Replay a recorded event list trace against the schedulers.\n"
+             "\n"
+             "Record the trace from any simulation with\n"
+             "  --ns3::DefaultSimulatorImpl::TraceFile=<file>\n"
+             "(or Config::SetDefault before the first Simulator call),\n"
+             "then replay it here.  Each scheduler runs in its own\n"
+             "process and reports the replay time and rate, the cache\n"
+             "misses where perf events are available, the growth of\n"
+             "the peak resident set and whether it ran the events in\n"
+             "the recorded order.");
+  cmd.AddValue ("file", "trace recorded by DefaultSimulatorImpl", filename);
+  cmd.AddValue ("schedulers", "comma separated schedulers among map, heap, cal, list, pri, ladder "
+                "or TypeId names", schedulers);
+  cmd.AddValue ("runs", "replays per scheduler, the fastest is reported (default 1)", runs);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  if (filename.empty ())
+    {
+      LOGME ("no trace, pass --file=<file>");
+      return 1;
+    }
+  SchedulerTraceReader reader;
+  if (!reader.Open (filename))
+    {
+      LOGME ("cannot read the trace " << filename);
+      return 1;
+    }
+
+  std::vector<SchedulerTrace::Record> records;
+  SchedulerTrace::Record record;
+  uint64_t size = 0;
+  uint64_t peak = 0;
+  uint32_t segments = 1;
+  while (reader.Read (record))
+    {
+      records.push_back (record);
+      switch (record.op)
+        {
+        case SchedulerTrace::INSERT:
+          peak = std::max (peak, ++size);
+          break;
+        case SchedulerTrace::REMOVE_NEXT:
+        case SchedulerTrace::REMOVE:
+          size--;
+          break;
+        case SchedulerTrace::SEGMENT:
+          size = 0;
+          segments++;
+          break;
+        default:
+          break;
+        }
+    }
+  LOGME ("trace: " << filename);
+  LOGME ("operations: " << records.size () << " in " << segments << " simulator instance(s)");
+  LOGME ("peak events: " << peak);
+  LOGME ("runs: " << runs);
+
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth + 16) << "Scheduler" <<
+       std::setw (g_fwidth) << "Time (s)" <<
+       std::setw (g_fwidth) << "Rate (op/s)" <<
+       std::setw (g_fwidth) << "Cache misses" <<
+       std::setw (g_fwidth) << "Misses/op" <<
+       std::setw (g_fwidth) << "Peak RSS (kB)" <<
+       "Out of order");
+
+  std::istringstream names (schedulers);
+  for (std::string name; std::getline (names, name, ',');)
+    {
+      std::string type = name;
+      if (name == "map")
+        {
+          type = "ns3::MapScheduler";
+        }
+      else if (name == "heap")
+        {
+          type = "ns3::HeapScheduler";
+        }
+      else if (name == "cal")
+        {
+          type = "ns3::CalendarScheduler";
+        }
+      else if (name == "list")
+        {
+          type = "ns3::ListScheduler";
+        }
+      else if (name == "pri")
+        {
+          type = "ns3::PriorityQueueScheduler";
+        }
+      else if (name == "ladder")
+        {
+          type = "ns3::LadderScheduler";
+        }
+      TypeId tid;
+      if (!TypeId::LookupByNameFailSafe (type, &tid))
+        {
+          LOGME ("unknown scheduler " << name);
+          continue;
+        }
+      Bench (records, type, runs);
+    }
+  LOG ("");
+  return 0;
+}
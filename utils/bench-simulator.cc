@@ -23,6 +23,7 @@
 #include <fstream>
 #include <vector>
 #include <string.h>
+#include <thread>
 
 #include "ns3/core-module.h"
 
@@ -51,10 +52,20 @@ public:
   Bench (const uint32_t population, const uint32_t total)
     : m_population (population),
       m_total (total),
-      m_count (0)
+      m_count (0),
+      m_args (0)
   {
   }
 
+  /**
+   * Set the number of arguments bound to each event
+   * \param args the number of arguments, 0 to 3
+   */
+  void SetArgs (const uint32_t args)
+  {
+    m_args = args;
+  }
+
   /**
    * Set random stream
    * \param stream the random variable stream
@@ -84,14 +95,55 @@ public:
 
   /// Run function
   void RunBench (void);
+  /**
+   * Run the injection benchmark: the events come from producer threads
+   * through Simulator::ScheduleWithContext while the main thread runs them
+   * \param producers the number of producer threads
+   */
+  void RunInject (uint32_t producers);
 private:
+  /**
+   * Producer thread of RunInject
+   * \param bench the bench
+   * \param context the context of the events
+   * \param n the number of events to schedule
+   */
+  static void Produce (Bench *bench, uint32_t context, uint32_t n);
+  /// Keep the simulation running until all the injected events ran
+  void KeepAlive (void);
+  /// callback function of the injected events
+  void Injected (void);
+  /**
+   * Schedule the next event, binding m_args arguments
+   * \param after the delay of the event
+   */
+  void Schedule (Time after);
   /// callback function
   void Cb (void);
+  /**
+   * callback function with one bound argument
+   * \param a unused
+   */
+  void Cb1 (uint32_t a);
+  /**
+   * callback function with two bound arguments
+   * \param a unused
+   * \param b unused
+   */
+  void Cb2 (uint32_t a, double b);
+  /**
+   * callback function with three bound arguments
+   * \param a unused
+   * \param b unused
+   * \param c unused
+   */
+  void Cb3 (uint32_t a, double b, Time c);
 
   Ptr<RandomVariableStream> m_rand; ///< random variable
   uint32_t m_population; ///< population
   uint32_t m_total; ///< total
   uint32_t m_count; ///< count
+  uint32_t m_args; ///< arguments bound to each event
 };
 
 void
@@ -108,7 +160,7 @@ Bench::RunBench (void)
   for (uint32_t i = 0; i < m_population; ++i)
     {
       Time at = NanoSeconds (m_rand->GetValue ());
-      Simulator::Schedule (at, &Bench::Cb, this);
+      Schedule (at);
     }
   init = time.End ();
   init /= 1000;
@@ -130,6 +182,81 @@ Bench::RunBench (void)
 
 }
 
+void
+Bench::RunInject (uint32_t producers)
+{
+  SystemWallClockMs time;
+  double simu;
+
+  DEB ("injecting from " << producers << " threads");
+  m_count = 0;
+
+  time.Start ();
+  Simulator::Schedule (NanoSeconds (1), &Bench::KeepAlive, this);
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < producers; ++i)
+    {
+      uint32_t n = m_total / producers + (i < m_total % producers ? 1 : 0);
+      threads.push_back (std::thread (&Bench::Produce, this, i, n));
+    }
+  Simulator::Run ();
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+  simu = time.End ();
+  simu /= 1000;
+  DEB ("run took " << simu << "s");
+
+  LOG (std::setw (g_fwidth) << simu <<
+       std::setw (g_fwidth) << (m_count / simu) <<
+       std::setw (g_fwidth) << (simu / m_count));
+}
+
+void
+Bench::Produce (Bench *bench, uint32_t context, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Simulator::ScheduleWithContext (context, NanoSeconds (i % 100), &Bench::Injected, bench);
+    }
+}
+
+void
+Bench::KeepAlive (void)
+{
+  if (m_count < m_total)
+    {
+      Simulator::Schedule (NanoSeconds (1), &Bench::KeepAlive, this);
+    }
+}
+
+void
+Bench::Injected (void)
+{
+  ++m_count;
+}
+
+void
+Bench::Schedule (Time after)
+{
+  switch (m_args)
+    {
+    case 0:
+      Simulator::Schedule (after, &Bench::Cb, this);
+      break;
+    case 1:
+      Simulator::Schedule (after, &Bench::Cb1, this, m_count);
+      break;
+    case 2:
+      Simulator::Schedule (after, &Bench::Cb2, this, m_count, 1.0);
+      break;
+    default:
+      Simulator::Schedule (after, &Bench::Cb3, this, m_count, 1.0, after);
+      break;
+    }
+}
+
 void
 Bench::Cb (void)
 {
@@ -140,10 +267,28 @@ Bench::Cb (void)
   DEB ("event at " << Simulator::Now ().GetSeconds () << "s");
 
   Time after = NanoSeconds (m_rand->GetValue ());
-  Simulator::Schedule (after, &Bench::Cb, this);
+  Schedule (after);
   ++m_count;
 }
 
+void
+Bench::Cb1 (uint32_t a)
+{
+  Cb ();
+}
+
+void
+Bench::Cb2 (uint32_t a, double b)
+{
+  Cb ();
+}
+
+void
+Bench::Cb3 (uint32_t a, double b, Time c)
+{
+  Cb ();
+}
+
 
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
@@ -205,6 +350,7 @@ int main (int argc, char *argv[])
 
   bool schedCal           = false;
   bool schedHeap          = false;
+  bool schedLadder        = false;
   bool schedList          = false;
   bool schedMap           = true;
   bool schedPriorityQueue = false;
@@ -214,6 +360,8 @@ int main (int argc, char *argv[])
   uint32_t runs  =       1;
   std::string filename = "";
   bool calRev = false;
+  uint32_t args = 0;
+  uint32_t producers = 0;
 
   CommandLine cmd (__FILE__);
   cmd.Usage ("Benchmark the simulator scheduler.\n"
@@ -223,10 +371,19 @@ int main (int argc, char *argv[])
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
+             "to be ascii, giving the relative event times in ns.\n"
+             "\n"
+             "With --args the events bind up to three arguments, which\n"
+             "grows the events MakeEvent allocates.\n"
+             "\n"
+             "With --producers the total events are scheduled with\n"
+             "Simulator::ScheduleWithContext from that many threads\n"
+             "while the main thread runs them, which measures the\n"
+             "cross-thread injection instead of the scheduler.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("calrev", "reverse ordering in the CalendarScheduler", calRev);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("pri",   "use PriorityQueue",             schedPriorityQueue);
@@ -236,6 +393,8 @@ int main (int argc, char *argv[])
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
+  cmd.AddValue ("args",  "arguments bound to each event, 0 to 3 (default 0)", args);
+  cmd.AddValue ("producers", "inject the events from this many threads (default 0: none)", producers);
   cmd.Parse (argc, argv);
   g_me = cmd.GetName () + ": ";
   g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
@@ -254,6 +413,10 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::ListScheduler");
     }
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+    }
   if (schedPriorityQueue)
     {
       factory.SetTypeId ("ns3::PriorityQueueScheduler");
@@ -273,9 +436,32 @@ int main (int argc, char *argv[])
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
+  LOGME ("bound arguments: " << args);
 
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetArgs (args);
+
+  if (producers > 0)
+    {
+      LOGME ("producer threads: " << producers);
+      LOG ("");
+      LOG (std::left << std::setw (g_fwidth) << "Run #" <<
+           std::left << std::setw (3 * g_fwidth) << "Injection:");
+      LOG (std::left << std::setw (g_fwidth) << "" <<
+           std::left << std::setw (g_fwidth) << "Time (s)" <<
+           std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
+           std::left << std::setw (g_fwidth) << "Per (s/ev)");
+      for (uint32_t i = 0; i < runs; i++)
+        {
+          std::cout << std::setw (g_fwidth) << i;
+          bench->RunInject (producers);
+        }
+      LOG ("");
+      Simulator::Destroy ();
+      delete bench;
+      return 0;
+    }
 
   // table header
   LOG ("");